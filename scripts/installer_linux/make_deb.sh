@@ -74,6 +74,14 @@ gzip -9 -n ${PACKAGE_NAME}/usr/share/${SURGE_NAME}/doc/changelog.Debian
 
 cp ${SOURCEDIR}/LICENSE ${PACKAGE_NAME}/usr/share/${SURGE_NAME}/doc/copyright
 cp -r ${SOURCEDIR}/resources/data/* ${PACKAGE_NAME}/usr/share/${SURGE_NAME}/
+# when surge-factory-data-bundle was built, ship the bundle in place of the files it packs
+if [[ -f "${INDIR}/../factory-data.sfdb" ]]; then
+    for d in patches_factory patches_3rdparty wavetables wavetables_3rdparty; do
+        find "${PACKAGE_NAME}/usr/share/${SURGE_NAME}/$d" -type f \( -iname '*.fxp' -o -iname '*.wt' -o -iname '*.wav' \) -delete
+        find "${PACKAGE_NAME}/usr/share/${SURGE_NAME}/$d" -type d -empty -delete
+    done
+    cp "${INDIR}/../factory-data.sfdb" ${PACKAGE_NAME}/usr/share/${SURGE_NAME}/
+fi
 cp -r ${SOURCEDIR}/scripts/installer_linux/assets/* ${PACKAGE_NAME}/usr/share
 
 # Copy the VST3 bundle
@@ -78,6 +78,19 @@ ${PACKAGE_NAME} (${VERSION}) stable; urgency=medium
 EOT
 
 
+# when surge-factory-data-bundle was built, ship the bundle in place of the files it packs
+DATA_DIR=${SOURCEDIR}/resources/data
+if [[ -f "${INDIR}/../factory-data.sfdb" ]]; then
+    DATA_DIR=$(pwd)/data
+    rm -rf "${DATA_DIR}"
+    cp -r ${SOURCEDIR}/resources/data "${DATA_DIR}"
+    for d in patches_factory patches_3rdparty wavetables wavetables_3rdparty; do
+        find "${DATA_DIR}/$d" -type f \( -iname '*.fxp' -o -iname '*.wt' -o -iname '*.wav' \) -delete
+        find "${DATA_DIR}/$d" -type d -empty -delete
+    done
+    cp "${INDIR}/../factory-data.sfdb" "${DATA_DIR}"
+fi
+
 # build rpm spec file
 RPM_SPEC_FILE=${PACKAGE_NAME}.spec
 
@@ -112,7 +125,7 @@ install -m 0755 -d %{buildroot}%{_datarootdir}/surge-xt/doc
 install -m 0644 ${SOURCEDIR}/LICENSE %{buildroot}%{_datarootdir}/surge-xt/doc/copyright
 install -m 0644 $(pwd)/changelog.txt %{buildroot}%{_datarootdir}/surge-xt/doc/changelog.txt
 
-cp -r ${SOURCEDIR}/resources/data/* %{buildroot}%{_datarootdir}/surge-xt/
+cp -r ${DATA_DIR}/* %{buildroot}%{_datarootdir}/surge-xt/
 cp -r "${INDIR}/Surge XT.vst3" %{buildroot}%{_libdir}/vst3/
 cp -r "${INDIR}/Surge XT Effects.vst3" %{buildroot}%{_libdir}/vst3/
 cp -r "${INDIR}/Surge XT.clap" %{buildroot}%{_libdir}/clap/
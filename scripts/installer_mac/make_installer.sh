@@ -129,6 +129,17 @@ fi
 
 # Build the resources pagkage
 RSRCS=${SOURCEDIR}/resources/data
+# when surge-factory-data-bundle was built, ship the bundle in place of the files it packs
+if [[ -f "${INDIR}/../factory-data.sfdb" ]]; then
+    mkdir -p "${TMPDIR}/Resources"
+    cp -r "${RSRCS}/" "${TMPDIR}/Resources"
+    for d in patches_factory patches_3rdparty wavetables wavetables_3rdparty; do
+        find "${TMPDIR}/Resources/$d" -type f \( -iname '*.fxp' -o -iname '*.wt' -o -iname '*.wav' \) -delete
+        find "${TMPDIR}/Resources/$d" -type d -empty -delete
+    done
+    cp "${INDIR}/../factory-data.sfdb" "${TMPDIR}/Resources"
+    RSRCS="${TMPDIR}/Resources"
+fi
 echo --- BUILDING Resources pkg ---
 if [[ ! -z $MAC_INSTALLING_CERT ]]; then
   pkgbuild --sign "$MAC_INSTALLING_CERT" --root "$RSRCS" --identifier "org.surge-synth-team.surge-xt.resources.pkg" --version $VERSION --scripts ${SOURCEDIR}/scripts/installer_mac/ResourcesPackageScript --install-location "/tmp/SXT/Surge XT" ${TMPDIR}/Surge_XT_Resources.pkg
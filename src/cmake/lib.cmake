@@ -1,6 +1,9 @@
 # vi:set sw=2 et:
 set(SURGE_PRODUCT_DIR ${CMAKE_BINARY_DIR}/surge_xt_products)
 file(MAKE_DIRECTORY ${SURGE_PRODUCT_DIR})
+set(SURGE_FACTORY_DATA_BUNDLE ${CMAKE_BINARY_DIR}/factory-data.sfdb)
+# keep in step with FactoryDataBundle::packedSubdirs()
+set(SURGE_FACTORY_DATA_BUNDLE_SUBDIRS patches_factory patches_3rdparty wavetables wavetables_3rdparty)
 
 add_custom_target(surge-xt-distribution)
 add_custom_target(surge-staged-assets)
@@ -58,7 +61,19 @@ function(surge_juce_package target product_name)
     if(TARGET ${target}_CLAP)
       install(PROGRAMS "${output_dir}/CLAP/${product_name}.clap" DESTINATION ${CMAKE_INSTALL_LIBDIR}/clap)
     endif()
-    install(DIRECTORY "${CMAKE_SOURCE_DIR}/resources/data/" DESTINATION share/surge-xt)
+    # The patches and wavetables go in as the factory data bundle if surge-factory-data-bundle
+    # has been built, and as the loose folders otherwise; see src/surge-factory-bundler
+    string(JOIN "|" packed_dirs ${SURGE_FACTORY_DATA_BUNDLE_SUBDIRS})
+    install(DIRECTORY "${CMAKE_SOURCE_DIR}/resources/data/" DESTINATION share/surge-xt
+      REGEX "/(${packed_dirs})/.*\\.([fF][xX][pP]|[wW][tT]|[wW][aA][vV])$" EXCLUDE)
+    list(TRANSFORM SURGE_FACTORY_DATA_BUNDLE_SUBDIRS PREPEND "${CMAKE_SOURCE_DIR}/resources/data/"
+      OUTPUT_VARIABLE packed_paths)
+    install(CODE "
+      if(EXISTS \"${SURGE_FACTORY_DATA_BUNDLE}\")
+        file(INSTALL \"${SURGE_FACTORY_DATA_BUNDLE}\" DESTINATION \"\${CMAKE_INSTALL_PREFIX}/share/surge-xt\")
+      else()
+        file(INSTALL ${packed_paths} DESTINATION \"\${CMAKE_INSTALL_PREFIX}/share/surge-xt\")
+      endif()")
   endif()
 endfunction()
 
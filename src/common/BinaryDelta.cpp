@@ -0,0 +1,208 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "BinaryDelta.h"
+
+#include <cstring>
+#include <unordered_map>
+
+namespace Surge
+{
+namespace Storage
+{
+namespace BinaryDelta
+{
+// Matches shorter than this cost more as ops than as inserted bytes
+static constexpr size_t blockSize = 16;
+
+static void putU32(std::vector<char> &d, uint32_t v)
+{
+    for (int b = 0; b < 4; ++b)
+        d.push_back((char)((v >> (8 * b)) & 0xFF));
+}
+
+static bool getU32(const std::vector<char> &d, size_t &pos, uint32_t &v)
+{
+    if (pos + 4 > d.size())
+        return false;
+
+    v = 0;
+    for (int b = 0; b < 4; ++b)
+        v |= (uint32_t)(uint8_t)d[pos + b] << (8 * b);
+    pos += 4;
+
+    return true;
+}
+
+static uint64_t hashBlock(const char *d)
+{
+    // FNV-1a, which is plenty for finding candidates we then compare anyway
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < blockSize; ++i)
+    {
+        h ^= (uint8_t)d[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+std::vector<char> diff(const char *base, size_t baseSize, const char *target, size_t targetSize)
+{
+    std::vector<char> res;
+
+    /*
+     * Where each aligned block of the base first appears. Building this is most of the cost
+     * for a large chunk, and is only needed once the target stops lining up with the base,
+     * so wait until then.
+     */
+    std::unordered_map<uint64_t, size_t> blocks;
+    bool blocksBuilt = false;
+
+    size_t literalStart = 0;
+    auto flushLiteral = [&](size_t to) {
+        if (to > literalStart)
+        {
+            res.push_back('i');
+            putU32(res, to - literalStart);
+            res.insert(res.end(), target + literalStart, target + to);
+        }
+    };
+
+    auto matchLength = [&](size_t t, size_t b) {
+        size_t n = 0;
+        while (t + n < targetSize && b + n < baseSize && target[t + n] == base[b + n])
+            n++;
+        return n;
+    };
+
+    // The offset from target to base of the last match. Edits mostly leave the rest of the
+    // chunk where it was, or shifted by the size of the edit, so try that before hashing.
+    ptrdiff_t shift = 0;
+    size_t t = 0;
+
+    while (t < targetSize)
+    {
+        size_t b = 0, n = 0;
+        ptrdiff_t candidate = (ptrdiff_t)t + shift;
+
+        if (candidate >= 0 && (size_t)candidate < baseSize)
+        {
+            b = candidate;
+            n = matchLength(t, b);
+        }
+
+        if (n < blockSize && t + blockSize <= targetSize)
+        {
+            if (!blocksBuilt)
+            {
+                blocks.reserve(baseSize / blockSize + 1);
+                for (size_t o = 0; o + blockSize <= baseSize; o += blockSize)
+                    blocks.emplace(hashBlock(base + o), o);
+                blocksBuilt = true;
+            }
+
+            auto f = blocks.find(hashBlock(target + t));
+            if (f != blocks.end())
+            {
+                auto fn = matchLength(t, f->second);
+                if (fn > n)
+                {
+                    b = f->second;
+                    n = fn;
+                }
+            }
+        }
+
+        if (n < blockSize)
+        {
+            t++;
+            continue;
+        }
+
+        // the match may also run backwards into what we were about to insert
+        while (t > literalStart && b > 0 && target[t - 1] == base[b - 1])
+        {
+            t--;
+            b--;
+            n++;
+        }
+
+        flushLiteral(t);
+        res.push_back('c');
+        putU32(res, b);
+        putU32(res, n);
+
+        shift = (ptrdiff_t)b - (ptrdiff_t)t;
+        t += n;
+        literalStart = t;
+    }
+
+    flushLiteral(targetSize);
+    return res;
+}
+
+bool apply(const char *base, size_t baseSize, const std::vector<char> &delta,
+           std::vector<char> &out)
+{
+    out.clear();
+    size_t pos = 0;
+    bool ok = true;
+
+    while (ok && pos < delta.size())
+    {
+        auto op = delta[pos++];
+        uint32_t a, n;
+
+        if (op == 'c')
+        {
+            ok = getU32(delta, pos, a) && getU32(delta, pos, n) && (size_t)a + n <= baseSize;
+
+            if (ok)
+                out.insert(out.end(), base + a, base + a + n);
+        }
+        else if (op == 'i')
+        {
+            ok = getU32(delta, pos, n) && pos + n <= delta.size();
+
+            if (ok)
+            {
+                out.insert(out.end(), delta.begin() + pos, delta.begin() + pos + n);
+                pos += n;
+            }
+        }
+        else
+        {
+            ok = false;
+        }
+    }
+
+    if (!ok)
+    {
+        out.clear();
+        return false;
+    }
+
+    return true;
+}
+} // namespace BinaryDelta
+} // namespace Storage
+} // namespace Surge
@@ -0,0 +1,55 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_BINARYDELTA_H
+#define SURGE_SRC_COMMON_BINARYDELTA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Surge
+{
+namespace Storage
+{
+/*
+ * A small copy/insert delta between two blobs, for keeping many versions of a patch chunk
+ * around at the cost of one full copy plus their differences (see the undo manager).
+ *
+ * A delta is a list of ops, all little endian: 'c' u32 offset u32 length copies that range
+ * of the base, 'i' u32 length and the bytes inserts them. It is tuned for the case where
+ * the target is the base with a few regions changed, resized or moved, which is what two
+ * saves of the same patch look like. It is always correct; it just gets larger the less the
+ * two have in common.
+ */
+namespace BinaryDelta
+{
+std::vector<char> diff(const char *base, size_t baseSize, const char *target, size_t targetSize);
+
+// Returns false, leaving out empty, if the delta is malformed or doesn't fit base
+bool apply(const char *base, size_t baseSize, const std::vector<char> &delta,
+           std::vector<char> &out);
+} // namespace BinaryDelta
+} // namespace Storage
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_BINARYDELTA_H
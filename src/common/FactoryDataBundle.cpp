@@ -0,0 +1,310 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "FactoryDataBundle.h"
+#include "version.h"
+
+#if WINDOWS
+#include "windows.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+namespace Surge
+{
+namespace Storage
+{
+static constexpr size_t headerSize = 16;
+static constexpr size_t dataAlignment = 16;
+
+static uint32_t readLE32(const char *p)
+{
+    auto u = reinterpret_cast<const uint8_t *>(p);
+    return (uint32_t)u[0] | ((uint32_t)u[1] << 8) | ((uint32_t)u[2] << 16) |
+           ((uint32_t)u[3] << 24);
+}
+
+static uint64_t readLE64(const char *p) { return readLE32(p) | ((uint64_t)readLE32(p + 4) << 32); }
+
+static void writeLE32(std::ostream &os, uint32_t v)
+{
+    char b[4];
+    for (int i = 0; i < 4; ++i)
+        b[i] = (char)((v >> (8 * i)) & 0xFF);
+    os.write(b, 4);
+}
+
+static void writeLE64(std::ostream &os, uint64_t v)
+{
+    writeLE32(os, (uint32_t)(v & 0xFFFFFFFF));
+    writeLE32(os, (uint32_t)(v >> 32));
+}
+
+FactoryDataBundle::~FactoryDataBundle()
+{
+#if WINDOWS
+    if (base)
+        UnmapViewOfFile(base);
+    if (mappingHandle)
+        CloseHandle(mappingHandle);
+    if (fileHandle && fileHandle != INVALID_HANDLE_VALUE)
+        CloseHandle(fileHandle);
+#else
+    if (base)
+        munmap(const_cast<char *>(base), mappedSize);
+#endif
+}
+
+std::string FactoryDataBundle::stamp() { return Surge::Build::FullVersionStr; }
+
+const std::vector<std::string> &FactoryDataBundle::packedSubdirs()
+{
+    static const std::vector<std::string> res{"patches_factory", "patches_3rdparty",
+                                              "wavetables", "wavetables_3rdparty"};
+    return res;
+}
+
+std::shared_ptr<FactoryDataBundle> FactoryDataBundle::open(const fs::path &path)
+{
+    static std::mutex openMutex;
+    static std::map<std::string, std::weak_ptr<FactoryDataBundle>> openBundles;
+
+    std::error_code ec;
+    if (!fs::exists(path, ec))
+        return nullptr;
+
+    auto key = path.generic_string();
+    std::lock_guard<std::mutex> g(openMutex);
+
+    if (auto res = openBundles[key].lock())
+        return res;
+
+    std::shared_ptr<FactoryDataBundle> res(new FactoryDataBundle());
+    if (!res->map(path))
+        return nullptr;
+    res->fileTime = fs::last_write_time(path, ec);
+
+    openBundles[key] = res;
+    return res;
+}
+
+bool FactoryDataBundle::map(const fs::path &path)
+{
+#if WINDOWS
+    fileHandle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fsz;
+    if (!GetFileSizeEx(fileHandle, &fsz) || fsz.QuadPart < (LONGLONG)headerSize)
+        return false;
+    mappedSize = (size_t)fsz.QuadPart;
+
+    mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mappingHandle)
+        return false;
+
+    base = (const char *)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (!base)
+        return false;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)headerSize)
+    {
+        ::close(fd);
+        return false;
+    }
+    mappedSize = (size_t)st.st_size;
+
+    // the mapping holds its own reference to the file, so we can let go of the descriptor
+    auto m = mmap(nullptr, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (m == MAP_FAILED)
+        return false;
+    base = (const char *)m;
+#endif
+
+    if (memcmp(base, "sfdb", 4) != 0 || readLE32(base + 4) != version)
+        return false;
+
+    auto count = readLE32(base + 8);
+    auto stampLength = readLE32(base + 12);
+    size_t pos = headerSize;
+
+    if (pos + stampLength > mappedSize || std::string(base + pos, stampLength) != stamp())
+        return false;
+    pos += stampLength;
+
+    entries.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (pos + 20 > mappedSize)
+            return false;
+
+        Entry e{readLE64(base + pos), readLE64(base + pos + 8)};
+        auto len = readLE32(base + pos + 16);
+        pos += 20;
+
+        if (pos + len > mappedSize || e.offset > mappedSize || e.size > mappedSize - e.offset)
+            return false;
+
+        entries.emplace(std::string(base + pos, len), e);
+        pos += len;
+    }
+
+    return true;
+}
+
+bool FactoryDataBundle::find(const std::string &relativePath, const char *&data,
+                             size_t &size) const
+{
+    auto it = entries.find(relativePath);
+    if (it == entries.end())
+        return false;
+
+    data = base + it->second.offset;
+    size = (size_t)it->second.size;
+    return true;
+}
+
+std::vector<std::string> FactoryDataBundle::filesUnder(const std::string &dir) const
+{
+    auto prefix = dir + "/";
+    std::vector<std::string> res;
+
+    for (const auto &[p, e] : entries)
+    {
+        if (p.compare(0, prefix.size(), prefix) == 0)
+            res.push_back(p);
+    }
+
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
+bool FactoryDataBundle::write(const fs::path &root, const std::vector<std::string> &subdirs,
+                              const fs::path &out, std::ostream &log)
+{
+    std::vector<std::pair<std::string, fs::path>> files;
+
+    for (const auto &sd : subdirs)
+    {
+        std::error_code ec;
+        auto top = root / sd;
+
+        if (!fs::is_directory(top, ec))
+        {
+            log << "Skipping missing directory " << top.generic_string() << std::endl;
+            continue;
+        }
+
+        for (auto &d : fs::recursive_directory_iterator(top, ec))
+        {
+            if (!d.is_regular_file())
+                continue;
+
+            auto ext = d.path().extension().generic_string();
+            std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+            if (ext == ".wt" || ext == ".wav" || ext == ".fxp")
+                files.emplace_back(d.path().lexically_relative(root).generic_string(), d.path());
+        }
+    }
+
+    std::sort(files.begin(), files.end());
+
+    auto st = stamp();
+    uint64_t indexSize = 0;
+    for (const auto &f : files)
+        indexSize += 20 + f.first.size();
+
+    std::vector<uint64_t> offsets, sizes;
+    uint64_t pos = headerSize + st.size() + indexSize;
+
+    for (const auto &f : files)
+    {
+        pos = (pos + dataAlignment - 1) & ~(uint64_t)(dataAlignment - 1);
+        offsets.push_back(pos);
+        sizes.push_back((uint64_t)fs::file_size(f.second));
+        pos += sizes.back();
+    }
+
+    std::ofstream os(out, std::ios::binary | std::ios::out | std::ios::trunc);
+    if (!os)
+    {
+        log << "Unable to open " << out.generic_string() << " for writing" << std::endl;
+        return false;
+    }
+
+    os.write("sfdb", 4);
+    writeLE32(os, version);
+    writeLE32(os, (uint32_t)files.size());
+    writeLE32(os, (uint32_t)st.size());
+    os.write(st.data(), st.size());
+
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        writeLE64(os, offsets[i]);
+        writeLE64(os, sizes[i]);
+        writeLE32(os, (uint32_t)files[i].first.size());
+        os.write(files[i].first.data(), files[i].first.size());
+    }
+
+    std::vector<char> buffer;
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        while ((uint64_t)os.tellp() < offsets[i])
+            os.put(0);
+
+        buffer.resize(sizes[i]);
+        std::ifstream is(files[i].second, std::ios::binary | std::ios::in);
+        if (!is.read(buffer.data(), buffer.size()))
+        {
+            log << "Unable to read " << files[i].second.generic_string() << std::endl;
+            return false;
+        }
+        os.write(buffer.data(), buffer.size());
+    }
+
+    log << "Packed " << files.size() << " files (" << pos << " bytes) into "
+        << out.generic_string() << std::endl;
+
+    return (bool)os;
+}
+} // namespace Storage
+} // namespace Surge
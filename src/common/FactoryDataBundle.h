@@ -0,0 +1,130 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_FACTORYDATABUNDLE_H
+#define SURGE_SRC_COMMON_FACTORYDATABUNDLE_H
+
+#include "filesystem/import.h"
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Surge
+{
+namespace Storage
+{
+/*
+ * The factory wavetables and patches packed into one file, which we map read-only rather
+ * than opening and reading thousands of small files one at a time. Since the mapping is
+ * read-only the OS shares its pages between every process which has it open, and within
+ * a process every storage shares the one mapping (see open()).
+ *
+ * The layout, all little endian, is
+ *
+ *   char magic[4] = "sfdb", uint32 version, uint32 entry count, uint32 stamp length
+ *   the stamp bytes
+ *   for each entry: uint64 offset, uint64 size, uint32 path length, the path bytes
+ *   the file contents, each starting on a 16 byte boundary
+ *
+ * where paths are relative to the data directory and use '/' as the separator. The stamp
+ * is the full version of the build which packed it, and a bundle from any other build is
+ * ignored, since the factory data it was packed from may since have been replaced.
+ *
+ * src/surge-factory-bundler packs it at build time. Installers which ship it leave out the
+ * files it holds, so a matching bundle is where the factory lists come from too.
+ */
+class FactoryDataBundle
+{
+  public:
+    static constexpr const char *defaultFileName = "factory-data.sfdb";
+    static constexpr uint32_t version = 2;
+    static std::string stamp();
+
+    ~FactoryDataBundle();
+
+    FactoryDataBundle(const FactoryDataBundle &) = delete;
+    FactoryDataBundle &operator=(const FactoryDataBundle &) = delete;
+
+    /*
+     * Map the bundle at path, or hand back the mapping someone in this process already has.
+     * Returns nullptr if there is no bundle there, it isn't one we understand or it was
+     * packed by a different build.
+     */
+    static std::shared_ptr<FactoryDataBundle> open(const fs::path &path);
+
+    /*
+     * Pack every .wt, .wav and .fxp file under root/subdir for each of subdirs into a
+     * bundle at out, logging what it does to log.
+     */
+    static bool write(const fs::path &root, const std::vector<std::string> &subdirs,
+                      const fs::path &out, std::ostream &log);
+
+    // The subdirectories of the data directory which go into the factory bundle
+    static const std::vector<std::string> &packedSubdirs();
+
+    // relativePath is relative to the data directory, with '/' separators
+    bool find(const std::string &relativePath, const char *&data, size_t &size) const;
+
+    // Every path in the bundle under dir, relative to the data directory as dir is, sorted
+    std::vector<std::string> filesUnder(const std::string &dir) const;
+
+    // Stands in for the modification time of each file in the bundle
+    fs::file_time_type writeTime() const { return fileTime; }
+
+    size_t size() const { return entries.size(); }
+
+    // Lets the stream based readers run straight over the mapped bytes
+    struct StreamBuf : std::streambuf
+    {
+        StreamBuf(const char *data, size_t size)
+        {
+            auto d = const_cast<char *>(data);
+            setg(d, d, d + size);
+        }
+    };
+
+  private:
+    FactoryDataBundle() = default;
+    bool map(const fs::path &path);
+
+    struct Entry
+    {
+        uint64_t offset, size;
+    };
+    std::unordered_map<std::string, Entry> entries;
+
+    const char *base{nullptr};
+    size_t mappedSize{0};
+    fs::file_time_type fileTime{};
+#if WINDOWS
+    void *fileHandle{nullptr}, *mappingHandle{nullptr};
+#endif
+};
+} // namespace Storage
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_FACTORYDATABUNDLE_H
@@ -23,6 +23,12 @@
 #ifndef SURGE_SRC_COMMON_MEMORYPOOL_H
 #define SURGE_SRC_COMMON_MEMORYPOOL_H
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <mutex>
+
 namespace Surge
 {
 namespace Memory
@@ -39,6 +45,8 @@ template <typename T, size_t preAlloc, size_t growBy, size_t capacity = 16384> s
     {
         for (size_t i = 0; i < position; ++i)
             delete pool[i];
+        for (size_t i = 0; i < stagedCount; ++i)
+            delete staged[i];
     }
     template <typename... Args> T *getItem(Args &&...args)
     {
@@ -58,13 +66,13 @@ template <typename T, size_t preAlloc, size_t growBy, size_t capacity = 16384> s
     }
     template <typename... Args> void refreshPool(Args &&...args)
     {
-        // In an ideal world, this grow would be off thread.
-        // For XT 1 leave it here and have a reasonable prealloc
+        // Only if the pool ran dry before maintain() could top it up; see requestSize()
         assert(position < (growBy + capacity));
         for (size_t i = 0; i < growBy; ++i)
         {
             pool[position] = new T(std::forward<Args>(args)...);
             position++;
+            allocated++;
         }
     }
 
@@ -74,6 +82,7 @@ template <typename T, size_t preAlloc, size_t growBy, size_t capacity = 16384> s
         {
             pool[position] = new T(std::forward<Args>(args)...);
             position++;
+            allocated++;
         }
     }
 
@@ -84,9 +93,82 @@ template <typename T, size_t preAlloc, size_t growBy, size_t capacity = 16384> s
             delete pool[position - 1];
             pool[position - 1] = nullptr;
             position--;
+            allocated--;
         }
     }
 
+    /*
+     * Resizing without allocating or freeing on the audio thread. The audio thread asks for
+     * a total number of items (handed out or not) with requestSize() and calls exchange()
+     * once a block. Off the audio thread maintain() builds the shortfall, or frees the
+     * surplus, in a staging area; exchange() only moves pointers between that and the pool,
+     * and only when it can take the lock without waiting.
+     */
+    void requestSize(size_t total)
+    {
+        requested = std::max(total, preAlloc);
+        exchangeNeeded = true;
+    }
+
+    void exchange()
+    {
+        if (!exchangeNeeded.load(std::memory_order_acquire))
+            return;
+
+        std::unique_lock<std::mutex> g(stagingMutex, std::try_to_lock);
+        if (!g.owns_lock())
+            return;
+
+        auto want = requested.load();
+
+        if (allocated > want)
+        {
+            // hand back free items over the request for maintain() to delete
+            while (allocated - stagedCount > want && position > 0 && stagedCount < capacity)
+            {
+                staged[stagedCount++] = pool[--position];
+                pool[position] = nullptr;
+            }
+        }
+        else
+        {
+            while (stagedCount > 0 && position < capacity)
+                pool[position++] = staged[--stagedCount];
+        }
+
+        exchangeNeeded = false;
+    }
+
+    template <typename... Args> void maintain(Args &&...args)
+    {
+        std::lock_guard<std::mutex> g(stagingMutex);
+        auto want = requested.load();
+
+        if (allocated > want)
+        {
+            while (stagedCount > 0 && allocated > want)
+            {
+                delete staged[--stagedCount];
+                allocated--;
+            }
+        }
+        else
+        {
+            while (allocated < want && stagedCount < capacity)
+            {
+                staged[stagedCount++] = new T(std::forward<Args>(args)...);
+                allocated++;
+            }
+        }
+
+        // the free items over the request are still in the pool, or there is something to add
+        if (allocated != want || stagedCount > 0)
+            exchangeNeeded = true;
+    }
+
+    // Everything this pool has built and not yet freed, whether handed out or not
+    size_t residentBytes() const { return allocated * sizeof(T); }
+
     std::array<T *, capacity> pool;
 
     /*
@@ -95,6 +177,21 @@ template <typename T, size_t preAlloc, size_t growBy, size_t capacity = 16384> s
      * position -1. position == 0 is a sentinel to rebuild.
      */
     size_t position{0};
+
+    /*
+     * Items built by this pool and not yet deleted, including those handed out and staged
+     */
+    std::atomic<size_t> allocated{0};
+
+    /*
+     * Built by maintain() and waiting for exchange() to move them into the pool, or moved out
+     * of the pool by exchange() and waiting for maintain() to delete them
+     */
+    std::mutex stagingMutex;
+    std::array<T *, capacity> staged;
+    size_t stagedCount{0};
+    std::atomic<size_t> requested{preAlloc};
+    std::atomic<bool> exchangeNeeded{false};
 };
 } // namespace Memory
 } // namespace Surge
@@ -740,7 +740,7 @@ CREATE TABLE IF NOT EXISTS Favorites (
     {
         sqlite3_stmt *insertStmt = nullptr, *insfeatureStmt = nullptr, *dropIdStmt = nullptr;
 
-        if (!fs::exists(p.path))
+        if (!storage->dataFileExists(p.path))
         {
 #if TRACE_DB
             std::cout << "    - Warning: Non existent " << path_to_string(p.path) << std::endl;
@@ -748,7 +748,7 @@ CREATE TABLE IF NOT EXISTS Favorites (
             return;
         }
         // Check with
-        auto qtime = fs::last_write_time(p.path);
+        auto qtime = storage->dataFileWriteTime(p.path);
         int64_t qtimeInt =
             std::chrono::duration_cast<std::chrono::seconds>(qtime.time_since_epoch()).count();
 
@@ -838,9 +838,10 @@ CREATE TABLE IF NOT EXISTS Favorites (
         std::ostringstream searchName;
         searchName << p.name << " ";
 
-        std::ifstream stream(p.path, std::ios::in | std::ios::binary);
-        std::vector<uint8_t> contents((std::istreambuf_iterator<char>(stream)),
-                                      std::istreambuf_iterator<char>());
+        std::vector<uint8_t> contents;
+        if (auto buf = storage->openDataFileForRead(p.path))
+            contents.assign(std::istreambuf_iterator<char>(buf.get()),
+                            std::istreambuf_iterator<char>());
 
 #pragma pack(push, 1)
         struct patch_header
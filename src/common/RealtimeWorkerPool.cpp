@@ -0,0 +1,275 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "RealtimeWorkerPool.h"
+#include "globals.h"
+
+#include <algorithm>
+
+#if WINDOWS
+#include "windows.h"
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+// Ask for the scheduling the host gives its audio threads, as far as we are allowed to
+bool raiseThreadPriority()
+{
+#if WINDOWS
+    return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) != 0;
+#elif MAC
+    return pthread_set_qos_class_self_np(QOS_CLASS_USER_INTERACTIVE, 0) == 0;
+#else
+    // just above normal realtime work, and below the host's audio threads; usually needs
+    // rtprio in the user's limits, without which the workers stay where they were
+    sched_param sp{};
+    sp.sched_priority = sched_get_priority_min(SCHED_FIFO) + 1;
+    return pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp) == 0;
+#endif
+}
+} // namespace
+
+RealtimeWorkerPool::RealtimeWorkerPool(int nWorkers, std::function<void()> threadInit)
+    : threadInit(std::move(threadInit))
+{
+    addWorkers(nWorkers);
+}
+
+RealtimeWorkerPool::~RealtimeWorkerPool()
+{
+    running = false;
+    {
+        std::lock_guard<std::mutex> g(parkMutex);
+        parkCV.notify_all();
+    }
+
+    for (auto &w : workers)
+        w.join();
+}
+
+void RealtimeWorkerPool::addWorkers(int n)
+{
+    std::lock_guard<std::mutex> g(workersMutex);
+
+    for (int i = 0; i < n; ++i)
+        workers.emplace_back([this]() { workerLoop(); });
+
+    nWorkers.store((int)workers.size(), std::memory_order_release);
+}
+
+int RealtimeWorkerPool::defaultWorkerCount()
+{
+    int hc = (int)std::thread::hardware_concurrency();
+    return std::clamp(hc - 1, 0, 16);
+}
+
+std::shared_ptr<RealtimeWorkerPool> RealtimeWorkerPool::shared(int workersWanted,
+                                                               std::function<void()> threadInit)
+{
+    static std::mutex sharedMutex;
+    static std::weak_ptr<RealtimeWorkerPool> sharedPool;
+
+    auto nw = std::clamp(workersWanted, 0, defaultWorkerCount());
+
+    std::lock_guard<std::mutex> g(sharedMutex);
+
+    auto res = sharedPool.lock();
+    if (!res)
+    {
+        res = std::make_shared<RealtimeWorkerPool>(nw, std::move(threadInit));
+        sharedPool = res;
+    }
+    else if (res->workerCount() < nw)
+    {
+        res->addWorkers(nw - res->workerCount());
+    }
+
+    return res;
+}
+
+void RealtimeWorkerPool::parallelFor(int n, task_t task, void *context, int priority)
+{
+    if (n <= 0)
+        return;
+
+    Job *job{nullptr};
+
+    // after a stall, stay serial for a while rather than waiting on the workers again
+    bool serial = serialCallsLeft.load(std::memory_order_relaxed) > 0 &&
+                  serialCallsLeft.fetch_sub(1, std::memory_order_relaxed) > 0;
+
+    if (nWorkers.load(std::memory_order_relaxed) > 0 && n > 1 && !serial)
+    {
+        for (auto &j : jobs)
+        {
+            bool expected{false};
+            if (!j.busy.load(std::memory_order_relaxed) &&
+                j.busy.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            {
+                job = &j;
+                break;
+            }
+        }
+    }
+
+    if (!job)
+    {
+        for (int i = 0; i < n; ++i)
+            task(context, i);
+        return;
+    }
+
+    // the slot's previous job is closed, so no worker can act on these until we open it
+    job->task.store(task, std::memory_order_relaxed);
+    job->context.store(context, std::memory_order_relaxed);
+    job->size.store(n, std::memory_order_relaxed);
+    job->priority.store(priority, std::memory_order_relaxed);
+    job->done.store(0, std::memory_order_relaxed);
+
+    auto gen = job->generation.load(std::memory_order_relaxed) + 1;
+    job->claim.store((uint64_t)gen << 32, std::memory_order_release);
+    job->generation.store(gen, std::memory_order_release);
+
+    /*
+     * A worker on its way to sleep counts itself parked before it checks posted, and we
+     * bump posted before we check parked, so (both being sequentially consistent) either it
+     * sees this job and stays up or we see it and wake it. Notifying under the lock means
+     * the wake can't land between its check and its wait.
+     */
+    posted.fetch_add(1);
+    if (parked.load() > 0)
+    {
+        std::lock_guard<std::mutex> g(parkMutex);
+        parkCV.notify_all();
+    }
+
+    while (runTask(*job, gen))
+        ;
+
+    // whatever is left was claimed by a worker which hasn't finished it yet
+    if (job->done.load(std::memory_order_acquire) < n)
+    {
+        auto waitStart = std::chrono::steady_clock::now();
+        bool overdue{false};
+
+        while (job->done.load(std::memory_order_acquire) < n)
+        {
+            std::this_thread::yield();
+
+            if (!overdue && std::chrono::steady_clock::now() - waitStart > stallLimit)
+            {
+                overdue = true;
+                stalls.fetch_add(1, std::memory_order_relaxed);
+                serialCallsLeft.store(serialCallsAfterStall, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    job->claim.store(((uint64_t)gen << 32) | closedIndex, std::memory_order_release);
+    job->busy.store(false, std::memory_order_release);
+}
+
+bool RealtimeWorkerPool::runTask(Job &job, uint32_t gen)
+{
+    auto c = job.claim.load(std::memory_order_acquire);
+
+    while (true)
+    {
+        if ((uint32_t)(c >> 32) != gen)
+            return false;
+
+        auto idx = c & closedIndex;
+        if (idx >= (uint64_t)job.size.load(std::memory_order_relaxed))
+            return false;
+
+        if (job.claim.compare_exchange_weak(c, c + 1, std::memory_order_acq_rel,
+                                            std::memory_order_acquire))
+        {
+            auto task = job.task.load(std::memory_order_relaxed);
+            task(job.context.load(std::memory_order_relaxed), (int)idx);
+            job.done.fetch_add(1, std::memory_order_release);
+            return true;
+        }
+    }
+}
+
+bool RealtimeWorkerPool::runBestTask()
+{
+    Job *best{nullptr};
+    uint32_t bestGen{0};
+    int bestPriority{-1};
+
+    for (auto &j : jobs)
+    {
+        if (!j.busy.load(std::memory_order_acquire))
+            continue;
+
+        auto gen = j.generation.load(std::memory_order_acquire);
+        auto c = j.claim.load(std::memory_order_acquire);
+
+        if ((uint32_t)(c >> 32) != gen ||
+            (c & closedIndex) >= (uint64_t)j.size.load(std::memory_order_relaxed))
+            continue;
+
+        auto pri = j.priority.load(std::memory_order_relaxed);
+        if (pri > bestPriority)
+        {
+            best = &j;
+            bestGen = gen;
+            bestPriority = pri;
+        }
+    }
+
+    return best && runTask(*best, bestGen);
+}
+
+void RealtimeWorkerPool::workerLoop()
+{
+#if !ARM_NEON
+    // flush denormals to zero like the host does for the audio thread
+    _mm_setcsr(_mm_getcsr() | 0x8040);
+#endif
+
+    if (raiseThreadPriority())
+        realtimeWorkers++;
+
+    if (threadInit)
+        threadInit();
+
+    while (running)
+    {
+        // anything posted after this load is either seen by the scan or wakes us below
+        auto seen = posted.load(std::memory_order_acquire);
+
+        if (runBestTask())
+            continue;
+
+        // nothing to do, so sleep until something is posted; see parallelFor for the wake
+        std::unique_lock<std::mutex> lock(parkMutex);
+        parked++;
+        parkCV.wait(lock, [this, seen]() { return !running || posted.load() != seen; });
+        parked--;
+    }
+}
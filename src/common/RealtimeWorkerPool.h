@@ -0,0 +1,140 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_REALTIMEWORKERPOOL_H
+#define SURGE_SRC_COMMON_REALTIMEWORKERPOOL_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * A pool of threads audio threads can farm independent pieces of a block out to.
+ *
+ * parallelFor publishes a job into one of a fixed set of slots without locking or
+ * allocating, runs tasks itself alongside the workers, and returns once every task has
+ * finished. The calling thread claims whatever the workers haven't, so a worker which is
+ * slow to wake only costs parallelism. A task a worker has already claimed can't be run
+ * again though, so if that worker is descheduled mid task the caller has to wait for it.
+ * Workers ask for realtime priority to make that rare, and a caller kept waiting longer
+ * than stallLimit sends the pool serial for the next serialCallsAfterStall calls, so a
+ * machine whose workers can't keep up falls back to one thread rather than stalling block
+ * after block. Tasks must not depend on each other or on the order they run in.
+ *
+ * Any number of threads may call parallelFor at once, which is how every synth in a
+ * process can share one pool (see shared()). Idle workers take tasks from whichever
+ * open job has the highest priority, so an instance rendering offline can mark itself
+ * as background work and not get in the way of the ones playing live.
+ */
+class RealtimeWorkerPool
+{
+  public:
+    using task_t = void (*)(void *context, int index);
+
+    enum Priority
+    {
+        priority_background = 0,
+        priority_normal,
+        priority_high,
+    };
+
+    // threadInit runs once on each worker before it takes any work
+    explicit RealtimeWorkerPool(int nWorkers, std::function<void()> threadInit = nullptr);
+    ~RealtimeWorkerPool();
+
+    RealtimeWorkerPool(const RealtimeWorkerPool &) = delete;
+    RealtimeWorkerPool &operator=(const RealtimeWorkerPool &) = delete;
+
+    int workerCount() const { return nWorkers.load(std::memory_order_acquire); }
+    // start more workers; safe while other threads are in parallelFor
+    void addWorkers(int n);
+
+    void parallelFor(int n, task_t task, void *context, int priority = priority_normal);
+
+    // A worker count for this machine, leaving a core for the host
+    static int defaultWorkerCount();
+
+    static constexpr std::chrono::microseconds stallLimit{500};
+    static constexpr int serialCallsAfterStall{2000};
+    // how often a caller has waited past stallLimit on a worker's task
+    int stalled() const { return stalls.load(std::memory_order_relaxed); }
+    // workers the OS let us raise to realtime priority
+    int realtimeWorkerCount() const { return realtimeWorkers.load(std::memory_order_relaxed); }
+
+    /*
+     * The pool shared by everyone in this process. The first caller starts it (with its
+     * threadInit) and it stops when the last holder lets go, rather than in a static
+     * destructor, since joining threads while a plugin is unloading is asking for trouble.
+     * It holds as many workers as the greediest caller asked for, up to
+     * defaultWorkerCount(), so nobody starts threads they have no work for.
+     */
+    static std::shared_ptr<RealtimeWorkerPool> shared(int workersWanted,
+                                                      std::function<void()> threadInit = nullptr);
+
+  private:
+    // claim packs the job generation in the top half and the next task index in the bottom
+    static constexpr uint64_t closedIndex{0xFFFFFFFF};
+
+    struct Job
+    {
+        std::atomic<bool> busy{false};
+        std::atomic<uint64_t> claim{closedIndex};
+        std::atomic<uint32_t> generation{0};
+        std::atomic<int> done{0};
+
+        // A worker may glance at these while they are rewritten, but it can only act on
+        // them after winning a claim for the current generation, so relaxed is enough
+        std::atomic<task_t> task{nullptr};
+        std::atomic<void *> context{nullptr};
+        std::atomic<int> size{0};
+        std::atomic<int> priority{priority_normal};
+    };
+
+    // with every slot taken, parallelFor just runs its job inline
+    static constexpr int maxJobs{64};
+    std::array<Job, maxJobs> jobs;
+    std::atomic<uint32_t> posted{0};
+    std::atomic<int> stalls{0}, serialCallsLeft{0}, realtimeWorkers{0};
+
+    bool runTask(Job &job, uint32_t generation);
+    bool runBestTask();
+    void workerLoop();
+
+    std::atomic<bool> running{true};
+    std::atomic<int> parked{0};
+    std::mutex parkMutex;
+    std::condition_variable parkCV;
+
+    std::function<void()> threadInit;
+    std::mutex workersMutex;
+    std::vector<std::thread> workers;
+    std::atomic<int> nWorkers{0};
+};
+
+#endif // SURGE_SRC_COMMON_REALTIMEWORKERPOOL_H
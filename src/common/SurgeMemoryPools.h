@@ -26,6 +26,8 @@
 #include "SurgeStorage.h"
 #include "MemoryPool.h"
 #include "SSESincDelayLine.h"
+#include "TwistOscillator.h"
+#include "StringOscillator.h"
 
 namespace Surge
 {
@@ -33,7 +35,11 @@ namespace Memory
 {
 struct SurgeMemoryPools
 {
-    SurgeMemoryPools(SurgeStorage *s) : stringDelayLines(s->sinctable) {}
+    SurgeMemoryPools(SurgeStorage *s)
+        : stringDelayLines2k(s->sinctable), stringDelayLines4k(s->sinctable),
+          stringDelayLines8k(s->sinctable), stringDelayLines16k(s->sinctable)
+    {
+    }
 
     /*
      * The largest number of oscillator instances of a particular
@@ -42,39 +48,134 @@ struct SurgeMemoryPools
     static constexpr int maxosc = n_scenes * n_oscs * (MAX_VOICES + 8);
 
     /*
-     * The string needs 2 delay lines per oscillator
+     * The string needs 2 delay lines per oscillator. They come in size classes and a voice
+     * takes the smallest which holds the longest period it expects to play, so high notes
+     * don't pin down a 64k buffer each. The small classes are the common case and get the
+     * bigger prealloc; resetOscillatorPools sizes the classes a patch's strings can reach.
+     */
+    static constexpr size_t minStringDelayLine{2048}, maxStringDelayLine{16384};
+    MemoryPool<SSESincDelayLine<2048>, 8, 4, 2 * maxosc + 100> stringDelayLines2k;
+    MemoryPool<SSESincDelayLine<4096>, 8, 4, 2 * maxosc + 100> stringDelayLines4k;
+    MemoryPool<SSESincDelayLine<8192>, 2, 4, 2 * maxosc + 100> stringDelayLines8k;
+    MemoryPool<SSESincDelayLine<16384>, 2, 4, 2 * maxosc + 100> stringDelayLines16k;
+
+    template <size_t N> auto &stringDelayLinePool()
+    {
+        static_assert(N >= minStringDelayLine && N <= maxStringDelayLine);
+        if constexpr (N == 2048)
+            return stringDelayLines2k;
+        else if constexpr (N == 4096)
+            return stringDelayLines4k;
+        else if constexpr (N == 8192)
+            return stringDelayLines8k;
+        else
+            return stringDelayLines16k;
+    }
+
+    /*
+     * Twist needs one plaits voice, resampler and friends per oscillator
      */
-    MemoryPool<SSESincDelayLine<16384>, 8, 4, 2 * maxosc + 100> stringDelayLines;
+    MemoryPool<TwistOscillator::State, 2, 4, maxosc + 100> twistStates;
+
+    size_t residentBytes() const
+    {
+        return stringDelayLines2k.residentBytes() + stringDelayLines4k.residentBytes() +
+               stringDelayLines8k.residentBytes() + stringDelayLines16k.residentBytes() +
+               twistStates.residentBytes();
+    }
+
     void resetAllPools(SurgeStorage *storage) { resetOscillatorPools(storage); }
+
+    /*
+     * Works out how big each pool should be for the current patch and polyphony limit and asks
+     * for that (see MemoryPool::requestSize), so it doesn't allocate and is fine on the audio
+     * thread. maintain() then builds or frees the difference off the audio thread and
+     * processBlock() moves it in and out of the pools.
+     */
     void resetOscillatorPools(SurgeStorage *storage)
     {
-        bool hasString{false}, hasTwist{false};
-        int nString{0};
+        auto &patch = storage->getPatch();
+        int nTwist{0};
+        // string oscillators whose longest lines reach each size class, shortest class first
+        std::array<int, 4> nStringReaching{};
+
         for (int s = 0; s < n_scenes; ++s)
         {
+            auto &scene = patch.scene[s];
+
             for (int os = 0; os < n_oscs; ++os)
             {
-                auto ot = storage->getPatch().scene[s].osc[os].type.val.i;
+                auto &osc = scene.osc[os];
+                auto ot = osc.type.val.i;
 
                 if (ot == ot_string)
                 {
-                    hasString = true;
-                    nString++;
+                    // FM can stretch the taps far past the note period, see process_block
+                    auto longest = maxStringDelayLine;
+
+                    if (scene.fm_switch.val.i == fm_off)
+                    {
+                        auto lowest = 12.f * (scene.octave.val.i + osc.octave.val.i) +
+                                      std::min(0.f, scene.pitch.val.f) +
+                                      std::min(0.f, osc.pitch.val.f) - scene.pbrange_dn.val.i;
+                        longest = StringOscillator::longestDelayLineFor(storage, &osc, lowest);
+                    }
+
+                    for (size_t c = 0, n = minStringDelayLine; n <= longest; ++c, n *= 2)
+                        nStringReaching[c]++;
+                }
+                if (ot == ot_twist)
+                {
+                    nTwist++;
                 }
-                hasTwist |= (ot == ot_twist);
             }
         }
 
-        if (hasString)
-        {
-            int maxUsed = nString * 2 * storage->getPatch().polylimit.val.i;
-            stringDelayLines.setupPoolToSize((int)(maxUsed * 0.5), storage->sinctable);
-        }
-        else
-        {
-            stringDelayLines.returnToPreAllocSize();
-        }
+        /*
+         * Each string voice holds 2 lines from one class at a time, and we expect no more
+         * than half the polyphony limit's voices in any one class. A class which runs dry
+         * grows on the audio thread and is trimmed back off it later.
+         */
+        int poly = patch.polylimit.val.i;
+        stringDelayLines2k.requestSize(nStringReaching[0] * poly);
+        stringDelayLines4k.requestSize(nStringReaching[1] * poly);
+        stringDelayLines8k.requestSize(nStringReaching[2] * poly);
+        stringDelayLines16k.requestSize(nStringReaching[3] * poly);
+
+        // unlike the strings every voice needs its own, including the few which
+        // enforcePolyphonyLimit lets ride past the limit while they are soft killed
+        twistStates.requestSize(nTwist * std::min(poly + 4, MAX_VOICES));
+
+        sizedForPolylimit = poly;
     }
+
+    /*
+     * Once per block on the audio thread. Picks up polyphony limit changes, which size the
+     * pools as much as the oscillator types do, and moves in whatever maintain() has built.
+     */
+    void processBlock(SurgeStorage *storage)
+    {
+        if (storage->getPatch().polylimit.val.i != sizedForPolylimit)
+            resetOscillatorPools(storage);
+
+        stringDelayLines2k.exchange();
+        stringDelayLines4k.exchange();
+        stringDelayLines8k.exchange();
+        stringDelayLines16k.exchange();
+        twistStates.exchange();
+    }
+
+    // Off the audio thread; see SurgeSynthesizer::runHousekeeping
+    void maintain(SurgeStorage *storage)
+    {
+        stringDelayLines2k.maintain(storage->sinctable);
+        stringDelayLines4k.maintain(storage->sinctable);
+        stringDelayLines8k.maintain(storage->sinctable);
+        stringDelayLines16k.maintain(storage->sinctable);
+        twistStates.maintain();
+    }
+
+    int sizedForPolylimit{-1};
 };
 
 } // namespace Memory
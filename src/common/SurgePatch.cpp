@@ -21,6 +21,7 @@
  */
 
 #include "SurgeStorage.h"
+#include "SurgePatchBinary.h"
 #include "Oscillator.h"
 #include "SurgeParamConfig.h"
 #include "Effect.h"
@@ -1214,6 +1215,13 @@ void SurgePatch::load_patch(const void *data, int datasize, bool preset)
         return;
     assert(datasize);
     assert(data);
+
+    if (!memcmp(data, "sub4", 4))
+    {
+        load_binary_patch(data, datasize, preset);
+        return;
+    }
+
     void *end = (char *)data + datasize;
     patch_header *ph = (patch_header *)data;
     ph->xmlsize = mech::endian_read_int32LE(ph->xmlsize);
@@ -1235,61 +1243,100 @@ void SurgePatch::load_patch(const void *data, int datasize, bool preset)
                     if (wth > end)
                         return;
 
-                    scene[sc].osc[osc].wt.queue_id = -1;
-                    scene[sc].osc[osc].wt.current_id = -1;
-                    scene[sc].osc[osc].wt.queue_filename = "";
-                    scene[sc].osc[osc].wt.current_filename = "";
+                    load_streamed_wavetable(sc, osc, dr);
+                    dr += ph->wtsize[sc][osc];
+                }
+            }
+        }
+    }
+    else
+    {
+        load_xml(data, datasize, preset);
+    }
+}
 
-                    void *d = (void *)((char *)dr + sizeof(wt_header));
+void SurgePatch::load_streamed_wavetable(int sc, int osc, const char *dr)
+{
+    wt_header *wth = (wt_header *)dr;
 
-                    storage->waveTableDataMutex.lock();
-                    scene[sc].osc[osc].wt.BuildWT(d, *wth, false);
+    scene[sc].osc[osc].wt.queue_id = -1;
+    scene[sc].osc[osc].wt.current_id = -1;
+    scene[sc].osc[osc].wt.queue_filename = "";
+    scene[sc].osc[osc].wt.current_filename = "";
 
-                    bool hadName{true};
+    void *d = (void *)((char *)dr + sizeof(wt_header));
 
-                    if (scene[sc].osc[osc].wavetable_display_name.empty())
-                    {
-                        hadName = false;
+    storage->waveTableDataMutex.lock();
+    scene[sc].osc[osc].wt.BuildWT(d, *wth, false);
 
-                        if (scene[sc].osc[osc].wt.flags & wtf_is_sample)
-                        {
-                            scene[sc].osc[osc].wavetable_display_name = "(Patch Sample)";
-                        }
-                        else
-                        {
-                            scene[sc].osc[osc].wavetable_display_name = "(Patch Wavetable)";
-                        }
-                    }
+    bool hadName{true};
 
-                    storage->waveTableDataMutex.unlock();
+    if (scene[sc].osc[osc].wavetable_display_name.empty())
+    {
+        hadName = false;
 
-                    if (hadName && scene[sc].osc[osc].wt.current_id < 0)
-                    {
-                        for (int i = 0;
-                             i < storage->wt_list.size() && scene[sc].osc[osc].wt.current_id < 0;
-                             ++i)
-                        {
-                            if (scene[sc].osc[osc].wavetable_display_name ==
-                                storage->wt_list[i].name)
-                            {
-                                scene[sc].osc[osc].wt.current_id = i;
-                            }
-                        }
-                    }
+        if (scene[sc].osc[osc].wt.flags & wtf_is_sample)
+        {
+            scene[sc].osc[osc].wavetable_display_name = "(Patch Sample)";
+        }
+        else
+        {
+            scene[sc].osc[osc].wavetable_display_name = "(Patch Wavetable)";
+        }
+    }
 
-                    dr += ph->wtsize[sc][osc];
-                }
+    storage->waveTableDataMutex.unlock();
+
+    if (hadName && scene[sc].osc[osc].wt.current_id < 0)
+    {
+        for (int i = 0; i < storage->wt_list.size() && scene[sc].osc[osc].wt.current_id < 0; ++i)
+        {
+            if (scene[sc].osc[osc].wavetable_display_name == storage->wt_list[i].name)
+            {
+                scene[sc].osc[osc].wt.current_id = i;
             }
         }
     }
-    else
+}
+
+unsigned int SurgePatch::streamed_wavetable_size(int sc, int osc) const
+{
+    if (!uses_wavetabledata(scene[sc].osc[osc].type.val.i))
+        return 0;
+
+    assert(scene[sc].osc[osc].wt.everBuilt);
+    return scene[sc].osc[osc].wt.size * scene[sc].osc[osc].wt.n_tables * sizeof(short) +
+           sizeof(wt_header);
+}
+
+void SurgePatch::save_streamed_wavetable(int sc, int osc, char *dw) const
+{
+    wt_header wth;
+    int n_tables = scene[sc].osc[osc].wt.n_tables;
+    int n_samples = scene[sc].osc[osc].wt.size;
+
+    // do all endian swapping for the wavetables in one place (for ppc)
+    memset(wth.tag, 0, 4);
+    wth.n_samples = mech::endian_write_int32LE(n_samples);
+    wth.n_tables = mech::endian_write_int16LE(n_tables);
+    wth.flags = mech::endian_write_int16LE(scene[sc].osc[osc].wt.flags | wtf_int16);
+
+    memcpy(dw, &wth, sizeof(wt_header));
+    short *fp = (short *)(char *)(dw + sizeof(wt_header));
+
+    for (int j = 0; j < n_tables; j++)
     {
-        load_xml(data, datasize, preset);
+        mech::endian_copyblock16LE(
+            &fp[j * n_samples], &scene[sc].osc[osc].wt.TableI16WeakPointers[0][j][FIRoffsetI16],
+            n_samples);
     }
 }
 
-unsigned int SurgePatch::save_patch(void **data)
+unsigned int SurgePatch::save_patch(void **data, bool binary)
 {
+    if (binary)
+        return save_binary_patch(data);
+
     size_t psize = 0;
     // void **xmldata = new void*();
     void *xmldata = 0;
@@ -1298,26 +1345,13 @@ unsigned int SurgePatch::save_patch(void **data)
     memcpy(header.tag, "sub3", 4);
     size_t xmlsize = save_xml(&xmldata);
     header.xmlsize = mech::endian_write_int32LE(xmlsize);
-    wt_header wth[n_scenes][n_oscs];
     for (int sc = 0; sc < n_scenes; sc++)
     {
         for (int osc = 0; osc < n_oscs; osc++)
         {
-            if (uses_wavetabledata(scene[sc].osc[osc].type.val.i))
-            {
-                assert(scene[sc].osc[osc].wt.everBuilt);
-                memset(wth[sc][osc].tag, 0, 4);
-                wth[sc][osc].n_samples = scene[sc].osc[osc].wt.size;
-                wth[sc][osc].n_tables = scene[sc].osc[osc].wt.n_tables;
-                wth[sc][osc].flags = scene[sc].osc[osc].wt.flags | wtf_int16;
-                unsigned int wtsize =
-                    wth[sc][osc].n_samples * scene[sc].osc[osc].wt.n_tables * sizeof(short) +
-                    sizeof(wt_header);
-                header.wtsize[sc][osc] = mech::endian_write_int32LE(wtsize);
-                psize += wtsize;
-            }
-            else
-                header.wtsize[sc][osc] = 0;
+            auto wtsize = streamed_wavetable_size(sc, osc);
+            header.wtsize[sc][osc] = mech::endian_write_int32LE(wtsize);
+            psize += wtsize;
         }
     }
     psize += xmlsize + sizeof(patch_header);
@@ -1338,25 +1372,8 @@ unsigned int SurgePatch::save_patch(void **data)
         {
             if (header.wtsize[sc][osc])
             {
-                size_t wtsize = mech::endian_read_int32LE(header.wtsize[sc][osc]);
-                int n_tables = wth[sc][osc].n_tables;
-                int n_samples = wth[sc][osc].n_samples;
-
-                // do all endian swapping for the wavetables in one place (for ppc)
-                wth[sc][osc].n_samples = mech::endian_write_int32LE(wth[sc][osc].n_samples);
-                wth[sc][osc].n_tables = mech::endian_write_int16LE(wth[sc][osc].n_tables);
-                wth[sc][osc].flags = mech::endian_write_int16LE(wth[sc][osc].flags | wtf_int16);
-
-                memcpy(dw, &wth[sc][osc], sizeof(wt_header));
-                short *fp = (short *)(char *)(dw + sizeof(wt_header));
-
-                for (int j = 0; j < n_tables; j++)
-                {
-                    mech::endian_copyblock16LE(
-                        &fp[j * n_samples],
-                        &scene[sc].osc[osc].wt.TableI16WeakPointers[0][j][FIRoffsetI16], n_samples);
-                }
-                dw += wtsize;
+                save_streamed_wavetable(sc, osc, dw);
+                dw += mech::endian_read_int32LE(header.wtsize[sc][osc]);
             }
         }
     }
@@ -1384,7 +1401,250 @@ float convert_v11_reso_to_v12_2P(float reso)
 
 float convert_v11_reso_to_v12_4P(float reso) { return reso * (0.99f / 1.05f); }
 
-void SurgePatch::load_xml(const void *data, int datasize, bool is_preset)
+void SurgePatch::restoreStreamedParameter(int i, const StreamedParameter &sp, int revision)
+{
+    if (sp.type == (valtypes)vt_float)
+    {
+        if (sp.hasValue)
+        {
+            param_ptr[i]->set_storage_value((float)sp.f);
+        }
+        else
+        {
+            param_ptr[i]->val.f = param_ptr[i]->val_default.f;
+        }
+    }
+    else
+    {
+        if (sp.hasValue)
+        {
+            param_ptr[i]->set_storage_value(sp.i);
+        }
+        else
+        {
+            param_ptr[i]->val.i = param_ptr[i]->val_default.i;
+        }
+    }
+
+    if (sp.temposync && *sp.temposync == 1)
+    {
+        param_ptr[i]->temposync = true;
+    }
+
+    if (sp.portaConstRate)
+    {
+        param_ptr[i]->porta_constrate = (*sp.portaConstRate == 1);
+    }
+    else
+    {
+        if (param_ptr[i]->has_portaoptions())
+        {
+            param_ptr[i]->porta_constrate = false;
+        }
+    }
+
+    if (sp.portaGliss)
+    {
+        param_ptr[i]->porta_gliss = (*sp.portaGliss == 1);
+    }
+    else
+    {
+        if (param_ptr[i]->has_portaoptions())
+        {
+            param_ptr[i]->porta_gliss = false;
+        }
+    }
+
+    if (sp.portaRetrigger)
+    {
+        param_ptr[i]->porta_retrigger = (*sp.portaRetrigger == 1);
+    }
+    else
+    {
+        if (param_ptr[i]->has_portaoptions())
+        {
+            param_ptr[i]->porta_retrigger = false;
+        }
+    }
+
+    if (sp.portaCurve)
+    {
+        switch (*sp.portaCurve)
+        {
+        case porta_log:
+        case porta_lin:
+        case porta_exp:
+            param_ptr[i]->porta_curve = *sp.portaCurve;
+            break;
+        }
+    }
+    else
+    {
+        if (param_ptr[i]->has_portaoptions())
+        {
+            param_ptr[i]->porta_curve = porta_lin;
+        }
+    }
+
+    if (sp.deformType)
+        param_ptr[i]->deform_type = *sp.deformType;
+    else
+    {
+        if (param_ptr[i]->has_deformoptions())
+        {
+            if (param_ptr[i]->ctrltype == ct_noise_color)
+            {
+                param_ptr[i]->deform_type = NoiseColorChannels::STEREO;
+            }
+            else
+            {
+                param_ptr[i]->deform_type = type_1;
+            }
+        }
+    }
+
+    if (sp.deactivated)
+    {
+        param_ptr[i]->deactivated = (*sp.deactivated == 1);
+    }
+    else
+    {
+        if (param_ptr[i]->can_deactivate())
+        {
+            auto cg = param_ptr[i]->ctrlgroup;
+            auto ct = param_ptr[i]->ctrltype;
+
+            // Do we want to taggle to default deactivated on or off?
+            if ((cg == cg_LFO) || // this is the LFO rate and env special case
+                (cg == cg_GLOBAL &&
+                 ct == ct_freq_hpf) || // this is the global highpass special case
+                (ct == ct_filtertype || ct == ct_wstype) // filter bypass
+            )
+            {
+                param_ptr[i]->deactivated = false;
+            }
+            else
+            {
+                param_ptr[i]->deactivated = true;
+            }
+        }
+        else if (revision == 16 && param_ptr[i]->ctrlgroup == cg_FX)
+        {
+            /*
+             * So, alas, we added deactivatable FX filters and stuff very late in the 1.9
+             * cycle. The handle streaming handles 15 versions and stuff but 16s with no POV
+             * get the random default. Now, you may ask, why not put this inside the
+             * can_deactivate block? Well since we haven't created the FX yet we don't
+             * know the type and so we don't know if it is deactivatble.
+             *
+             * So what we do is, for revision 16 patches where we don't know if they
+             * were saved during the 4 months of nightlies or 9 days before release,
+             * we assume if there is no statement they were saved in the 4 months and
+             * clobber any unknown deactivated state to false here.
+             */
+            param_ptr[i]->deactivated = false;
+        }
+    }
+
+    if (sp.extendRange)
+    {
+        param_ptr[i]->set_extend_range((*sp.extendRange == 1));
+    }
+    else
+    {
+        param_ptr[i]->set_extend_range(false);
+
+        if (revision >= 16 && param_ptr[i]->ctrltype == ct_percent_oscdrift)
+        {
+            param_ptr[i]->set_extend_range(true);
+        }
+    }
+
+    if (sp.absolute)
+    {
+        param_ptr[i]->absolute = (*sp.absolute == 1);
+    }
+
+    int sceneId = param_ptr[i]->scene;
+    int paramIdInScene = param_ptr[i]->param_id_in_scene;
+
+    /*
+     * Note when we make int modulation work we will have to remove this conditional here
+     */
+    if (sp.hasType && sp.type != vt_float)
+    {
+        return;
+    }
+
+    for (const auto &mr : sp.routings)
+    {
+        int modsource = mr.source;
+
+        if (revision < 9)
+        {
+            // make room for ctrl8 in old patches
+            if (modsource > ms_ctrl7)
+            {
+                modsource++;
+            }
+        }
+
+        // see GitHub issue #6424
+        if (revision < 21 && param_ptr[i] == &volume)
+        {
+            continue;
+        }
+
+        vector<ModulationRouting> *modlist = nullptr;
+
+        if (sceneId != 0)
+        {
+            if (isScenelevel((modsources)modsource))
+            {
+                modlist = &scene[sceneId - 1].modulation_scene;
+            }
+            else
+            {
+                modlist = &scene[sceneId - 1].modulation_voice;
+            }
+        }
+        else
+        {
+            modlist = &modulation_global;
+        }
+
+        ModulationRouting t;
+        t.depth = (float)mr.depth;
+        t.source_id = modsource;
+
+        if (sceneId != 0)
+        {
+            t.source_scene = sceneId - 1;
+        }
+        else
+        {
+            // Explicitly set scene to A if we don't know. See #2285
+            t.source_scene = mr.sourceScene.value_or(0);
+        }
+
+        t.muted = mr.muted.value_or(0);
+        t.source_index = mr.sourceIndex.value_or(0);
+
+        if (sceneId != 0)
+        {
+            t.destination_id = paramIdInScene;
+        }
+        else
+        {
+            t.destination_id = i;
+        }
+
+        modlist->push_back(t);
+    }
+}
+
+void SurgePatch::load_xml(const void *data, int datasize, bool is_preset,
+                          const BinarySections *binary)
 {
     TiXmlDocument doc;
     int j;
@@ -1517,11 +1777,11 @@ void SurgePatch::load_xml(const void *data, int datasize, bool is_preset)
     }
 
     TiXmlElement *parameters = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("parameters"));
-    assert(parameters);
+    assert(parameters || binary);
     int n = param_ptr.size();
 
     // delete volume & fx_bypass if it's a preset. Those settings should stick
-    if (is_preset)
+    if (is_preset && parameters)
     {
         if (revision < 17)
         {
@@ -1549,9 +1809,10 @@ void SurgePatch::load_xml(const void *data, int datasize, bool is_preset)
          */
     }
 
-    TiXmlElement *p;
+    TiXmlElement *p = nullptr;
+    StreamedParameter sp;
 
-    for (int i = 0; i < n; i++)
+    for (int i = 0; i < n && parameters; i++)
     {
         if (!i)
         {
@@ -1573,294 +1834,78 @@ void SurgePatch::load_xml(const void *data, int datasize, bool is_preset)
 
         if (p)
         {
-            int type;
-            bool hasStreamedType = true;
-
-            if (!(p->QueryIntAttribute("type", &type) == TIXML_SUCCESS))
-            {
-                hasStreamedType = false;
-                type = param_ptr[i]->valtype;
-            }
-
-            if (type == (valtypes)vt_float)
-            {
-                if (p->QueryDoubleAttribute("value", &d) == TIXML_SUCCESS)
-                {
-                    param_ptr[i]->set_storage_value((float)d);
-                }
-                else
-                {
-                    param_ptr[i]->val.f = param_ptr[i]->val_default.f;
-                }
-            }
-            else
-            {
-                if (p->QueryIntAttribute("value", &j) == TIXML_SUCCESS)
-                {
-                    param_ptr[i]->set_storage_value(j);
-                }
-                else
-                {
-                    param_ptr[i]->val.i = param_ptr[i]->val_default.i;
-                }
-            }
-
-            if ((p->QueryIntAttribute("temposync", &j) == TIXML_SUCCESS) && (j == 1))
-            {
-                param_ptr[i]->temposync = (j == 1);
-            }
-
-            if ((p->QueryIntAttribute("porta_const_rate", &j) == TIXML_SUCCESS))
-            {
-                param_ptr[i]->porta_constrate = (j == 1);
-            }
-            else
-            {
-                if (param_ptr[i]->has_portaoptions())
-                {
-                    param_ptr[i]->porta_constrate = false;
-                }
-            }
-
-            if ((p->QueryIntAttribute("porta_gliss", &j) == TIXML_SUCCESS))
-            {
-                param_ptr[i]->porta_gliss = (j == 1);
-            }
-            else
-            {
-                if (param_ptr[i]->has_portaoptions())
-                {
-                    param_ptr[i]->porta_gliss = false;
-                }
-            }
+            sp.clear();
 
-            if ((p->QueryIntAttribute("porta_retrigger", &j) == TIXML_SUCCESS))
-            {
-                param_ptr[i]->porta_retrigger = (j == 1);
-            }
-            else
-            {
-                if (param_ptr[i]->has_portaoptions())
-                {
-                    param_ptr[i]->porta_retrigger = false;
-                }
-            }
-
-            if ((p->QueryIntAttribute("porta_curve", &j) == TIXML_SUCCESS))
-            {
-                switch (j)
-                {
-                case porta_log:
-                case porta_lin:
-                case porta_exp:
-                    param_ptr[i]->porta_curve = j;
-                    break;
-                }
-            }
-            else
+            if (p->QueryIntAttribute("type", &sp.type) == TIXML_SUCCESS)
             {
-                if (param_ptr[i]->has_portaoptions())
-                {
-                    param_ptr[i]->porta_curve = porta_lin;
-                }
+                sp.hasType = true;
             }
-
-            if ((p->QueryIntAttribute("deform_type", &j) == TIXML_SUCCESS))
-                param_ptr[i]->deform_type = j;
             else
             {
-                if (param_ptr[i]->has_deformoptions())
-                {
-                    if (param_ptr[i]->ctrltype == ct_noise_color)
-                    {
-                        param_ptr[i]->deform_type = NoiseColorChannels::STEREO;
-                    }
-                    else
-                    {
-                        param_ptr[i]->deform_type = type_1;
-                    }
-                }
+                sp.type = param_ptr[i]->valtype;
             }
 
-            if ((p->QueryIntAttribute("deactivated", &j) == TIXML_SUCCESS))
+            if (sp.type == (valtypes)vt_float)
             {
-                param_ptr[i]->deactivated = (j == 1);
+                sp.hasValue = (p->QueryDoubleAttribute("value", &sp.f) == TIXML_SUCCESS);
             }
             else
             {
-                if (param_ptr[i]->can_deactivate())
-                {
-                    auto cg = param_ptr[i]->ctrlgroup;
-                    auto ct = param_ptr[i]->ctrltype;
-
-                    // Do we want to taggle to default deactivated on or off?
-                    if ((cg == cg_LFO) || // this is the LFO rate and env special case
-                        (cg == cg_GLOBAL &&
-                         ct == ct_freq_hpf) || // this is the global highpass special case
-                        (ct == ct_filtertype || ct == ct_wstype) // filter bypass
-                    )
-                    {
-                        param_ptr[i]->deactivated = false;
-                    }
-                    else
-                    {
-                        param_ptr[i]->deactivated = true;
-                    }
-                }
-                else if (revision == 16 && param_ptr[i]->ctrlgroup == cg_FX)
-                {
-                    /*
-                     * So, alas, we added deactivatable FX filters and stuff very late in the 1.9
-                     * cycle. The handle streaming handles 15 versions and stuff but 16s with no POV
-                     * get the random default. Now, you may ask, why not put this inside the
-                     * can_deactivate block? Well since we haven't created the FX yet we don't
-                     * know the type and so we don't know if it is deactivatble.
-                     *
-                     * So what we do is, for revision 16 patches where we don't know if they
-                     * were saved during the 4 months of nightlies or 9 days before release,
-                     * we assume if there is no statement they were saved in the 4 months and
-                     * clobber any unknown deactivated state to false here.
-                     */
-                    param_ptr[i]->deactivated = false;
-                }
-            }
-
-            if (p->QueryIntAttribute("extend_range", &j) == TIXML_SUCCESS)
-            {
-                param_ptr[i]->set_extend_range((j == 1));
+                sp.hasValue = (p->QueryIntAttribute("value", &sp.i) == TIXML_SUCCESS);
             }
-            else
-            {
-                param_ptr[i]->set_extend_range(false);
 
-                if (revision >= 16 && param_ptr[i]->ctrltype == ct_percent_oscdrift)
+            auto queryOpt = [p, &j](const char *attr, std::optional<int> &to) {
+                if (p->QueryIntAttribute(attr, &j) == TIXML_SUCCESS)
                 {
-                    param_ptr[i]->set_extend_range(true);
+                    to = j;
                 }
-            }
+            };
 
-            if (p->QueryIntAttribute("absolute", &j) == TIXML_SUCCESS)
-            {
-                param_ptr[i]->absolute = (j == 1);
-            }
+            queryOpt("temposync", sp.temposync);
+            queryOpt("porta_const_rate", sp.portaConstRate);
+            queryOpt("porta_gliss", sp.portaGliss);
+            queryOpt("porta_retrigger", sp.portaRetrigger);
+            queryOpt("porta_curve", sp.portaCurve);
+            queryOpt("deform_type", sp.deformType);
+            queryOpt("deactivated", sp.deactivated);
+            queryOpt("extend_range", sp.extendRange);
+            queryOpt("absolute", sp.absolute);
 
-            int sceneId = param_ptr[i]->scene;
-            int paramIdInScene = param_ptr[i]->param_id_in_scene;
             TiXmlElement *mr = TINYXML_SAFE_TO_ELEMENT(p->FirstChild("modrouting"));
 
-            /*
-             * Note when we make int modulation work we will have to remove this conditional here
-             */
-            /*
-            if( mr && hasStreamedType && type != vt_float )
-                std::cout << "Dropping modulations for param " << p->Value()
-                << hasStreamedType << " " << type << " " << vt_float << std::endl;
-                */
-
-            while (mr && (!hasStreamedType || type == vt_float))
+            while (mr)
             {
-                int modsource;
-                double depth;
+                StreamedParameter::Routing r;
 
-                if ((mr->QueryIntAttribute("source", &modsource) == TIXML_SUCCESS) &&
-                    (mr->QueryDoubleAttribute("depth", &depth) == TIXML_SUCCESS))
+                if ((mr->QueryIntAttribute("source", &r.source) == TIXML_SUCCESS) &&
+                    (mr->QueryDoubleAttribute("depth", &r.depth) == TIXML_SUCCESS))
                 {
-                    if (revision < 9)
-                    {
-                        // make room for ctrl8 in old patches
-                        if (modsource > ms_ctrl7)
-                        {
-                            modsource++;
-                        }
-                    }
-
-                    // see GitHub issue #6424
-                    if (revision < 21 && param_ptr[i] == &volume)
-                    {
-                        mr = TINYXML_SAFE_TO_ELEMENT(mr->NextSibling("modrouting"));
-                        continue;
-                    }
-
-                    vector<ModulationRouting> *modlist = nullptr;
-
-                    if (sceneId != 0)
-                    {
-                        if (isScenelevel((modsources)modsource))
-                        {
-                            modlist = &scene[sceneId - 1].modulation_scene;
-                        }
-                        else
-                        {
-                            modlist = &scene[sceneId - 1].modulation_voice;
-                        }
-                    }
-                    else
-                    {
-                        modlist = &modulation_global;
-                    }
-
-                    ModulationRouting t;
-                    t.depth = (float)depth;
-                    t.source_id = modsource;
-
-                    if (sceneId != 0)
-                    {
-                        t.source_scene = sceneId - 1;
-                    }
-                    else
-                    {
-                        int sourcescene = 0;
-
-                        if (mr->QueryIntAttribute("source_scene", &sourcescene) == TIXML_SUCCESS)
-                        {
-                            t.source_scene = sourcescene;
-                        }
-                        else
+                    auto mrOpt = [mr, &j](const char *attr, std::optional<int> &to) {
+                        if (mr->QueryIntAttribute(attr, &j) == TIXML_SUCCESS)
                         {
-                            // Explicitly set scene to A. See #2285
-                            t.source_scene = 0;
+                            to = j;
                         }
-                    }
-
-                    int muted = 0;
-
-                    if (mr->QueryIntAttribute("muted", &muted) == TIXML_SUCCESS)
-                    {
-                        t.muted = muted;
-                    }
-                    else
-                    {
-                        t.muted = false;
-                    }
-
-                    int source_index = 0;
+                    };
 
-                    if (mr->QueryIntAttribute("source_index", &source_index) == TIXML_SUCCESS)
-                    {
-                        t.source_index = source_index;
-                    }
-                    else
-                    {
-                        t.source_index = 0;
-                    }
-
-                    if (sceneId != 0)
-                    {
-                        t.destination_id = paramIdInScene;
-                    }
-                    else
-                    {
-                        t.destination_id = i;
-                    }
+                    mrOpt("muted", r.muted);
+                    mrOpt("source_index", r.sourceIndex);
+                    mrOpt("source_scene", r.sourceScene);
 
-                    modlist->push_back(t);
+                    sp.routings.push_back(r);
                 }
 
                 mr = TINYXML_SAFE_TO_ELEMENT(mr->NextSibling("modrouting"));
             }
+
+            restoreStreamedParameter(i, sp, revision);
         }
     }
 
+    if (!parameters && binary)
+    {
+        restoreBinaryParameters(*binary, revision, is_preset);
+    }
+
     if (scene[0].pbrange_up.val.i & 0xffffff00) // is outside range, it must have been saved
     {
         for (int sc = 0; sc < n_scenes; sc++)
@@ -2459,6 +2504,11 @@ void SurgePatch::load_xml(const void *data, int datasize, bool is_preset)
         p = TINYXML_SAFE_TO_ELEMENT(p->NextSibling("mseg"));
     }
 
+    if (binary)
+    {
+        restoreBinaryMSEGs(*binary, userPrefRestoreMSEGFromPatch);
+    }
+
     // end restore MSEGs
 
     // make sure rev 15 and older patches have the locked endpoints if they were in LFO edit mode
@@ -2511,6 +2561,11 @@ void SurgePatch::load_xml(const void *data, int datasize, bool is_preset)
         p = TINYXML_SAFE_TO_ELEMENT(p->NextSibling("formula"));
     }
 
+    if (binary)
+    {
+        restoreBinaryFormulae(*binary);
+    }
+
     for (int i = 0; i < n_customcontrollers; i++)
     {
         scene[0].modsources[ms_ctrl1 + i]->reset();
@@ -3108,7 +3163,8 @@ struct srge_header
     int revision;
 };
 
-unsigned int SurgePatch::save_xml(void **data) // allocates mem, must be freed by the callee
+// allocates mem, must be freed by the callee
+unsigned int SurgePatch::save_xml(void **data, bool forBinaryChunk)
 {
     assert(data);
 
@@ -3147,7 +3203,8 @@ unsigned int SurgePatch::save_xml(void **data) // allocates mem, must be freed b
 
     TiXmlElement parameters("parameters");
 
-    for (int i = 0; i < n; i++)
+    // a binary chunk carries the parameters and routings itself
+    for (int i = 0; i < n && !forBinaryChunk; i++)
     {
         TiXmlElement p(param_ptr[i]->get_storage_name());
 
@@ -3245,7 +3302,8 @@ unsigned int SurgePatch::save_xml(void **data) // allocates mem, must be freed b
             parameters.InsertEndChild(p);
         }
     }
-    patch.InsertEndChild(parameters);
+    if (!forBinaryChunk)
+        patch.InsertEndChild(parameters);
 
     TiXmlElement nonparamconfig("nonparamconfig");
     for (int sc = 0; sc < n_scenes; ++sc)
@@ -3360,7 +3418,7 @@ unsigned int SurgePatch::save_xml(void **data) // allocates mem, must be freed b
     {
         for (int l = 0; l < n_lfos; l++)
         {
-            if (scene[sc].lfo[l].shape.val.i == lt_mseg)
+            if (scene[sc].lfo[l].shape.val.i == lt_mseg && !forBinaryChunk)
             {
                 TiXmlElement p("mseg");
                 p.SetAttribute("scene", sc);
@@ -3379,7 +3437,7 @@ unsigned int SurgePatch::save_xml(void **data) // allocates mem, must be freed b
     {
         for (int l = 0; l < n_lfos; l++)
         {
-            if (scene[sc].lfo[l].shape.val.i == lt_formula)
+            if (scene[sc].lfo[l].shape.val.i == lt_formula && !forBinaryChunk)
             {
                 TiXmlElement p("formula");
                 p.SetAttribute("scene", sc);
@@ -0,0 +1,699 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+/*
+ * The "sub4" binary state chunk. It looks like this, all little endian:
+ *
+ *   "sub4" | u32 chunk version | u32 ff_revision | u32 section count | sections...
+ *
+ * and each section is a four character id, a u32 size and that many bytes. Readers skip
+ * sections they don't know, so new ones can be added without bumping the chunk version.
+ *
+ *   "xml "  the patch XML without the parameters, MSEGs and formulae, loaded by load_xml
+ *   "prms"  one record per streamed parameter, in param_ptr order
+ *   "rout"  the modulation routings, pointing at records in "prms"
+ *   "msgs"  the MSEGs of every LFO set to MSEG
+ *   "frml"  the formulae of every LFO set to formula
+ *   "wavt"  the wavetables, in exactly the form a "sub3" chunk holds them
+ *
+ * The parameter and routing records store the same optional attributes the XML does, under
+ * the same conditions, and go through the same SurgePatch::restoreStreamedParameter, so a
+ * patch comes back from either form identically.
+ */
+
+#include "SurgeStorage.h"
+#include "SurgePatchBinary.h"
+#include "MSEGModulationHelper.h"
+#include "DebugHelpers.h"
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+constexpr uint32_t binaryChunkVersion = 1;
+
+struct BinaryWriter
+{
+    std::vector<char> buf;
+
+    void bytes(const void *d, size_t n)
+    {
+        auto c = (const char *)d;
+        buf.insert(buf.end(), c, c + n);
+    }
+
+    void u8(uint8_t v) { buf.push_back((char)v); }
+
+    void u16(uint16_t v)
+    {
+        u8(v & 0xFF);
+        u8(v >> 8);
+    }
+
+    void u32(uint32_t v)
+    {
+        u16(v & 0xFFFF);
+        u16(v >> 16);
+    }
+
+    void i32(int32_t v) { u32((uint32_t)v); }
+
+    void f32(float f)
+    {
+        uint32_t v;
+        memcpy(&v, &f, sizeof(v));
+        u32(v);
+    }
+
+    void str(const std::string &s)
+    {
+        u32(s.size());
+        bytes(s.data(), s.size());
+    }
+
+    void tag(const char *t) { bytes(t, 4); }
+
+    // For the counts at the front of a section, which we only know once it is written
+    void patchU32(size_t at, uint32_t v)
+    {
+        for (int b = 0; b < 4; ++b)
+            buf[at + b] = (char)((v >> (8 * b)) & 0xFF);
+    }
+
+    // Appends another writer's buffer as a section
+    void section(const char *t, const BinaryWriter &w)
+    {
+        tag(t);
+        u32(w.buf.size());
+        bytes(w.buf.data(), w.buf.size());
+    }
+};
+
+/*
+ * Reads past the end of the data return zeros and set ok to false, so callers can read a
+ * whole record and check once.
+ */
+struct BinaryReader
+{
+    const char *d;
+    size_t size, pos{0};
+    bool ok{true};
+
+    BinaryReader(const char *data, size_t sz) : d(data), size(sz) {}
+
+    bool has(size_t n)
+    {
+        if (pos + n > size)
+        {
+            ok = false;
+            pos = size;
+        }
+        return ok;
+    }
+
+    const char *bytes(size_t n)
+    {
+        if (!has(n))
+            return nullptr;
+        auto r = d + pos;
+        pos += n;
+        return r;
+    }
+
+    uint8_t u8()
+    {
+        auto b = bytes(1);
+        return b ? (uint8_t)b[0] : 0;
+    }
+
+    uint16_t u16()
+    {
+        uint16_t lo = u8();
+        return lo | (uint16_t)(u8() << 8);
+    }
+
+    uint32_t u32()
+    {
+        uint32_t lo = u16();
+        return lo | ((uint32_t)u16() << 16);
+    }
+
+    int32_t i32() { return (int32_t)u32(); }
+
+    float f32()
+    {
+        auto v = u32();
+        float f;
+        memcpy(&f, &v, sizeof(f));
+        return f;
+    }
+
+    std::string str()
+    {
+        auto n = u32();
+        auto b = bytes(n);
+        return b ? std::string(b, n) : std::string();
+    }
+};
+
+/*
+ * A streamed wavetable is a wt_header and then n_tables tables of n_samples each. BuildWT
+ * believes the header, so check the tables it describes really are inside the section.
+ */
+bool streamedWavetableFits(const char *d, uint32_t size)
+{
+    BinaryReader h(d, size);
+    h.bytes(4); // the tag
+    uint64_t nSamples = h.u32();
+    uint64_t nTables = h.u16();
+    auto flags = h.u16();
+
+    if (!h.ok || nSamples == 0 || nTables > max_subtables)
+        return false;
+
+    uint64_t sampleSize = (flags & wtf_int16) ? sizeof(short) : sizeof(float);
+
+    return nSamples * nTables * sampleSize <= size - sizeof(wt_header);
+}
+
+// The optional parameter attributes, in the order their bits and values are streamed
+enum ParameterOptionBits
+{
+    po_temposync = 1 << 0,
+    po_portaConstRate = 1 << 1,
+    po_portaGliss = 1 << 2,
+    po_portaRetrigger = 1 << 3,
+    po_portaCurve = 1 << 4,
+    po_deformType = 1 << 5,
+    po_deactivated = 1 << 6,
+    po_extendRange = 1 << 7,
+    po_absolute = 1 << 8,
+};
+
+enum RoutingOptionBits
+{
+    ro_muted = 1 << 0,
+    ro_sourceIndex = 1 << 1,
+    ro_sourceScene = 1 << 2,
+};
+
+void writeRouting(BinaryWriter &w, uint32_t record, const ModulationRouting &r, bool global)
+{
+    w.u32(record);
+    w.i32(r.source_id);
+    w.f32(r.depth);
+
+    // like the XML, scene routings don't stream their source scene
+    w.u8(ro_muted | ro_sourceIndex | (global ? ro_sourceScene : 0));
+    w.i32(r.muted);
+    w.i32(r.source_index);
+    if (global)
+        w.i32(r.source_scene);
+}
+} // namespace
+
+unsigned int SurgePatch::save_binary_patch(void **data)
+{
+    BinaryWriter prms, rout, msgs, frml, wavt;
+    uint32_t nRecords = 0, nRoutings = 0;
+    int n = param_ptr.size();
+
+    prms.u32(0);
+    rout.u32(0);
+
+    for (int i = 0; i < n; i++)
+    {
+        auto *par = param_ptr[i];
+
+        // skip empty effects, as save_xml does
+        if (par->ctrlgroup == cg_FX && fx[par->ctrlgroup_entry].type.val.i == fxt_off)
+            continue;
+
+        std::string sn = par->get_storage_name();
+        prms.u16(sn.size());
+        prms.bytes(sn.data(), sn.size());
+
+        if (par->valtype == (valtypes)vt_float)
+        {
+            prms.u8(vt_float);
+            prms.f32(par->val.f);
+        }
+        else
+        {
+            prms.u8(vt_int);
+            prms.i32(par->valtype == (valtypes)vt_bool ? (par->val.b ? 1 : 0) : par->val.i);
+        }
+
+        // the same conditions save_xml writes each attribute under
+        uint16_t mask = 0;
+        mask |= par->temposync ? po_temposync : 0;
+        mask |= par->has_portaoptions() ? (po_portaConstRate | po_portaGliss | po_portaRetrigger |
+                                           po_portaCurve)
+                                        : 0;
+        mask |= par->has_deformoptions() ? po_deformType : 0;
+        mask |= par->can_deactivate() ? po_deactivated : 0;
+        mask |= (par->extend_range || par->can_extend_range()) ? po_extendRange : 0;
+        mask |= par->absolute ? po_absolute : 0;
+        prms.u16(mask);
+
+        if (mask & po_temposync)
+            prms.i32(1);
+        if (mask & po_portaConstRate)
+        {
+            prms.i32(par->porta_constrate);
+            prms.i32(par->porta_gliss);
+            prms.i32(par->porta_retrigger);
+            prms.i32(par->porta_curve);
+        }
+        if (mask & po_deformType)
+            prms.i32(par->deform_type);
+        if (mask & po_deactivated)
+            prms.i32(par->deactivated);
+        if (mask & po_extendRange)
+            prms.i32(par->extend_range);
+        if (mask & po_absolute)
+            prms.i32(1);
+
+        int s_id = par->scene;
+
+        if (s_id > 0)
+        {
+            for (auto *r : {&scene[s_id - 1].modulation_scene, &scene[s_id - 1].modulation_voice})
+            {
+                for (const auto &mr : *r)
+                {
+                    if (mr.destination_id == par->param_id_in_scene)
+                    {
+                        writeRouting(rout, nRecords, mr, false);
+                        nRoutings++;
+                    }
+                }
+            }
+        }
+        else
+        {
+            for (const auto &mr : modulation_global)
+            {
+                if (mr.destination_id == i)
+                {
+                    writeRouting(rout, nRecords, mr, true);
+                    nRoutings++;
+                }
+            }
+        }
+
+        nRecords++;
+    }
+
+    prms.patchU32(0, nRecords);
+    rout.patchU32(0, nRoutings);
+
+    uint32_t nMSEGs = 0, nFormulae = 0, nWavetables = 0;
+    msgs.u32(0);
+    frml.u32(0);
+    wavt.u32(0);
+
+    for (int sc = 0; sc < n_scenes; sc++)
+    {
+        for (int l = 0; l < n_lfos; l++)
+        {
+            if (scene[sc].lfo[l].shape.val.i == lt_mseg)
+            {
+                auto *ms = &msegs[sc][l];
+
+                msgs.u8(sc);
+                msgs.u8(l);
+                msgs.i32(ms->n_activeSegments);
+                msgs.i32(ms->endpointMode);
+                msgs.i32(ms->editMode);
+                msgs.i32(ms->loopMode);
+                msgs.i32(ms->loop_start);
+                msgs.i32(ms->loop_end);
+                msgs.f32(ms->hSnapDefault);
+                msgs.f32(ms->vSnapDefault);
+                msgs.f32(ms->hSnap);
+                msgs.f32(ms->vSnap);
+                msgs.f32(ms->axisWidth);
+                msgs.f32(ms->axisStart);
+
+                for (int s = 0; s < ms->n_activeSegments; ++s)
+                {
+                    const auto &seg = ms->segments[s];
+                    msgs.f32(seg.duration);
+                    msgs.f32(seg.v0);
+                    msgs.f32(seg.nv1);
+                    msgs.f32(seg.cpduration);
+                    msgs.f32(seg.cpv);
+                    msgs.u8(seg.type);
+                    msgs.u8(seg.useDeform | (seg.invertDeform << 1) | (seg.retriggerFEG << 2) |
+                            (seg.retriggerAEG << 3));
+                }
+
+                nMSEGs++;
+            }
+
+            if (scene[sc].lfo[l].shape.val.i == lt_formula)
+            {
+                frml.u8(sc);
+                frml.u8(l);
+                frml.i32(formulamods[sc][l].interpreter);
+                frml.str(formulamods[sc][l].formulaString);
+                nFormulae++;
+            }
+        }
+
+        for (int osc = 0; osc < n_oscs; osc++)
+        {
+            auto wtsize = streamed_wavetable_size(sc, osc);
+
+            if (wtsize)
+            {
+                wavt.u8(sc);
+                wavt.u8(osc);
+                wavt.u32(wtsize);
+                auto at = wavt.buf.size();
+                wavt.buf.resize(at + wtsize);
+                save_streamed_wavetable(sc, osc, wavt.buf.data() + at);
+                nWavetables++;
+            }
+        }
+    }
+
+    msgs.patchU32(0, nMSEGs);
+    frml.patchU32(0, nFormulae);
+    wavt.patchU32(0, nWavetables);
+
+    BinaryWriter xml;
+    void *xmldata = nullptr;
+    auto xmlsize = save_xml(&xmldata, true);
+    xml.bytes(xmldata, xmlsize);
+    free(xmldata);
+
+    BinaryWriter chunk;
+    chunk.tag("sub4");
+    chunk.u32(binaryChunkVersion);
+    chunk.u32(ff_revision);
+    chunk.u32(6);
+    chunk.section("xml ", xml);
+    chunk.section("prms", prms);
+    chunk.section("rout", rout);
+    chunk.section("msgs", msgs);
+    chunk.section("frml", frml);
+    chunk.section("wavt", wavt);
+
+    if (patchptr)
+        free(patchptr);
+    patchptr = malloc(chunk.buf.size());
+    memcpy(patchptr, chunk.buf.data(), chunk.buf.size());
+    *data = patchptr;
+
+    return chunk.buf.size();
+}
+
+void SurgePatch::load_binary_patch(const void *data, int datasize, bool preset)
+{
+    BinaryReader r((const char *)data, datasize);
+
+    r.bytes(4); // "sub4", checked by load_patch
+    auto version = r.u32();
+    r.u32(); // the revision which wrote it, the XML section carries the one load_xml uses
+    auto nSections = r.u32();
+
+    if (!r.ok || version > binaryChunkVersion)
+    {
+        std::cout << "Unable to read binary patch chunk version " << version << std::endl;
+        return;
+    }
+
+    BinarySections bs;
+    BinarySections::Section xml, wavt;
+
+    for (uint32_t s = 0; s < nSections && r.ok; ++s)
+    {
+        auto tag = r.bytes(4);
+        auto size = r.u32();
+        auto d = r.bytes(size);
+
+        if (!r.ok)
+            break;
+
+        BinarySections::Section sec{d, size};
+
+        if (!memcmp(tag, "xml ", 4))
+            xml = sec;
+        else if (!memcmp(tag, "prms", 4))
+            bs.parameters = sec;
+        else if (!memcmp(tag, "rout", 4))
+            bs.routing = sec;
+        else if (!memcmp(tag, "msgs", 4))
+            bs.msegs = sec;
+        else if (!memcmp(tag, "frml", 4))
+            bs.formulae = sec;
+        else if (!memcmp(tag, "wavt", 4))
+            wavt = sec;
+    }
+
+    if (!r.ok || !xml.data)
+    {
+        std::cout << "Truncated binary patch chunk" << std::endl;
+        return;
+    }
+
+    load_xml(xml.data, xml.size, preset, &bs);
+
+    BinaryReader w(wavt.data, wavt.size);
+    auto nWavetables = w.u32();
+
+    for (uint32_t t = 0; t < nWavetables && w.ok; ++t)
+    {
+        int sc = w.u8();
+        int osc = w.u8();
+        auto size = w.u32();
+        auto d = w.bytes(size);
+
+        if (d && sc < n_scenes && osc < n_oscs && streamedWavetableFits(d, size))
+        {
+            load_streamed_wavetable(sc, osc, d);
+        }
+        else if (d)
+        {
+            std::cout << "Skipping a corrupt wavetable in binary patch chunk" << std::endl;
+        }
+    }
+}
+
+void SurgePatch::restoreBinaryParameters(const BinarySections &bs, int revision, bool preset)
+{
+    // the routings come first so each parameter can be restored with its own in one go
+    BinaryReader rr(bs.routing.data, bs.routing.size);
+    auto nRoutings = rr.u32();
+
+    struct RecordRouting
+    {
+        uint32_t record;
+        StreamedParameter::Routing r;
+    };
+    std::vector<RecordRouting> routings;
+    routings.reserve(nRoutings);
+
+    for (uint32_t k = 0; k < nRoutings; ++k)
+    {
+        RecordRouting rt;
+        rt.record = rr.u32();
+        rt.r.source = rr.i32();
+        rt.r.depth = rr.f32();
+
+        auto mask = rr.u8();
+        if (mask & ro_muted)
+            rt.r.muted = rr.i32();
+        if (mask & ro_sourceIndex)
+            rt.r.sourceIndex = rr.i32();
+        if (mask & ro_sourceScene)
+            rt.r.sourceScene = rr.i32();
+
+        if (!rr.ok)
+            break;
+
+        routings.push_back(rt);
+    }
+
+    BinaryReader pr(bs.parameters.data, bs.parameters.size);
+    auto nRecords = pr.u32();
+
+    int n = param_ptr.size();
+    int next = 0;
+    size_t rIdx = 0;
+    StreamedParameter sp;
+
+    for (uint32_t k = 0; k < nRecords && pr.ok; ++k)
+    {
+        sp.clear();
+
+        auto nameLen = pr.u16();
+        auto name = pr.bytes(nameLen);
+
+        sp.hasType = true;
+        sp.type = pr.u8();
+        sp.hasValue = true;
+        if (sp.type == vt_float)
+            sp.f = pr.f32();
+        else
+            sp.i = pr.i32();
+
+        auto mask = pr.u16();
+        auto opt = [&pr, mask](int bit, std::optional<int> &to) {
+            if (mask & bit)
+                to = pr.i32();
+        };
+        opt(po_temposync, sp.temposync);
+        opt(po_portaConstRate, sp.portaConstRate);
+        opt(po_portaGliss, sp.portaGliss);
+        opt(po_portaRetrigger, sp.portaRetrigger);
+        opt(po_portaCurve, sp.portaCurve);
+        opt(po_deformType, sp.deformType);
+        opt(po_deactivated, sp.deactivated);
+        opt(po_extendRange, sp.extendRange);
+        opt(po_absolute, sp.absolute);
+
+        // routings are written in record order, so they are always the next ones in the list
+        while (rIdx < routings.size() && routings[rIdx].record < k)
+            rIdx++;
+        while (rIdx < routings.size() && routings[rIdx].record == k)
+            sp.routings.push_back(routings[rIdx++].r);
+
+        if (!pr.ok)
+            break;
+
+        // the records usually come in param_ptr order, so try the next one before searching
+        auto matches = [name, nameLen](const Parameter *p) {
+            auto sn = p->get_storage_name();
+            return strlen(sn) == nameLen && !memcmp(sn, name, nameLen);
+        };
+
+        int i = -1;
+
+        if (next < n && matches(param_ptr[next]))
+        {
+            i = next;
+        }
+        else
+        {
+            for (int q = 0; q < n && i < 0; ++q)
+            {
+                if (matches(param_ptr[q]))
+                    i = q;
+            }
+        }
+
+        if (i < 0)
+            continue;
+
+        next = i + 1;
+
+        // volume and fx_bypass should stick when loading a preset, see load_xml
+        if (preset && (param_ptr[i] == &fx_bypass || (revision < 17 && param_ptr[i] == &volume)))
+            continue;
+
+        restoreStreamedParameter(i, sp, revision);
+    }
+}
+
+void SurgePatch::restoreBinaryMSEGs(const BinarySections &bs, bool restoreSnaps)
+{
+    BinaryReader r(bs.msegs.data, bs.msegs.size);
+    auto nMSEGs = r.u32();
+
+    for (uint32_t m = 0; m < nMSEGs && r.ok; ++m)
+    {
+        int sc = r.u8();
+        int l = r.u8();
+        int nSegs = r.i32();
+
+        if (sc >= n_scenes || l >= n_lfos || nSegs < 0 || nSegs > max_msegs)
+            break;
+
+        auto *ms = &msegs[sc][l];
+
+        ms->n_activeSegments = nSegs;
+        ms->endpointMode = (MSEGStorage::EndpointMode)r.i32();
+        ms->editMode = (MSEGStorage::EditMode)r.i32();
+        ms->loopMode = (MSEGStorage::LoopMode)r.i32();
+        ms->loop_start = r.i32();
+        ms->loop_end = r.i32();
+        ms->hSnapDefault = r.f32();
+        ms->vSnapDefault = r.f32();
+
+        auto hSnap = r.f32();
+        auto vSnap = r.f32();
+
+        if (restoreSnaps)
+        {
+            ms->hSnap = hSnap;
+            ms->vSnap = vSnap;
+        }
+
+        ms->axisWidth = r.f32();
+        ms->axisStart = r.f32();
+
+        for (int s = 0; s < nSegs; ++s)
+        {
+            auto &seg = ms->segments[s];
+            seg.duration = r.f32();
+            seg.v0 = r.f32();
+            seg.nv1 = r.f32();
+            seg.cpduration = r.f32();
+            seg.cpv = r.f32();
+            seg.type = (MSEGStorage::segment::Type)r.u8();
+
+            auto flags = r.u8();
+            seg.useDeform = flags & 1;
+            seg.invertDeform = flags & 2;
+            seg.retriggerFEG = flags & 4;
+            seg.retriggerAEG = flags & 8;
+        }
+
+        Surge::MSEG::rebuildCache(ms);
+    }
+}
+
+void SurgePatch::restoreBinaryFormulae(const BinarySections &bs)
+{
+    BinaryReader r(bs.formulae.data, bs.formulae.size);
+    auto nFormulae = r.u32();
+
+    for (uint32_t f = 0; f < nFormulae && r.ok; ++f)
+    {
+        int sc = r.u8();
+        int l = r.u8();
+        auto interp = r.i32();
+        auto formula = r.str();
+
+        if (!r.ok || sc >= n_scenes || l >= n_lfos)
+            break;
+
+        formulamods[sc][l].setFormula(formula);
+        formulamods[sc][l].interpreter = (FormulaModulatorStorage::Interpreter)interp;
+    }
+}
@@ -0,0 +1,81 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_SURGEPATCHBINARY_H
+#define SURGE_SRC_COMMON_SURGEPATCHBINARY_H
+
+#include "SurgeStorage.h"
+
+#include <optional>
+#include <vector>
+
+/*
+ * One parameter as it was streamed, with only the attributes the stream actually had.
+ * The XML and the binary chunk both read into this and restore through
+ * SurgePatch::restoreStreamedParameter, so the two can't drift apart in how they treat
+ * missing attributes or old revisions.
+ */
+struct SurgePatch::StreamedParameter
+{
+    bool hasType{false};
+    int type{vt_float};
+
+    bool hasValue{false};
+    double f{0};
+    int i{0};
+
+    std::optional<int> temposync, portaConstRate, portaGliss, portaRetrigger, portaCurve,
+        deformType, deactivated, extendRange, absolute;
+
+    struct Routing
+    {
+        int source{0};
+        double depth{0};
+        std::optional<int> muted, sourceIndex, sourceScene;
+    };
+    std::vector<Routing> routings;
+
+    void clear()
+    {
+        auto r = std::move(routings);
+        r.clear();
+        *this = StreamedParameter();
+        routings = std::move(r);
+    }
+};
+
+/*
+ * The sections of a binary state chunk which load_xml restores in place of the XML sections
+ * they replace. They point into the chunk being loaded.
+ */
+struct SurgePatch::BinarySections
+{
+    struct Section
+    {
+        const char *data{nullptr};
+        size_t size{0};
+    };
+
+    Section parameters, routing, msegs, formulae;
+};
+
+#endif // SURGE_SRC_COMMON_SURGEPATCHBINARY_H
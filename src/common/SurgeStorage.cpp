@@ -50,6 +50,7 @@
 #include "FxPresetAndClipboardManager.h"
 #include "ModulatorPresetManager.h"
 #include "SurgeMemoryPools.h"
+#include "FactoryDataBundle.h"
 #include "sst/basic-blocks/tables/SincTableProvider.h"
 
 // FIXME probably remove this when we remove the hardcoded hack below
@@ -64,7 +65,97 @@ using namespace std;
 
 std::string SurgeStorage::skipPatchLoadDataPathSentinel = "<SKIP-PATCH-SENTINEL>";
 
-SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : otherscene_clients(0)
+#if STORAGE_USES_INDEPENDENT_RNG
+thread_local SurgeStorage::RNGGen *SurgeStorage::workerRNG{nullptr};
+#endif
+
+namespace Surge
+{
+namespace Storage
+{
+namespace tabl = sst::basic_blocks::tables;
+static_assert(tabl::SurgeSincTableProvider::FIRipol_M == FIRipol_M);
+static_assert(tabl::SurgeSincTableProvider::FIRipol_N == FIRipol_N);
+static_assert(tabl::SurgeSincTableProvider::FIRipolI16_N == FIRipolI16_N);
+
+/*
+ * Everything a storage needs which is the same for every instance in the process, built by
+ * the first storage that asks and shared by the rest: the tables which depend on neither
+ * the sample rate nor the tuning, the window oscillator's wavetable, and the scans of the
+ * factory patch and wavetable folders.
+ */
+struct SharedCore
+{
+    tabl::SurgeSincTableProvider sinc;
+
+    float table_dB alignas(16)[512];
+    float table_glide_exp alignas(16)[512], table_glide_log alignas(16)[512];
+    float table_two_to_the alignas(16)[1001];
+    float table_two_to_the_minus alignas(16)[1001];
+
+    Wavetable windowWT;
+    std::mutex windowWTMutex;
+    bool windowWTLoaded{false};
+
+    /*
+     * The factory folders only change when Surge is reinstalled, so each is scanned by the
+     * first storage to want it and copied from here by the others. The third party and user
+     * folders are still scanned every time, since people add to those while we run.
+     */
+    struct FolderScan
+    {
+        std::vector<Patch> items;
+        std::vector<PatchCategory> categories;
+    };
+    std::mutex folderScanMutex;
+    std::unordered_map<std::string, std::shared_ptr<const FolderScan>> folderScans;
+
+    SharedCore()
+    {
+        float _512th = 1.f / 512.f;
+
+        for (int i = 0; i < 512; i++)
+        {
+            table_dB[i] = powf(10.f, 0.05f * ((float)i - 384.f));
+            table_glide_log[i] = log2(1.0 + (i * _512th * 10.f)) / log2(1.f + 10.f);
+            table_glide_exp[511 - i] = 1.0 - table_glide_log[i];
+        }
+
+        for (int i = 0; i < 1001; ++i)
+        {
+            double twelths = i * 1.0 / 12.0 / 1000.0;
+            table_two_to_the[i] = pow(2.0, twelths);
+            table_two_to_the_minus[i] = pow(2.0, -twelths);
+        }
+    }
+
+    /*
+     * Like the shared worker pool, these go away with the last storage rather than at
+     * static destruction, so a host which loads and unloads us doesn't keep them around.
+     */
+    static std::shared_ptr<SharedCore> get()
+    {
+        static std::mutex sharedMutex;
+        static std::weak_ptr<SharedCore> shared;
+
+        std::lock_guard<std::mutex> g(sharedMutex);
+
+        auto res = shared.lock();
+        if (!res)
+        {
+            res = std::make_shared<SharedCore>();
+            shared = res;
+        }
+
+        return res;
+    }
+};
+} // namespace Storage
+} // namespace Surge
+
+SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config)
+    : sharedCore(Surge::Storage::SharedCore::get()), WindowWT(sharedCore->windowWT),
+      otherscene_clients(0)
 {
     auto suppliedDataPath = config.suppliedDataPath;
     bool loadWtAndPatch = true;
@@ -74,6 +165,15 @@ SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : oth
     if (suppliedDataPath == skipPatchLoadDataPathSentinel)
         suppliedDataPath = "";
 
+    sinctable = sharedCore->sinc.sinctable;
+    sinctable1X = sharedCore->sinc.sinctable1X;
+    sinctableI16 = sharedCore->sinc.sinctableI16;
+    table_dB = sharedCore->table_dB;
+    table_glide_exp = sharedCore->table_glide_exp;
+    table_glide_log = sharedCore->table_glide_log;
+    table_two_to_the = sharedCore->table_two_to_the;
+    table_two_to_the_minus = sharedCore->table_two_to_the_minus;
+
     if (samplerate == 0)
     {
         setSamplerate(48000);
@@ -93,15 +193,9 @@ SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : oth
     }
 
     _patch.reset(new SurgePatch(this));
-
-    namespace tabl = sst::basic_blocks::tables;
-    sincTableProvider = std::make_unique<tabl::SurgeSincTableProvider>();
-    static_assert(tabl::SurgeSincTableProvider::FIRipol_M == FIRipol_M);
-    static_assert(tabl::SurgeSincTableProvider::FIRipol_N == FIRipol_N);
-    static_assert(tabl::SurgeSincTableProvider::FIRipolI16_N == FIRipolI16_N);
-    sinctable = sincTableProvider->sinctable;
-    sinctable1X = sincTableProvider->sinctable1X;
-    sinctableI16 = sincTableProvider->sinctableI16;
+    // enough that the odd publish from the audio thread doesn't grow this there
+    modRoutingRetired.reserve(16);
+    publishModRouting();
 
     for (int s = 0; s < n_scenes; s++)
         for (int m = 0; m < n_modsources; ++m)
@@ -343,6 +437,9 @@ SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : oth
 
     load_midi_controllers();
 
+    factoryDataBundle = Surge::Storage::FactoryDataBundle::open(
+        datapath / Surge::Storage::FactoryDataBundle::defaultFileName);
+
     patchDB = std::make_unique<Surge::PatchStorage::PatchDB>(this);
     if (loadWtAndPatch)
     {
@@ -350,30 +447,46 @@ SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : oth
         refresh_patchlist();
     }
 
-#if HAS_JUCE
-    if (!load_wt_wt_mem(SurgeSharedBinary::windows_wt, SurgeSharedBinary::windows_wtSize,
-                        &WindowWT))
-    {
-        WindowWT.size = 0;
-        std::ostringstream oss;
-        oss << "Unable to load 'windows.wt' from memory. "
-            << "This is a fatal internal software error which should never occur!";
-        reportError(oss.str(), "Resource Loading Error");
-    }
-#else
-    if (fs::exists(datapath / "windows.wt"))
     {
-        if (!load_wt_wt(path_to_string(datapath / "windows.wt"), &WindowWT))
+        // WindowWT is the shared core's, so only the first storage loads it
+        std::lock_guard<std::mutex> g(sharedCore->windowWTMutex);
+
+        if (!sharedCore->windowWTLoaded)
         {
-            WindowWT.size = 0;
-            std::ostringstream oss;
-            oss << "Unable to load 'windows.wt' from file. "
-                << "This is a fatal internal software error which should never occur!";
-            reportError(oss.str(), "Resource Loading Error");
-            _DBGCOUT << oss.str() << std::endl;
+#if HAS_JUCE
+            if (!load_wt_wt_mem(SurgeSharedBinary::windows_wt, SurgeSharedBinary::windows_wtSize,
+                                &WindowWT))
+            {
+                WindowWT.size = 0;
+                std::ostringstream oss;
+                oss << "Unable to load 'windows.wt' from memory. "
+                    << "This is a fatal internal software error which should never occur!";
+                reportError(oss.str(), "Resource Loading Error");
+            }
+            else
+            {
+                sharedCore->windowWTLoaded = true;
+            }
+#else
+            if (fs::exists(datapath / "windows.wt"))
+            {
+                if (!load_wt_wt(path_to_string(datapath / "windows.wt"), &WindowWT))
+                {
+                    WindowWT.size = 0;
+                    std::ostringstream oss;
+                    oss << "Unable to load 'windows.wt' from file. "
+                        << "This is a fatal internal software error which should never occur!";
+                    reportError(oss.str(), "Resource Loading Error");
+                    _DBGCOUT << oss.str() << std::endl;
+                }
+                else
+                {
+                    sharedCore->windowWTLoaded = true;
+                }
+            }
+#endif
         }
     }
-#endif
 
     // Tuning library support
     currentScale = Tunings::evenTemperament12NoteScale();
@@ -640,12 +753,20 @@ struct PEComparer
     bool operator()(const Patch &a, const Patch &b) { return a.name.compare(b.name) < 0; }
 };
 
+static bool isPatchExtension(std::string s) { return _stricmp(s.c_str(), ".fxp") == 0; }
+
+static bool isWavetableExtension(std::string s)
+{
+    return _stricmp(s.c_str(), ".wt") == 0 || _stricmp(s.c_str(), ".wav") == 0;
+}
+
 void SurgeStorage::refresh_patchlist()
 {
     patch_category.clear();
     patch_list.clear();
 
-    refreshPatchlistAddDir(false, "patches_factory");
+    refreshFactoryListFromSharedCore("patches_factory", isPatchExtension, patch_list,
+                                     patch_category);
     firstThirdPartyCategory = patch_category.size();
 
     refreshPatchlistAddDir(false, "patches_3rdparty");
@@ -713,9 +834,14 @@ void SurgeStorage::refresh_patchlist()
     }
     for (auto &p : patch_list)
     {
-        auto qtime = fs::last_write_time(p.path);
-        p.lastModTime =
-            std::chrono::duration_cast<std::chrono::seconds>(qtime.time_since_epoch()).count();
+        // the shared factory scan has already done this for its patches
+        if (p.lastModTime == 0)
+        {
+            auto qtime = dataFileWriteTime(p.path);
+            p.lastModTime =
+                std::chrono::duration_cast<std::chrono::seconds>(qtime.time_since_epoch())
+                    .count();
+        }
 
         auto ps = p.path.u8string();
         auto pf = pathToTrunc(ps);
@@ -731,10 +857,121 @@ void SurgeStorage::refresh_patchlist()
 
 void SurgeStorage::refreshPatchlistAddDir(bool userDir, string subdir)
 {
-    refreshPatchOrWTListAddDir(
-        userDir, userDir ? userDataPath : datapath, subdir,
-        [](std::string s) -> bool { return _stricmp(s.c_str(), ".fxp") == 0; }, patch_list,
-        patch_category);
+    refreshPatchOrWTListAddDir(userDir, userDir ? userDataPath : datapath, subdir,
+                               isPatchExtension, patch_list, patch_category);
+}
+
+void SurgeStorage::refreshFactoryListFromSharedCore(const std::string &subdir,
+                                                    std::function<bool(std::string)> filterOp,
+                                                    std::vector<Patch> &items,
+                                                    std::vector<PatchCategory> &categories)
+{
+    auto key = path_to_string(datapath / subdir);
+    std::shared_ptr<const Surge::Storage::SharedCore::FolderScan> scan;
+
+    {
+        std::lock_guard<std::mutex> g(sharedCore->folderScanMutex);
+        auto f = sharedCore->folderScans.find(key);
+
+        if (f != sharedCore->folderScans.end())
+        {
+            scan = f->second;
+        }
+        else
+        {
+            auto s = std::make_shared<Surge::Storage::SharedCore::FolderScan>();
+            refreshPatchOrWTListAddDir(false, datapath, subdir, filterOp, s->items,
+                                       s->categories);
+
+            for (auto &p : s->items)
+            {
+                auto qtime = dataFileWriteTime(p.path);
+                p.lastModTime =
+                    std::chrono::duration_cast<std::chrono::seconds>(qtime.time_since_epoch())
+                        .count();
+            }
+
+            sharedCore->folderScans[key] = s;
+            scan = s;
+        }
+    }
+
+    // the scan numbers its categories from zero, so move them after what we already have
+    int offset = categories.size();
+
+    std::function<void(PatchCategory &)> renumber = [&renumber, offset](PatchCategory &c) {
+        c.internalid += offset;
+        for (auto &k : c.children)
+            renumber(k);
+    };
+
+    for (auto p : scan->items)
+    {
+        p.category += offset;
+        items.push_back(p);
+    }
+
+    for (auto c : scan->categories)
+    {
+        renumber(c);
+        categories.push_back(c);
+    }
+}
+
+void SurgeStorage::addFactoryDataBundleDir(const std::string &subdir,
+                                           std::function<bool(std::string)> filterOp,
+                                           int &category, std::vector<Patch> &items,
+                                           std::vector<PatchCategory> &categories)
+{
+    // each folder with a file in it, and the folders above those, keyed by the path below subdir
+    std::map<std::string, std::vector<std::string>> dirs;
+
+    for (const auto &f : factoryDataBundle->filesUnder(subdir))
+    {
+        auto rel = f.substr(subdir.size() + 1);
+        auto slash = rel.find_last_of('/');
+
+        // like the folder scan, files at the top of a factory folder aren't listed
+        if (slash == std::string::npos)
+            continue;
+
+        auto dir = rel.substr(0, slash);
+        auto fn = rel.substr(slash + 1);
+        auto dot = fn.find_last_of('.');
+        auto xtn = dot == std::string::npos ? std::string() : fn.substr(dot);
+
+        auto &files = dirs[dir];
+        if (filterOp(xtn))
+            files.push_back(fn);
+
+        for (auto s = dir.find('/'); s != std::string::npos; s = dir.find('/', s + 1))
+            dirs[dir.substr(0, s)];
+    }
+
+    for (const auto &[dir, files] : dirs)
+    {
+        PatchCategory c;
+        c.name = dir;
+        std::replace(c.name.begin(), c.name.end(), '/', PATH_SEPARATOR);
+        c.internalid = category;
+        c.isFactory = true;
+        c.numberOfPatchesInCatgory = 0;
+
+        for (const auto &fn : files)
+        {
+            Patch e;
+            e.category = category;
+            e.path = (datapath / string_to_path(subdir + "/" + dir + "/" + fn)).make_preferred();
+            e.name = fn.substr(0, fn.find_last_of('.'));
+            items.push_back(e);
+
+            c.numberOfPatchesInCatgory++;
+        }
+
+        c.numberOfPatchesInCategoryAndChildren = c.numberOfPatchesInCatgory;
+        categories.push_back(c);
+        category++;
+    }
 }
 
 void SurgeStorage::refreshPatchOrWTListAddDir(bool userDir, const fs::path &initialPatchPath,
@@ -754,78 +991,87 @@ void SurgeStorage::refreshPatchOrWTListAddDir(bool userDir, const fs::path &init
         if (!subdir.empty())
             patchpath /= subdir;
 
-        if (!fs::is_directory(patchpath))
+        // an installed factory data bundle stands in for the folders it holds, which installs
+        // shipping it leave out apart from the odd document sitting beside the data
+        if (!userDir && factoryDataBundle && initialPatchPath == datapath &&
+            !factoryDataBundle->filesUnder(subdir).empty())
+        {
+            addFactoryDataBundleDir(subdir, filterOp, category, items, local_categories);
+        }
+        else if (!fs::is_directory(patchpath))
         {
             return;
         }
-
-        /*
-        ** std::filesystem has a recursive_directory_iterator, but between the
-        ** hand rolled ipmmlementation on mac, experimental on windows, and
-        ** ostensibly standard on linux it isn't consistent enough to warrant
-        ** using yet, so build my own recursive directory traversal with a simple
-        ** stack
-        */
-        std::vector<fs::path> alldirs;
-        if (userDir)
-            alldirs.push_back(patchpath);
-        std::deque<fs::path> workStack;
-        workStack.push_back(patchpath);
-        while (!workStack.empty())
-        {
-            auto top = workStack.front();
-            workStack.pop_front();
-            for (auto &d : fs::directory_iterator(top))
+        else
+        {
+            /*
+            ** std::filesystem has a recursive_directory_iterator, but between the
+            ** hand rolled ipmmlementation on mac, experimental on windows, and
+            ** ostensibly standard on linux it isn't consistent enough to warrant
+            ** using yet, so build my own recursive directory traversal with a simple
+            ** stack
+            */
+            std::vector<fs::path> alldirs;
+            if (userDir)
+                alldirs.push_back(patchpath);
+            std::deque<fs::path> workStack;
+            workStack.push_back(patchpath);
+            while (!workStack.empty())
             {
-                if (fs::is_directory(d))
+                auto top = workStack.front();
+                workStack.pop_front();
+                for (auto &d : fs::directory_iterator(top))
                 {
-                    alldirs.push_back(d);
-                    workStack.push_back(d);
+                    if (fs::is_directory(d))
+                    {
+                        alldirs.push_back(d);
+                        workStack.push_back(d);
+                    }
                 }
             }
-        }
-
-        /*
-        ** We want to remove parent directory /user/foo or c:\\users\\bar\\
-        ** with a substr in the main loop, so get the length once
-        */
-        auto patchpathStr(path_to_string(patchpath));
-        auto patchpathSubstrLength = patchpathStr.size() + 1;
-        if (patchpathStr.back() == '/' || patchpathStr.back() == '\\')
-            patchpathSubstrLength--;
-
-        for (auto &p : alldirs)
-        {
-            PatchCategory c;
-            auto name = std::string("_Unsorted");
-            auto pn = path_to_string(p);
-            if (pn.size() > patchpathSubstrLength)
-                name = pn.substr(patchpathSubstrLength);
-
-            c.name = name;
-            c.internalid = category;
-            c.isFactory = !userDir;
 
-            c.numberOfPatchesInCatgory = 0;
-            for (auto &f : fs::directory_iterator(p))
+            /*
+            ** We want to remove parent directory /user/foo or c:\\users\\bar\\
+            ** with a substr in the main loop, so get the length once
+            */
+            auto patchpathStr(path_to_string(patchpath));
+            auto patchpathSubstrLength = patchpathStr.size() + 1;
+            if (patchpathStr.back() == '/' || patchpathStr.back() == '\\')
+                patchpathSubstrLength--;
+
+            for (auto &p : alldirs)
             {
-                std::string xtn = path_to_string(f.path().extension());
-                if (filterOp(xtn))
+                PatchCategory c;
+                auto name = std::string("_Unsorted");
+                auto pn = path_to_string(p);
+                if (pn.size() > patchpathSubstrLength)
+                    name = pn.substr(patchpathSubstrLength);
+
+                c.name = name;
+                c.internalid = category;
+                c.isFactory = !userDir;
+
+                c.numberOfPatchesInCatgory = 0;
+                for (auto &f : fs::directory_iterator(p))
                 {
-                    Patch e;
-                    e.category = category;
-                    e.path = f.path();
-                    e.name = path_to_string(f.path().filename());
-                    e.name = e.name.substr(0, e.name.size() - xtn.length());
-                    items.push_back(e);
-
-                    c.numberOfPatchesInCatgory++;
+                    std::string xtn = path_to_string(f.path().extension());
+                    if (filterOp(xtn))
+                    {
+                        Patch e;
+                        e.category = category;
+                        e.path = f.path();
+                        e.name = path_to_string(f.path().filename());
+                        e.name = e.name.substr(0, e.name.size() - xtn.length());
+                        items.push_back(e);
+
+                        c.numberOfPatchesInCatgory++;
+                    }
                 }
-            }
 
-            c.numberOfPatchesInCategoryAndChildren = c.numberOfPatchesInCatgory;
-            local_categories.push_back(c);
-            category++;
+                c.numberOfPatchesInCategoryAndChildren = c.numberOfPatchesInCatgory;
+                local_categories.push_back(c);
+                category++;
+            }
         }
     }
     catch (const fs::filesystem_error &e)
@@ -919,7 +1165,7 @@ void SurgeStorage::refresh_wtlist()
     wt_category.clear();
     wt_list.clear();
 
-    refresh_wtlistAddDir(false, "wavetables");
+    refreshFactoryListFromSharedCore("wavetables", isWavetableExtension, wt_list, wt_category);
 
     firstThirdPartyWTCategory = wt_category.size();
     if (extraThirdPartyWavetablesPath.empty() ||
@@ -1028,21 +1274,7 @@ void SurgeStorage::refresh_wtlistAddDir(bool userDir, const std::string &subdir)
 
 void SurgeStorage::refresh_wtlistFrom(bool isUser, const fs::path &p, const std::string &subdir)
 {
-    std::vector<std::string> supportedTableFileTypes;
-    supportedTableFileTypes.push_back(".wt");
-    supportedTableFileTypes.push_back(".wav");
-
-    refreshPatchOrWTListAddDir(
-        isUser, p, subdir,
-        [supportedTableFileTypes](std::string in) -> bool {
-            for (auto q : supportedTableFileTypes)
-            {
-                if (_stricmp(q.c_str(), in.c_str()) == 0)
-                    return true;
-            }
-            return false;
-        },
-        wt_list, wt_category);
+    refreshPatchOrWTListAddDir(isUser, p, subdir, isWavetableExtension, wt_list, wt_category);
 }
 
 void SurgeStorage::perform_queued_wtloads()
@@ -1089,6 +1321,53 @@ void SurgeStorage::perform_queued_wtloads()
     }
 }
 
+bool SurgeStorage::findInFactoryDataBundle(const fs::path &p, const char *&data,
+                                           size_t &size) const
+{
+    if (!factoryDataBundle)
+        return false;
+
+    auto rel = p.lexically_relative(datapath).generic_string();
+    if (rel.empty() || rel.rfind("..", 0) == 0)
+        return false;
+
+    return factoryDataBundle->find(rel, data, size);
+}
+
+std::unique_ptr<std::streambuf> SurgeStorage::openDataFileForRead(const fs::path &p) const
+{
+    const char *data;
+    size_t size;
+
+    if (findInFactoryDataBundle(p, data, size))
+        return std::make_unique<Surge::Storage::FactoryDataBundle::StreamBuf>(data, size);
+
+    auto f = std::make_unique<std::filebuf>();
+    if (!f->open(p, std::ios::binary | std::ios::in))
+        return nullptr;
+
+    return f;
+}
+
+bool SurgeStorage::dataFileExists(const fs::path &p) const
+{
+    const char *data;
+    size_t size;
+
+    return findInFactoryDataBundle(p, data, size) || fs::exists(p);
+}
+
+fs::file_time_type SurgeStorage::dataFileWriteTime(const fs::path &p) const
+{
+    const char *data;
+    size_t size;
+
+    if (findInFactoryDataBundle(p, data, size))
+        return factoryDataBundle->writeTime();
+
+    return fs::last_write_time(p);
+}
+
 void SurgeStorage::load_wt(int id, Wavetable *wt, OscillatorStorage *osc)
 {
     wt->current_id = id;
@@ -1175,9 +1454,9 @@ void SurgeStorage::load_wt(string filename, Wavetable *wt, OscillatorStorage *os
 
 bool SurgeStorage::load_wt_wt(string filename, Wavetable *wt)
 {
-    std::filebuf f;
+    auto f = openDataFileForRead(string_to_path(filename));
 
-    if (!f.open(string_to_path(filename), std::ios::binary | std::ios::in))
+    if (!f)
     {
         return false;
     }
@@ -1186,7 +1465,7 @@ bool SurgeStorage::load_wt_wt(string filename, Wavetable *wt)
 
     memset(&wh, 0, sizeof(wt_header));
 
-    size_t read = f.sgetn(reinterpret_cast<char *>(&wh), sizeof(wh));
+    size_t read = f->sgetn(reinterpret_cast<char *>(&wh), sizeof(wh));
 
     if (!(wh.tag[0] == 'v' && wh.tag[1] == 'a' && wh.tag[2] == 'w' && wh.tag[3] == 't'))
     {
@@ -1208,7 +1487,7 @@ bool SurgeStorage::load_wt_wt(string filename, Wavetable *wt)
     }
 
     const std::unique_ptr<char[]> data{new char[ds]};
-    read = f.sgetn(data.get(), ds);
+    read = f->sgetn(data.get(), ds);
 
     if (read != ds)
     {
@@ -1855,6 +2134,7 @@ void SurgeStorage::clipboard_paste(int type, int scene, int entry, modsources ms
         }
     }
 
+    publishModRouting();
     modRoutingMutex.unlock();
 }
 
@@ -2001,6 +2281,75 @@ SurgeStorage::~SurgeStorage()
 
     deinitialize_oddsound();
 #endif
+
+    delete modRoutingPublished.exchange(nullptr);
+    for (auto *r : modRoutingRetired)
+        delete r;
+    modRoutingRetired.clear();
+}
+
+void SurgeStorage::publishModRouting()
+{
+    std::lock_guard<std::recursive_mutex> g(modRoutingMutex);
+
+    auto *next = new ModRoutingSnapshot();
+    next->global = getPatch().modulation_global;
+    for (int s = 0; s < n_scenes; ++s)
+    {
+        next->scene[s] = getPatch().scene[s].modulation_scene;
+        next->voice[s] = getPatch().scene[s].modulation_voice;
+    }
+
+    auto *prior = modRoutingPublished.exchange(next);
+
+    if (!prior)
+    {
+        // first publish; nothing has been pinned yet so pin this one for the audio thread
+        modRoutingInUse.store(next);
+        return;
+    }
+
+    modRoutingRetired.push_back(prior);
+
+    if (std::this_thread::get_id() != modRoutingReader.load(std::memory_order_relaxed))
+        freeRetiredModRouting();
+}
+
+void SurgeStorage::freeRetiredModRouting()
+{
+    std::lock_guard<std::recursive_mutex> g(modRoutingMutex);
+
+    // Anything retired which the audio thread isn't holding can go. If the audio thread is
+    // mid-acquire of a retired snapshot its validation load sees the newer one and it retries.
+    auto *pinned = modRoutingInUse.load();
+    auto it = modRoutingRetired.begin();
+    while (it != modRoutingRetired.end())
+    {
+        if (*it != pinned)
+        {
+            delete *it;
+            it = modRoutingRetired.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+const SurgeStorage::ModRoutingSnapshot *SurgeStorage::acquireModRouting()
+{
+    modRoutingReader.store(std::this_thread::get_id(), std::memory_order_relaxed);
+
+    auto *p = modRoutingPublished.load();
+    while (true)
+    {
+        modRoutingInUse.store(p);
+        auto *check = modRoutingPublished.load();
+        if (check == p)
+            return p;
+        p = check;
+    }
 }
 
 double shafted_tanh(double x) { return (exp(x) - exp(-x * 1.2)) / (exp(x) + exp(-x)); }
@@ -2009,11 +2358,9 @@ void SurgeStorage::init_tables()
 {
     isStandardTuning = true;
     float db60 = powf(10.f, 0.05f * -60.f);
-    float _512th = 1.f / 512.f;
 
     for (int i = 0; i < tuning_table_size; i++)
     {
-        table_dB[i] = powf(10.f, 0.05f * ((float)i - 384.f));
         table_pitch[i] = powf(2.f, ((float)i - 256.f) * (1.f / 12.f));
         table_pitch_ignoring_tuning[i] = table_pitch[i];
         table_pitch_inv[i] = 1.f / table_pitch[i];
@@ -2027,15 +2374,6 @@ void SurgeStorage::init_tables()
         double k = dsamplerate_os * pow(2.0, (((double)i - 256.0) / 16.0)) / (double)BLOCK_SIZE_OS;
         table_envrate_linear[i] = (float)(1.f / k);
         table_envrate_lpf[i] = (float)(1.f - exp(log(db60) / k));
-        table_glide_log[i] = log2(1.0 + (i * _512th * 10.f)) / log2(1.f + 10.f);
-        table_glide_exp[511 - i] = 1.0 - table_glide_log[i];
-    }
-
-    for (int i = 0; i < 1001; ++i)
-    {
-        double twelths = i * 1.0 / 12.0 / 1000.0;
-        table_two_to_the[i] = pow(2.0, twelths);
-        table_two_to_the_minus[i] = pow(2.0, -twelths);
     }
 
     // include some margin for error (and to avoid denormals in IIR filter clamping)
@@ -44,6 +44,7 @@
 #include <utility>
 #include <random>
 #include <chrono>
+#include <thread>
 
 #include "Tunings.h"
 #include "PatchDB.h"
@@ -795,6 +796,31 @@ struct MSEGStorage
     float durationLoopStartToLoopEnd;
     float envelopeModeDuration = -1, envelopeModeNV1 = -2; // -2 as sentinel since NV1 is -1/1
 
+    /*
+     * Evaluation acceleration tables, also built by rebuildCache. timeLookup maps a uniform
+     * grid over [0, totalDuration) to the first segment ending at or after that grid point,
+     * so finding the segment for a phase is a table read and a short walk rather than a scan
+     * of every segment. The per-segment shape values only depend on the control point, so we
+     * solve them once here rather than on every valueAt call. cachedSegments records how many
+     * segments the tables were built for; if it doesn't match n_activeSegments (which happens
+     * mid-edit, before the cache is rebuilt) the evaluator ignores the tables.
+     */
+    static constexpr int timeLookupSize = 256;
+    static_assert(max_msegs <= 256, "timeLookup stores segment indices as uint8_t");
+    std::array<uint8_t, timeLookupSize> timeLookup{};
+    double timeLookupScale = 0;
+    int cachedSegments = -1;
+
+    struct segmentShape
+    {
+        // the cpv and type the shape was solved for, so a stale entry is never used
+        float cpv = 0;
+        segment::Type type = segment::RESERVED;
+        float cpCurve = 0; // exponent bending linear and s-curve segments through the cp
+        int steps = 0;     // oscillation or step count for the periodic and stair types
+    };
+    std::array<segmentShape, max_msegs> shapeCache{};
+
     /*
      * These "UI" type things we decided, late in 1.8, are actually a critical part of
      * the modelling experience, so even if they aren't required to actually evaluate
@@ -963,8 +989,13 @@ class SurgePatch
     // load/save
     // void load_xml();
     // void save_xml();
-    void load_xml(const void *data, int size, bool preset);
-    unsigned int save_xml(void **data);
+    struct StreamedParameter;
+    struct BinarySections;
+
+    void load_xml(const void *data, int size, bool preset,
+                  const BinarySections *binary = nullptr);
+    // forBinaryChunk leaves out what the binary chunk carries itself
+    unsigned int save_xml(void **data, bool forBinaryChunk = false);
     unsigned int save_RIFF(void **data);
 
     // Factor these so the LFO preset mechanism can use them as well
@@ -976,7 +1007,26 @@ class SurgePatch
     void formulaFromXMLElement(FormulaModulatorStorage *ms, TiXmlElement *parent) const;
 
     void load_patch(const void *data, int size, bool preset);
-    unsigned int save_patch(void **data);
+    unsigned int save_patch(void **data, bool binary = false);
+
+    /*
+     * The "sub4" chunk: the same state as a "sub3" one, but with the parameters, routings,
+     * MSEGs and formulae stored as compact binary tables instead of XML. See
+     * SurgePatchBinary.cpp. Older versions of Surge can't read it, so we only write it
+     * for DAW state when asked to.
+     */
+    unsigned int save_binary_patch(void **data);
+    void load_binary_patch(const void *data, int size, bool preset);
+
+    void restoreStreamedParameter(int i, const StreamedParameter &sp, int revision);
+    void restoreBinaryParameters(const BinarySections &bs, int revision, bool preset);
+    void restoreBinaryMSEGs(const BinarySections &bs, bool restoreSnaps);
+    void restoreBinaryFormulae(const BinarySections &bs);
+
+    void load_streamed_wavetable(int scene, int osc, const char *data);
+    unsigned int streamed_wavetable_size(int scene, int osc) const;
+    void save_streamed_wavetable(int scene, int osc, char *data) const;
+
     Parameter *parameterFromOSCName(std::string stName);
 
     // data
@@ -1062,10 +1112,10 @@ struct Patch
 {
     std::string name;
     fs::path path;
-    uint64_t lastModTime;
-    int category;
-    int order;
-    bool isFavorite;
+    uint64_t lastModTime{0};
+    int category{0};
+    int order{0};
+    bool isFavorite{false};
 };
 
 struct PatchCategory
@@ -1093,6 +1143,7 @@ enum surge_copysource
 };
 
 class MTSClient;
+struct VocoderAnalysisCache;
 
 /* storage layer */
 
@@ -1102,6 +1153,8 @@ namespace Storage
 {
 struct FxUserPreset;
 struct ModulatorPreset;
+struct SharedCore;
+class FactoryDataBundle;
 } // namespace Storage
 namespace Memory
 {
@@ -1113,11 +1166,6 @@ struct GlobalData;
 }
 } // namespace Surge
 
-namespace sst::basic_blocks::tables
-{
-struct SurgeSincTableProvider;
-}
-
 class alignas(16) SurgeStorage
 {
   public:
@@ -1126,13 +1174,28 @@ class alignas(16) SurgeStorage
     // this will be a pointer to an aligned 2 x BLOCK_SIZE_OS array
     float audio_otherscene alignas(16)[2][BLOCK_SIZE_OS];
 
-    std::unique_ptr<sst::basic_blocks::tables::SurgeSincTableProvider> sincTableProvider;
+    /*
+     * The synth numbers its blocks from 1, so that effects can tell whether something another
+     * effect left for them was made this block. Where nothing numbers them (Surge XT Effects)
+     * it stays 0, meaning don't share.
+     */
+    uint64_t blockNumber{0};
+    // Where vocoders analysing audio_in with the same settings share the work; only the synth
+    // makes one
+    std::shared_ptr<VocoderAnalysisCache> vocoderAnalysis;
+
+    /*
+     * What is the same for every instance (the tables which depend on neither the sample rate
+     * nor the tuning, WindowWT and the factory folder scans) is built once per process, the
+     * first time a storage asks for it, and shared by every instance. The pointers below all
+     * point into that single copy.
+     */
+    std::shared_ptr<Surge::Storage::SharedCore> sharedCore;
     float *sinctable, *sinctable1X;
     int16_t *sinctableI16;
 
-    float table_dB alignas(16)[512], table_envrate_lpf alignas(16)[512],
-        table_envrate_linear alignas(16)[512], table_glide_exp alignas(16)[512],
-        table_glide_log alignas(16)[512];
+    const float *table_dB, *table_glide_exp, *table_glide_log;
+    float table_envrate_lpf alignas(16)[512], table_envrate_linear alignas(16)[512];
     float samplerate{0}, samplerate_inv{1};
     double dsamplerate{0}, dsamplerate_inv{1};
     double dsamplerate_os{0}, dsamplerate_os_inv{1};
@@ -1219,8 +1282,7 @@ class alignas(16) SurgeStorage
     float table_pitch_inv_ignoring_tuning alignas(16)[tuning_table_size];
     float table_note_omega_ignoring_tuning alignas(16)[2][tuning_table_size];
     // 2^0 -> 2^+/-1/12th. See comment in note_to_pitch
-    float table_two_to_the alignas(16)[1001];
-    float table_two_to_the_minus alignas(16)[1001];
+    const float *table_two_to_the, *table_two_to_the_minus;
 
     ~SurgeStorage();
 
@@ -1264,14 +1326,33 @@ class alignas(16) SurgeStorage
     void refresh_wtlistFrom(bool isUser, const fs::path &from, const std::string &subdir);
     void refresh_patchlist();
     void refreshPatchlistAddDir(bool userDir, std::string subdir);
+    // Adds a factory folder from the shared core's scan of it, scanning it there if need be
+    void refreshFactoryListFromSharedCore(const std::string &subdir,
+                                          std::function<bool(std::string)> filterOp,
+                                          std::vector<Patch> &items,
+                                          std::vector<PatchCategory> &categories);
 
     void refreshPatchOrWTListAddDir(bool userDir, const fs::path &fromPath, std::string subdir,
                                     std::function<bool(std::string)> filterOp,
                                     std::vector<Patch> &items,
                                     std::vector<PatchCategory> &categories);
+    // The same for a factory folder which only the factory data bundle holds
+    void addFactoryDataBundleDir(const std::string &subdir,
+                                 std::function<bool(std::string)> filterOp, int &category,
+                                 std::vector<Patch> &items, std::vector<PatchCategory> &categories);
 
     void perform_queued_wtloads();
 
+    /*
+     * Files under the data path come straight out of the mapped factory data bundle when
+     * there is one and it has them. openDataFileForRead falls back to the file itself and
+     * returns nullptr if neither is there.
+     */
+    bool findInFactoryDataBundle(const fs::path &p, const char *&data, size_t &size) const;
+    std::unique_ptr<std::streambuf> openDataFileForRead(const fs::path &p) const;
+    bool dataFileExists(const fs::path &p) const;
+    fs::file_time_type dataFileWriteTime(const fs::path &p) const;
+
     void load_wt(int id, Wavetable *wt, OscillatorStorage *);
     void load_wt(std::string filename, Wavetable *wt, OscillatorStorage *);
     bool load_wt_wt(std::string filename, Wavetable *wt);
@@ -1311,6 +1392,7 @@ class alignas(16) SurgeStorage
 
     bool datapathOverriden{false};
     fs::path datapath;
+    std::shared_ptr<Surge::Storage::FactoryDataBundle> factoryDataBundle;
     fs::path userDefaultFilePath;
     fs::path userDataPath;
     fs::path userPatchesPath;
@@ -1329,7 +1411,45 @@ class alignas(16) SurgeStorage
 
     std::mutex waveTableDataMutex;
     std::recursive_mutex modRoutingMutex;
-    Wavetable WindowWT;
+
+    /*
+     * The audio thread never reads the patch modulation vectors directly. Whoever edits
+     * modulation_global/_scene/_voice does so holding modRoutingMutex and then calls
+     * publishModRouting(), which copies the vectors into a fresh immutable snapshot and swaps
+     * it in. The audio thread pins the current snapshot with acquireModRouting() once per
+     * block (a single hazard pointer). Superseded snapshots are freed once the audio thread
+     * is no longer pinning them, by freeRetiredModRouting() or by a later publish from any
+     * other thread. A publish from the audio thread itself (a patch or FX load) only retires
+     * the old snapshot, so the housekeeping timer does that delete instead.
+     */
+    struct ModRoutingSnapshot
+    {
+        std::vector<ModulationRouting> global;
+        std::vector<ModulationRouting> scene[n_scenes], voice[n_scenes];
+    };
+    void publishModRouting();
+    const ModRoutingSnapshot *acquireModRouting();
+    void freeRetiredModRouting();
+    size_t retiredModRoutingCount()
+    {
+        std::lock_guard<std::recursive_mutex> g(modRoutingMutex);
+        return modRoutingRetired.size();
+    }
+    // the snapshot pinned by the last acquireModRouting(); audio thread only
+    const ModRoutingSnapshot *currentModRouting() const
+    {
+        return modRoutingInUse.load(std::memory_order_relaxed);
+    }
+
+  private:
+    std::atomic<ModRoutingSnapshot *> modRoutingPublished{nullptr}, modRoutingInUse{nullptr};
+    std::vector<ModRoutingSnapshot *> modRoutingRetired;
+    // whoever last called acquireModRouting, which is to say the audio thread
+    std::atomic<std::thread::id> modRoutingReader{};
+
+  public:
+    // the shared core's, and so the same one for every instance; treat it as read only
+    Wavetable &WindowWT;
 
     // hardclip
     enum HardClipMode
@@ -1614,30 +1734,50 @@ class alignas(16) SurgeStorage
 #define runningOnAudioThread() (void *)0;
 #endif
     /*
-     * These API points are only thread safe on the AUDIO thread.
-     * If you want to have an independent RNG on another thread, manage
+     * Threads doing audio work on behalf of the audio thread (see RealtimeWorkerPool)
+     * point this at a generator of their own, so they never race the audio thread on
+     * rngGen.
+     */
+    static thread_local RNGGen *workerRNG;
+    inline RNGGen &rng() { return workerRNG ? *workerRNG : rngGen; }
+
+    // Points rand() and friends on this thread at a given generator while in scope
+    struct ScopedRNG
+    {
+        explicit ScopedRNG(RNGGen &g) : prior(workerRNG) { workerRNG = &g; }
+        ~ScopedRNG() { workerRNG = prior; }
+        RNGGen *prior;
+    };
+
+    /*
+     * These API points are only thread safe on the AUDIO thread, or a worker set up
+     * as above. If you want to have an independent RNG on another thread, manage
      * your lifecycle yourself or if you want make a new instance of the
      * Storage::RNGGen utility class above
      */
     inline int rand()
     {
         runningOnAudioThread();
-        return rngGen.d(rngGen.g);
+        auto &r = rng();
+        return r.d(r.g);
     }
     inline uint32_t rand_u32()
     {
         runningOnAudioThread();
-        return rngGen.u32(rngGen.g);
+        auto &r = rng();
+        return r.u32(r.g);
     }
     inline float rand_pm1()
     {
         runningOnAudioThread();
-        return rngGen.pm1(rngGen.g);
+        auto &r = rng();
+        return r.pm1(r.g);
     }
     inline float rand_01()
     {
         runningOnAudioThread();
-        return rngGen.z1(rngGen.g);
+        auto &r = rng();
+        return r.z1(r.g);
     }
 // void seed_rand(int s) { rngGen.g.seed(s); }
 #else
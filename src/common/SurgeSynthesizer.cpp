@@ -30,6 +30,7 @@
 #include "UserDefaults.h"
 #include "filesystem/import.h"
 #include "Effect.h"
+#include "VocoderEffect.h"
 #include "globals.h"
 
 #include <algorithm>
@@ -51,10 +52,7 @@ namespace sdsp = sst::basic_blocks::dsp;
 using CMSKey = ControllerModulationSourceVector<1>; // sigh see #4286 for failed first try
 
 SurgeSynthesizer::SurgeSynthesizer(PluginLayer *parent, const std::string &suppliedDataPath)
-    : storage(suppliedDataPath), hpA{&storage, &storage, &storage, &storage}, hpB{&storage,
-                                                                                  &storage,
-                                                                                  &storage,
-                                                                                  &storage},
+    : storage(suppliedDataPath), hpA(&storage), hpB(&storage),
       _parent(parent), halfbandA(6, true), halfbandB(6, true), halfbandIN(6, true)
 {
     switch_toggled_queued = false;
@@ -66,6 +64,7 @@ SurgeSynthesizer::SurgeSynthesizer(PluginLayer *parent, const std::string &suppl
     release_anyway[1] = false;
     load_fx_needed = true;
     process_input = false; // hosts set this if there are input busses
+    storage.vocoderAnalysis = std::make_shared<VocoderAnalysisCache>();
 
     fx_suspend_bitmask = 0;
 
@@ -95,6 +94,7 @@ SurgeSynthesizer::SurgeSynthesizer(PluginLayer *parent, const std::string &suppl
         fxsync[i] = storage.getPatch().fx[i];
         fx_reload[i] = false;
         fx_reload_mod[i] = false;
+        fxRNG[i].g.seed(i + 1);
     }
 
     allNotesOff();
@@ -294,6 +294,34 @@ SurgeSynthesizer::SurgeSynthesizer(PluginLayer *parent, const std::string &suppl
     has_patchid_file = false;
 }
 
+void SurgeSynthesizer::setProcessFXInParallel(bool b)
+{
+    // the caller runs one chain itself, and fxWorkers never changes once the audio thread
+    // can see it
+    if (b && !fxWorkers)
+    {
+        fxWorkers = RealtimeWorkerPool::shared(maxParallelFXChains - 1, []() {
+            static thread_local SurgeStorage::RNGGen workerGen;
+            SurgeStorage::workerRNG = &workerGen;
+        });
+    }
+
+    processFXInParallel.store(b, std::memory_order_release);
+}
+
+void SurgeSynthesizer::processFXTasks(int n, RealtimeWorkerPool::task_t task, void *context)
+{
+    if (processFXInParallel.load(std::memory_order_acquire) && fxWorkers)
+    {
+        fxWorkers->parallelFor(n, task, context, workerPriority);
+    }
+    else
+    {
+        for (int i = 0; i < n; ++i)
+            task(context, i);
+    }
+}
+
 SurgeSynthesizer::~SurgeSynthesizer()
 {
     {
@@ -306,6 +334,9 @@ SurgeSynthesizer::~SurgeSynthesizer()
             patchLoadThread->join();
     }
 
+    delete enqueuedLoad.exchange(nullptr);
+    freeSpentLoads();
+
     allNotesOff();
 
     for (int sc = 0; sc < n_scenes; sc++)
@@ -791,6 +822,7 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
                                         &channelState[mpeMainChannel], &channelState[channel],
                                         mpeEnabled, voiceCounter++, host_noteid,
                                         host_originating_key, host_originating_channel, 0.f, 0.f);
+                nvoice->startOffset = eventSampleOffset;
             }
         }
         break;
@@ -929,6 +961,7 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
                         &channelState[channel].keyState[key], &channelState[mpeMainChannel],
                         &channelState[channel], mpeEnabled, voiceCounter++, host_noteid,
                         host_originating_key, host_originating_channel, aegReuse, fegReuse);
+                    nvoice->startOffset = eventSampleOffset;
                 }
             }
         }
@@ -1062,6 +1095,7 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
                         &channelState[channel].keyState[key], &channelState[mpeMainChannel],
                         &channelState[channel], mpeEnabled, voiceCounter++, host_noteid,
                         host_originating_key, host_originating_channel, aegStart, fegStart);
+                    nvoice->startOffset = eventSampleOffset;
                 }
             }
             else
@@ -1109,13 +1143,10 @@ void SurgeSynthesizer::releaseScene(int s)
     }
     voices[s].clear();
 
-    for (int i = 0; i < n_hpBQ; ++i)
-    {
-        if (s == 0)
-            hpA[i].suspend();
-        else
-            hpB[i].suspend();
-    }
+    if (s == 0)
+        hpA.suspend();
+    else
+        hpB.suspend();
     if (s == 0)
         halfbandA.reset();
     if (s == 1)
@@ -2305,6 +2336,7 @@ void SurgeSynthesizer::channelController(char channel, int cc, int value)
 
             refresh_ctrl_queue[j] = i;
             refresh_ctrl_queue_value[j] = fval;
+            markGUIDirty(gui_dirty_params);
         }
     }
 
@@ -2331,6 +2363,7 @@ void SurgeSynthesizer::channelController(char channel, int cc, int value)
 
             refresh_ctrl_queue[j] = i;
             refresh_ctrl_queue_value[j] = fval;
+            markGUIDirty(gui_dirty_params);
         }
     }
 }
@@ -2430,11 +2463,8 @@ void SurgeSynthesizer::allNotesOff()
     halfbandB.reset();
     halfbandIN.reset();
 
-    for (int i = 0; i < n_hpBQ; i++)
-    {
-        hpA[i].suspend();
-        hpB[i].suspend();
-    }
+    hpA.suspend();
+    hpB.suspend();
 
     for (int i = 0; i < n_fx_slots; i++)
     {
@@ -2793,6 +2823,8 @@ bool SurgeSynthesizer::setParameter01(long index, float value, bool external, bo
         }
         if (!got)
             refresh_overflow = true;
+
+        markGUIDirty(gui_dirty_params);
     }
     return need_refresh;
 }
@@ -2908,50 +2940,21 @@ bool SurgeSynthesizer::loadFx(bool initp, bool force_reload_all)
                 /*
                 ** Clear modulation onto FX otherwise it hangs around from old ones, often with
                 ** disastrously bad meaning. #2036. But only do this if it is a one FX change
-                ** (not a patch load)
+                ** (not a patch load), and not after reorderFx, which has already left the
+                ** routing the way the moved FX wants it.
                 */
-                if (!force_reload_all)
+                if (!force_reload_all && !fx_reload_mod[s])
                 {
-                    for (int j = 0; j < n_fx_params; j++)
-                    {
-                        auto p = &(storage.getPatch().fx[s].p[j]);
-                        for (int ms = 1; ms < n_modsources; ms++)
-                        {
-                            for (int sc = 0; sc < n_scenes; ++sc)
-                            {
-                                clearModulation(p->id, (modsources)ms, sc, true);
-                            }
-                        }
-                    }
-                    if (fx_reload_mod[s])
-                    {
-                        for (auto &t : fxmodsync[s])
-                        {
-                            setModDepth01(storage.getPatch().fx[s].p[t.whichForReal].id,
-                                          (modsources)t.source_id, t.source_scene, t.source_index,
-                                          t.depth);
-                        }
-                        fxmodsync[s].clear();
-                        fx_reload_mod[s] = false;
-                    }
+                    clear_fx_modulation(s);
                 }
             }
-            else
+            else if (!fx_reload_mod[s])
             {
                 // We have re-loaded to NULL; so we want to clear modulation that points at us
                 // no matter what
-                for (int j = 0; j < n_fx_params; j++)
-                {
-                    auto p = &(storage.getPatch().fx[s].p[j]);
-                    for (int ms = 1; ms < n_modsources; ms++)
-                    {
-                        for (int sc = 0; sc < n_scenes; sc++)
-                        {
-                            clearModulation(p->id, (modsources)ms, sc, true);
-                        }
-                    }
-                }
+                clear_fx_modulation(s);
             }
+            fx_reload_mod[s] = false;
 
             something_changed = true;
             refresh_editor = true;
@@ -3367,20 +3370,22 @@ void SurgeSynthesizer::prepareModsourceDoProcess(int scenemask)
                 storage.getPatch().scene[scene].modsource_doprocess[i] = setTo;
             }
 
+            auto *routing = storage.currentModRouting();
+
             for (int j = 0; j < 3; j++)
             {
-                vector<ModulationRouting> *modlist;
+                const vector<ModulationRouting> *modlist;
 
                 switch (j)
                 {
                 case 0:
-                    modlist = &storage.getPatch().modulation_global;
+                    modlist = &routing->global;
                     break;
                 case 1:
-                    modlist = &storage.getPatch().scene[scene].modulation_scene;
+                    modlist = &routing->scene[scene];
                     break;
                 case 2:
-                    modlist = &storage.getPatch().scene[scene].modulation_voice;
+                    modlist = &routing->voice[scene];
                     break;
                 }
 
@@ -3434,10 +3439,13 @@ void SurgeSynthesizer::muteModulation(long ptag, modsources modsource, int modso
     if (!isValidModulation(ptag, modsource))
         return;
 
+    std::lock_guard<std::recursive_mutex> lockModulation(storage.modRoutingMutex);
+
     ModulationRouting *r = getModRouting(ptag, modsource, modsourceScene, index);
     if (r)
     {
         r->muted = mute;
+        storage.publishModRouting();
         storage.getPatch().isDirty = true;
 
         for (auto l : modListeners)
@@ -3560,6 +3568,7 @@ void SurgeSynthesizer::clear_osc_modulation(int scene, int entry)
         else
             iter++;
     }
+    storage.publishModRouting();
     storage.modRoutingMutex.unlock();
 }
 
@@ -3643,6 +3652,7 @@ void SurgeSynthesizer::clearModulation(long ptag, modsources modsource, int mods
         {
             storage.modRoutingMutex.lock();
             modlist->erase(modlist->begin() + i);
+            storage.publishModRouting();
             storage.modRoutingMutex.unlock();
             storage.getPatch().isDirty = true;
 
@@ -3656,6 +3666,46 @@ void SurgeSynthesizer::clearModulation(long ptag, modsources modsource, int mods
     }
 }
 
+void SurgeSynthesizer::clear_fx_modulation(int slot)
+{
+    /*
+     * loadFx calls this on the audio thread, so rather than clearModulation per parameter and
+     * source (each locking and publishing a snapshot of its own) we take everything out in
+     * one pass and publish once. FX parameters are global, so only that list can hold them.
+     */
+    auto &fxs = storage.getPatch().fx[slot];
+    auto &modlist = storage.getPatch().modulation_global;
+
+    auto ontoSlot = [&fxs](const ModulationRouting &r) {
+        if (r.source_id < 1 || r.source_scene < 0 || r.source_scene >= n_scenes)
+            return false;
+
+        return std::any_of(std::begin(fxs.p), std::end(fxs.p),
+                           [&r](const Parameter &p) { return r.destination_id == p.id; });
+    };
+
+    std::lock_guard<std::recursive_mutex> lockModulation(storage.modRoutingMutex);
+
+    for (auto &r : modlist)
+    {
+        if (!ontoSlot(r))
+            continue;
+
+        for (auto l : modListeners)
+            l->modCleared(r.destination_id, (modsources)r.source_id, r.source_scene,
+                          r.source_index);
+    }
+
+    auto gone = std::remove_if(modlist.begin(), modlist.end(), ontoSlot);
+
+    if (gone == modlist.end())
+        return;
+
+    modlist.erase(gone, modlist.end());
+    storage.publishModRouting();
+    storage.getPatch().isDirty = true;
+}
+
 bool SurgeSynthesizer::setModDepth01(long ptag, modsources modsource, int modsourceScene, int index,
                                      float val)
 {
@@ -3721,6 +3771,7 @@ bool SurgeSynthesizer::setModDepth01(long ptag, modsources modsource, int modsou
             modlist->at(found_id).depth = value;
         }
     }
+    storage.publishModRouting();
     storage.modRoutingMutex.unlock();
 
     for (auto l : modListeners)
@@ -3942,11 +3993,18 @@ void loadPatchInBackgroundThread(SurgeSynthesizer *sy)
     return;
 }
 
+void SurgeSynthesizer::runHousekeeping()
+{
+    storage.memoryPools->maintain(&storage);
+    storage.freeRetiredModRouting();
+    freeSpentLoads();
+}
+
 void SurgeSynthesizer::processAudioThreadOpsWhenAudioEngineUnavailable(bool dangerMode)
 {
     if (!audio_processing_active || dangerMode)
     {
-        processEnqueuedPatchIfNeeded();
+        processEnqueuedPatchIfNeeded(true);
 
         auto lg = std::lock_guard<std::mutex>(patchLoadSpawnMutex);
 
@@ -4019,9 +4077,49 @@ void SurgeSynthesizer::enqueueFXOff(int whichFX)
     load_fx_needed = true;
 }
 
+/*
+ * Run the voice LFOs for a whole scene grouped by LFO rather than by voice, so every voice
+ * takes the same shape, deform and envelope branches in a row over the same LFOStorage
+ * rather than switching shapes six times per voice. Each LFO only depends on its own voice's
+ * state from the prior block, so they come out the same as when SurgeVoice::calc_ctrldata
+ * runs them. That goes for the random ones too: noise and S&H draw from a generator of
+ * their own LFO's, and random phase only draws from the storage at attack. The exception is
+ * formula LFOs, which share the storage's Lua state and with it math.random, so those still
+ * run voice by voice to draw in the order they always have.
+ * The lfo/voice-lfos benchmarks compare this against the per voice order.
+ */
+void SurgeSynthesizer::processVoiceLFOs(int scene)
+{
+    auto &lfos = storage.getPatch().scene[scene].lfo;
+
+    for (int i = 0; i < n_lfos_voice; ++i)
+    {
+        if (lfos[i].shape.val.i == lt_formula)
+            continue;
+
+        for (auto *v : voices[scene])
+        {
+            v->processLFO(i);
+        }
+    }
+
+    for (auto *v : voices[scene])
+    {
+        for (int i = 0; i < n_lfos_voice; ++i)
+        {
+            if (lfos[i].shape.val.i == lt_formula)
+                v->processLFO(i);
+        }
+    }
+}
+
 void SurgeSynthesizer::processControl()
 {
     processEnqueuedPatchIfNeeded();
+    processQueuedParameterChanges();
+
+    // pin the routing snapshot for this block; editors publish new ones without blocking us
+    storage.acquireModRouting();
 
     storage.perform_queued_wtloads();
     int sm = storage.getPatch().scenemode.val.i;
@@ -4137,19 +4235,20 @@ void SurgeSynthesizer::processControl()
             // for(int i=0; i<n_lfos_scene; i++)
             // storage.getPatch().scene[s].modsources[ms_slfo1+i]->process_block();
 
-            int n = storage.getPatch().scene[s].modulation_scene.size();
+            auto &modscene = storage.currentModRouting()->scene[s];
+            int n = modscene.size();
             for (int i = 0; i < n; i++)
             {
-                int src_id = storage.getPatch().scene[s].modulation_scene[i].source_id;
-                int src_index = storage.getPatch().scene[s].modulation_scene[i].source_index;
+                int src_id = modscene[i].source_id;
+                int src_index = modscene[i].source_index;
                 if (storage.getPatch().scene[s].modsources[src_id])
                 {
-                    int dst_id = storage.getPatch().scene[s].modulation_scene[i].destination_id;
-                    float depth = storage.getPatch().scene[s].modulation_scene[i].depth;
+                    int dst_id = modscene[i].destination_id;
+                    float depth = modscene[i].depth;
                     storage.getPatch().scenedata[s][dst_id].f +=
                         depth *
                         storage.getPatch().scene[s].modsources[src_id]->get_output(src_index) *
-                        (1.0 - storage.getPatch().scene[s].modulation_scene[i].muted);
+                        (1.0 - modscene[i].muted);
                 }
             }
 
@@ -4172,16 +4271,17 @@ void SurgeSynthesizer::processControl()
 
     loadOscalgos();
 
-    int n = storage.getPatch().modulation_global.size();
+    auto &modglobal = storage.currentModRouting()->global;
+    int n = modglobal.size();
     for (int i = 0; i < n; i++)
     {
-        int src_id = storage.getPatch().modulation_global[i].source_id;
-        int dst_id = storage.getPatch().modulation_global[i].destination_id;
-        float depth = storage.getPatch().modulation_global[i].depth;
-        int source_scene = storage.getPatch().modulation_global[i].source_scene;
+        int src_id = modglobal[i].source_id;
+        int dst_id = modglobal[i].destination_id;
+        float depth = modglobal[i].depth;
+        int source_scene = modglobal[i].source_scene;
         storage.getPatch().globaldata[dst_id].f +=
             depth * storage.getPatch().scene[source_scene].modsources[src_id]->get_output(0) *
-            (1 - storage.getPatch().modulation_global[i].muted);
+            (1 - modglobal[i].muted);
     }
 
     if (switch_toggled_queued)
@@ -4225,12 +4325,190 @@ void SurgeSynthesizer::processControl()
 #endif
 }
 
+bool SurgeSynthesizer::nothingToWakeFor()
+{
+    if (!voices[0].empty() || !voices[1].empty())
+        return false;
+
+    // the editor and host hand most changes to the audio thread through these, and they are
+    // only picked up by processControl
+    if (halt_engine || patchid_queue >= 0 || has_patchid_file || approachingAllSoundsOff ||
+        enqueuedLoad.load(std::memory_order_acquire) || load_fx_needed || fx_suspend_bitmask ||
+        switch_toggled_queued ||
+        parameterQueueRead.load(std::memory_order_relaxed) !=
+            parameterQueueWrite.load(std::memory_order_acquire))
+        return false;
+
+    for (int sc = 0; sc < n_scenes; ++sc)
+    {
+        auto &scene = storage.getPatch().scene[sc];
+
+        // latch mode starts its own note from processControl
+        if (release_if_latched[sc] || scene.polymode.val.i == pm_latch)
+            return false;
+
+        for (auto &o : scene.osc)
+        {
+            if (o.queue_type > -1 || o.queue_xmldata || o.wt.queue_id != -1 ||
+                !o.wt.queue_filename.empty())
+                return false;
+        }
+    }
+
+    for (int i = 0; i < num_controlinterpolators; ++i)
+    {
+        if (mControlInterpolatorUsed[i])
+            return false;
+    }
+
+    if (process_input && std::max(mech::blockAbsMax<BLOCK_SIZE>(input[0]),
+                                  mech::blockAbsMax<BLOCK_SIZE>(input[1])) > sleepSilence)
+        return false;
+
+    return true;
+}
+
+void SurgeSynthesizer::updateSleepState()
+{
+    if (!sleepWhenIdle || !voices[0].empty() || !voices[1].empty())
+    {
+        silentBlocks = 0;
+        return;
+    }
+
+    auto peak = std::max(mech::blockAbsMax<BLOCK_SIZE>(output[0]),
+                         mech::blockAbsMax<BLOCK_SIZE>(output[1]));
+
+    for (int sc = 0; sc < n_scenes; ++sc)
+    {
+        peak = std::max({peak, mech::blockAbsMax<BLOCK_SIZE>(sceneout[sc][0]),
+                         mech::blockAbsMax<BLOCK_SIZE>(sceneout[sc][1])});
+    }
+
+    if (peak > sleepSilence)
+    {
+        silentBlocks = 0;
+        return;
+    }
+
+    if (++silentBlocks < sleepHoldSeconds * storage.samplerate * BLOCK_SIZE_INV)
+        return;
+
+    // effects which know how long they ring for must also have said they are done
+    auto fx_bypass = storage.getPatch().fx_bypass.val.i;
+    auto runs = [fx_bypass](int slot) {
+        switch (slot)
+        {
+        case fxslot_send1:
+        case fxslot_send2:
+        case fxslot_send3:
+        case fxslot_send4:
+            return fx_bypass == fxb_all_fx;
+        case fxslot_global1:
+        case fxslot_global2:
+        case fxslot_global3:
+        case fxslot_global4:
+            return fx_bypass == fxb_all_fx || fx_bypass == fxb_no_sends;
+        default:
+            return fx_bypass != fxb_no_fx;
+        }
+    };
+
+    for (int slot = 0; slot < n_fx_slots; ++slot)
+    {
+        if (fx[slot] && !(storage.getPatch().fx_disable.val.i & (1 << slot)) && runs(slot) &&
+            fx[slot]->get_ringout_decay() >= 0 && !fx[slot]->hasRungOut())
+            return;
+    }
+
+    if (!nothingToWakeFor())
+        return;
+
+    sleeping = true;
+    vu_peak[0] = 0.f;
+    vu_peak[1] = 0.f;
+    markGUIDirty(gui_dirty_meters);
+}
+
+void SurgeSynthesizer::processSceneOutput(int s,
+                                          sst::filters::HalfRate::HalfRateFilter &halfband,
+                                          BiquadCascade<n_hpBQ> &lowcut)
+{
+    auto mode = storage.sceneHardclipMode[s];
+    auto *L = sceneout[s][0], *R = sceneout[s][1];
+
+    if (play_scene[s])
+    {
+        switch (mode)
+        {
+        case SurgeStorage::HARDCLIP_TO_18DBFS:
+            sdsp::hardclip_block8<BLOCK_SIZE_OS>(L);
+            sdsp::hardclip_block8<BLOCK_SIZE_OS>(R);
+            break;
+        case SurgeStorage::HARDCLIP_TO_0DBFS:
+            sdsp::hardclip_block<BLOCK_SIZE_OS>(L);
+            sdsp::hardclip_block<BLOCK_SIZE_OS>(R);
+            break;
+        case SurgeStorage::BYPASS_HARDCLIP:
+            break;
+        }
+
+        halfband.process_block_D2(L, R, BLOCK_SIZE_OS);
+    }
+
+    auto &lc = storage.getPatch().scene[s].lowcut;
+
+    if (lc.deactivated)
+    {
+        switch (mode)
+        {
+        case SurgeStorage::HARDCLIP_TO_18DBFS:
+            sdsp::hardclip_block8<BLOCK_SIZE>(L);
+            sdsp::hardclip_block8<BLOCK_SIZE>(R);
+            break;
+        case SurgeStorage::HARDCLIP_TO_0DBFS:
+            sdsp::hardclip_block<BLOCK_SIZE>(L);
+            sdsp::hardclip_block<BLOCK_SIZE>(R);
+            break;
+        default:
+            break;
+        }
+
+        return;
+    }
+
+    auto freq = storage.getPatch().scenedata[s][lc.param_id_in_scene].f;
+    auto slope = lc.deform_type;
+
+    for (int i = 0; i < n_hpBQ; i++)
+    {
+        lowcut.setActive(i, i <= slope);
+        if (i <= slope)
+            lowcut[i].coeff_HP(lowcut[i].calc_omega(freq / 12.0), 0.4); // var 0.707
+    }
+
+    // the clip rides along on the low cut's pass rather than taking one of its own
+    switch (mode)
+    {
+    case SurgeStorage::HARDCLIP_TO_18DBFS:
+        lowcut.process_block_fused(L, R, [](float x) { return std::clamp(x, -8.f, 8.f); });
+        break;
+    case SurgeStorage::HARDCLIP_TO_0DBFS:
+        lowcut.process_block_fused(L, R, [](float x) { return std::clamp(x, -1.f, 1.f); });
+        break;
+    default:
+        lowcut.process_block_fused(L, R, [](float x) { return x; });
+        break;
+    }
+}
+
 void SurgeSynthesizer::process()
 {
 #if DEBUG_RNG_THREADING
     storage.audioThreadID = std::this_thread::get_id();
 #endif
     processRunning = 0;
+    storage.blockNumber++;
 
 #if DEBUG
     memset(endedHostNoteIds, 0, 512 * sizeof(int32_t));
@@ -4255,6 +4533,38 @@ void SurgeSynthesizer::process()
         hostNoteEndedDuringBlockCount = 0;
     }
 
+    if (sleeping)
+    {
+        if (sleepWhenIdle && nothingToWakeFor())
+        {
+            mech::clear_block<BLOCK_SIZE>(output[0]);
+            mech::clear_block<BLOCK_SIZE>(output[1]);
+
+            for (int sc = 0; sc < n_scenes; ++sc)
+            {
+                mech::clear_block<BLOCK_SIZE_OS>(sceneout[sc][0]);
+                mech::clear_block<BLOCK_SIZE_OS>(sceneout[sc][1]);
+            }
+
+            if (storage.audioOut.subscribed())
+                storage.audioOut.push(output[0], output[1], BLOCK_SIZE);
+
+            float c = cpu_level.load() * storage.cpu_falloff;
+            cpu_level.store(c);
+
+            if (c < cpu_level_marked - 0.005f)
+            {
+                cpu_level_marked = c;
+                markGUIDirty(gui_dirty_meters);
+            }
+
+            return;
+        }
+
+        sleeping = false;
+        silentBlocks = 0;
+    }
+
     float mfade = 1.f;
 
     if (halt_engine)
@@ -4270,7 +4580,19 @@ void SurgeSynthesizer::process()
 
         if (masterfade < 0.0001f)
         {
-            std::lock_guard<std::mutex> mg(patchLoadSpawnMutex);
+            /*
+             * The UI holds this lock while it sets up a patch file load (which includes
+             * pushing an undo record), so don't wait on it here. We are already faded out,
+             * so just stay silent and spawn on a later block.
+             */
+            std::unique_lock<std::mutex> mg(patchLoadSpawnMutex, std::try_to_lock);
+            if (!mg.owns_lock())
+            {
+                mech::clear_block<BLOCK_SIZE>(output[0]);
+                mech::clear_block<BLOCK_SIZE>(output[1]);
+                return;
+            }
+
             // spawn patch-loading thread
             allNotesOff();
             halt_engine = true;
@@ -4339,8 +4661,8 @@ void SurgeSynthesizer::process()
         }
     }
 
-    storage.modRoutingMutex.lock();
     processControl();
+    storage.memoryPools->processBlock(&storage);
 
     amp.set_target_smoothed(
         storage.db_to_linear(storage.getPatch().globaldata[storage.getPatch().volume.id].f));
@@ -4386,6 +4708,9 @@ void SurgeSynthesizer::process()
     for (int s = 0; s < n_scenes; s++)
     {
         FBentry[s] = 0;
+        if (groupVoiceLFOs)
+            processVoiceLFOs(s);
+
         iter = voices[s].begin();
         while (iter != voices[s].end())
         {
@@ -4405,8 +4730,6 @@ void SurgeSynthesizer::process()
                 iter++;
         }
 
-        storage.modRoutingMutex.unlock();
-
         using sst::filters::FilterType, sst::filters::FilterSubType;
         fbq_global g;
         if (storage.getPatch().scene[s].filterunit[0].type.deactivated)
@@ -4475,96 +4798,14 @@ void SurgeSynthesizer::process()
             v->GetQFB(); // save filter state in voices after quad processing is done
             iter++;
         }
-        storage.modRoutingMutex.lock();
     }
 
-    storage.modRoutingMutex.unlock();
-    polydisplay = vcount;
-
-    // TODO: FIX SCENE ASSUMPTION
-    if (play_scene[0])
-    {
-        switch (storage.sceneHardclipMode[0])
-        {
-        case SurgeStorage::HARDCLIP_TO_18DBFS:
-            sdsp::hardclip_block8<BLOCK_SIZE_OS>(sceneout[0][0]);
-            sdsp::hardclip_block8<BLOCK_SIZE_OS>(sceneout[0][1]);
-            break;
-        case SurgeStorage::HARDCLIP_TO_0DBFS:
-            sdsp::hardclip_block<BLOCK_SIZE_OS>(sceneout[0][0]);
-            sdsp::hardclip_block<BLOCK_SIZE_OS>(sceneout[0][1]);
-            break;
-        case SurgeStorage::BYPASS_HARDCLIP:
-            break;
-        }
-
-        halfbandA.process_block_D2(sceneout[0][0], sceneout[0][1], BLOCK_SIZE_OS);
-    }
-
-    if (play_scene[1])
-    {
-        switch (storage.sceneHardclipMode[1])
-        {
-        case SurgeStorage::HARDCLIP_TO_18DBFS:
-            sdsp::hardclip_block8<BLOCK_SIZE_OS>(sceneout[1][0]);
-            sdsp::hardclip_block8<BLOCK_SIZE_OS>(sceneout[1][1]);
-            break;
-        case SurgeStorage::HARDCLIP_TO_0DBFS:
-            sdsp::hardclip_block<BLOCK_SIZE_OS>(sceneout[1][0]);
-            sdsp::hardclip_block<BLOCK_SIZE_OS>(sceneout[1][1]);
-            break;
-        case SurgeStorage::BYPASS_HARDCLIP:
-            break;
-        }
-
-        halfbandB.process_block_D2(sceneout[1][0], sceneout[1][1], BLOCK_SIZE_OS);
-    }
+    if (polydisplay.exchange(vcount) != vcount)
+        markGUIDirty(gui_dirty_voices);
 
     // TODO: FIX SCENE ASSUMPTION
-    if (storage.getPatch().scene[0].lowcut.deactivated == false)
-    {
-        auto freq =
-            storage.getPatch().scenedata[0][storage.getPatch().scene[0].lowcut.param_id_in_scene].f;
-
-        auto slope = storage.getPatch().scene[0].lowcut.deform_type;
-
-        for (int i = 0; i <= slope; i++)
-        {
-            hpA[i].coeff_HP(hpA[i].calc_omega(freq / 12.0), 0.4); // var 0.707
-            hpA[i].process_block(sceneout[0][0], sceneout[0][1]); // TODO: quadify
-        }
-    }
-
-    if (storage.getPatch().scene[1].lowcut.deactivated == false)
-    {
-        auto freq =
-            storage.getPatch().scenedata[1][storage.getPatch().scene[1].lowcut.param_id_in_scene].f;
-
-        auto slope = storage.getPatch().scene[1].lowcut.deform_type;
-
-        for (int i = 0; i <= slope; i++)
-        {
-            hpB[i].coeff_HP(hpB[i].calc_omega(freq / 12.0), 0.4); // var 0.707
-            hpB[i].process_block(sceneout[1][0], sceneout[1][1]); // TODO: quadify
-        }
-    }
-
-    for (int cls = 0; cls < n_scenes; ++cls)
-    {
-        switch (storage.sceneHardclipMode[cls])
-        {
-        case SurgeStorage::HARDCLIP_TO_18DBFS:
-            sdsp::hardclip_block8<BLOCK_SIZE>(sceneout[cls][0]);
-            sdsp::hardclip_block8<BLOCK_SIZE>(sceneout[cls][1]);
-            break;
-        case SurgeStorage::HARDCLIP_TO_0DBFS:
-            sdsp::hardclip_block<BLOCK_SIZE>(sceneout[cls][0]);
-            sdsp::hardclip_block<BLOCK_SIZE>(sceneout[cls][1]);
-            break;
-        default:
-            break;
-        }
-    }
+    processSceneOutput(0, halfbandA, hpA);
+    processSceneOutput(1, halfbandB, hpB);
 
     // TODO: FIX SCENE ASSUMPTION
     bool sc_state[n_scenes];
@@ -4574,24 +4815,58 @@ void SurgeSynthesizer::process()
         sc_state[i] = play_scene[i];
     }
 
+    /*
+     * The FX stages below run their independent chains through processFXTasks. Each task
+     * only touches its own effects and buffers, and anything summed across tasks is summed
+     * afterwards in slot order.
+     */
+    struct FXTaskContext
+    {
+        SurgeSynthesizer *synth;
+        bool *sc_state;
+        float (*fxsendout)[2][BLOCK_SIZE];
+        bool *sendused;
+        int chains[maxParallelFXChains];
+    } fxContext{this, sc_state, fxsendout, nullptr, {}};
+
+    static constexpr int insertSlots[n_scenes][4] = {
+        {fxslot_ains1, fxslot_ains2, fxslot_ains3, fxslot_ains4},
+        {fxslot_bins1, fxslot_bins2, fxslot_bins3, fxslot_bins4}};
+    static constexpr int sendSlots[n_send_slots] = {fxslot_send1, fxslot_send2, fxslot_send3,
+                                                    fxslot_send4};
+
+    auto fxActive = [this](int slot) {
+        return fx[slot] && !(storage.getPatch().fx_disable.val.i & (1 << slot));
+    };
+
     // apply insert effects
     if (fx_bypass != fxb_no_fx)
     {
-        for (auto v : {fxslot_ains1, fxslot_ains2, fxslot_ains3, fxslot_ains4})
+        int nChains = 0;
+        for (int sc = 0; sc < n_scenes; ++sc)
         {
-            if (fx[v] && !(storage.getPatch().fx_disable.val.i & (1 << v)))
-            {
-                sc_state[0] = fx[v]->process_ringout(sceneout[0][0], sceneout[0][1], sc_state[0]);
-            }
+            if (std::any_of(std::begin(insertSlots[sc]), std::end(insertSlots[sc]), fxActive))
+                fxContext.chains[nChains++] = sc;
         }
 
-        for (auto v : {fxslot_bins1, fxslot_bins2, fxslot_bins3, fxslot_bins4})
-        {
-            if (fx[v] && !(storage.getPatch().fx_disable.val.i & (1 << v)))
-            {
-                sc_state[1] = fx[v]->process_ringout(sceneout[1][0], sceneout[1][1], sc_state[1]);
-            }
-        }
+        processFXTasks(
+            nChains,
+            [](void *c, int i) {
+                auto ctx = static_cast<FXTaskContext *>(c);
+                auto sy = ctx->synth;
+                auto sc = ctx->chains[i];
+
+                for (auto v : insertSlots[sc])
+                {
+                    if (sy->fx[v] && !(sy->storage.getPatch().fx_disable.val.i & (1 << v)))
+                    {
+                        SurgeStorage::ScopedRNG rng(sy->fxRNG[v]);
+                        ctx->sc_state[sc] = sy->fx[v]->process_ringout(
+                            sy->sceneout[sc][0], sy->sceneout[sc][1], ctx->sc_state[sc]);
+                    }
+                }
+            },
+            &fxContext);
     }
 
     for (int cls = 0; cls < n_scenes; ++cls)
@@ -4623,22 +4898,39 @@ void SurgeSynthesizer::process()
     // TODO: FIX SCENE ASSUMPTION
     if (fx_bypass == fxb_all_fx)
     {
+        int nSends = 0;
         for (auto si : sendToIndex)
         {
-            auto slot = si[0];
-            auto idx = si[1];
+            if (fxActive(si[0]))
+                fxContext.chains[nSends++] = si[1];
+        }
+        fxContext.sendused = sendused;
 
-            if (fx[slot] && !(storage.getPatch().fx_disable.val.i & (1 << slot)))
-            {
-                send[idx][0].MAC_2_blocks_to(sceneout[0][0], sceneout[0][1], fxsendout[idx][0],
-                                             fxsendout[idx][1], BLOCK_SIZE_QUAD);
-                send[idx][1].MAC_2_blocks_to(sceneout[1][0], sceneout[1][1], fxsendout[idx][0],
-                                             fxsendout[idx][1], BLOCK_SIZE_QUAD);
-                sendused[idx] = fx[slot]->process_ringout(fxsendout[idx][0], fxsendout[idx][1],
-                                                          sc_state[0] || sc_state[1]);
-                FX[idx].MAC_2_blocks_to(fxsendout[idx][0], fxsendout[idx][1], output[0], output[1],
-                                        BLOCK_SIZE_QUAD);
-            }
+        processFXTasks(
+            nSends,
+            [](void *c, int i) {
+                auto ctx = static_cast<FXTaskContext *>(c);
+                auto sy = ctx->synth;
+                auto idx = ctx->chains[i];
+                auto slot = sendSlots[idx];
+                auto &out = ctx->fxsendout[idx];
+
+                sy->send[idx][0].MAC_2_blocks_to(sy->sceneout[0][0], sy->sceneout[0][1], out[0],
+                                                 out[1], BLOCK_SIZE_QUAD);
+                sy->send[idx][1].MAC_2_blocks_to(sy->sceneout[1][0], sy->sceneout[1][1], out[0],
+                                                 out[1], BLOCK_SIZE_QUAD);
+
+                SurgeStorage::ScopedRNG rng(sy->fxRNG[slot]);
+                ctx->sendused[idx] = sy->fx[slot]->process_ringout(
+                    out[0], out[1], ctx->sc_state[0] || ctx->sc_state[1]);
+            },
+            &fxContext);
+
+        for (int i = 0; i < nSends; ++i)
+        {
+            auto idx = fxContext.chains[i];
+            FX[idx].MAC_2_blocks_to(fxsendout[idx][0], fxsendout[idx][1], output[0], output[1],
+                                    BLOCK_SIZE_QUAD);
         }
     }
 
@@ -4663,11 +4955,16 @@ void SurgeSynthesizer::process()
 
     // VU falloff
     float a = storage.vu_falloff;
+    float priorPeak = vu_peak[0] + vu_peak[1];
     vu_peak[0] = min(2.f, a * vu_peak[0]);
     vu_peak[1] = min(2.f, a * vu_peak[1]);
     vu_peak[0] = max(vu_peak[0], mech::blockAbsMax<BLOCK_SIZE>(output[0]));
     vu_peak[1] = max(vu_peak[1], mech::blockAbsMax<BLOCK_SIZE>(output[1]));
 
+    // a fully decayed meter stops dirtying the editor; anything audible keeps it animating
+    if (vu_peak[0] + vu_peak[1] > 1e-5f || priorPeak > 1e-5f)
+        markGUIDirty(gui_dirty_meters);
+
     switch (storage.hardclipMode)
     {
     case SurgeStorage::HARDCLIP_TO_18DBFS:
@@ -4695,6 +4992,8 @@ void SurgeSynthesizer::process()
         amp_mute.multiply_2_blocks(sceneout[sc][0], sceneout[sc][1], BLOCK_SIZE_QUAD);
     }
 
+    updateSleepState();
+
     // Calculate how close we are to overloading the CPU
     // (how close is the process() duration to duration)
     auto process_end = std::chrono::high_resolution_clock::now();
@@ -4706,7 +5005,14 @@ void SurgeSynthesizer::process()
     int window = max_duration_usec;
     auto smoothed_ratio = (c * (window - 1) + ratio) / window;
     c = c * storage.cpu_falloff;
-    cpu_level.store(max(c, smoothed_ratio));
+    c = max(c, smoothed_ratio);
+    cpu_level.store(c);
+
+    if (c > cpu_level_marked + 0.005f || c < cpu_level_marked - 0.005f)
+    {
+        cpu_level_marked = c;
+        markGUIDirty(gui_dirty_meters);
+    }
 }
 
 SurgeSynthesizer::PluginLayer *SurgeSynthesizer::getParent()
@@ -4905,6 +5211,7 @@ void SurgeSynthesizer::swapMetaControllers(int c1, int c2)
         }
     }
 
+    storage.publishModRouting();
     storage.modRoutingMutex.unlock();
 
     refresh_editor = true;
@@ -4940,8 +5247,13 @@ void SurgeSynthesizer::reorderFx(int source, int target, FXReorderMode m)
     so = storage.getPatch().fx[source];
     to = storage.getPatch().fx[target];
 
-    fxmodsync[source].clear();
-    fxmodsync[target].clear();
+    /*
+     * The routings which follow the FX to its new slot are rewritten here, on the calling
+     * thread, and published in one snapshot along with the deletions below. loadFx then leaves
+     * the routing of the reloaded slots alone (see fx_reload_mod), so the audio thread never
+     * has to take the routing lock or allocate to put them back.
+     */
+    std::array<std::vector<FXModSyncItem>, n_fx_slots> fxmodsync;
 
     fxsync[target].type.val.i = so.type.val.i;
 
@@ -5020,7 +5332,6 @@ void SurgeSynthesizer::reorderFx(int source, int target, FXReorderMode m)
         if (mv->at(i).destination_id >= fxsync[source].p[0].id &&
             mv->at(i).destination_id <= fxsync[source].p[n_fx_params - 1].id)
         {
-            fx_reload_mod[target] = true;
             int whichForReal = -1;
 
             for (int q = 0; q < n_fx_params; ++q)
@@ -5043,7 +5354,6 @@ void SurgeSynthesizer::reorderFx(int source, int target, FXReorderMode m)
             if (mv->at(i).destination_id >= fxsync[target].p[0].id &&
                 mv->at(i).destination_id <= fxsync[target].p[n_fx_params - 1].id)
             {
-                fx_reload_mod[source] = true;
                 int whichForReal = -1;
 
                 for (int q = 0; q < n_fx_params; ++q)
@@ -5085,9 +5395,36 @@ void SurgeSynthesizer::reorderFx(int source, int target, FXReorderMode m)
         mv->erase(mv->begin() + *dt);
     }
 
+    // fxsync already has the moved FX's control types, so it scales the depths as loadFx will
+    for (int s = 0; s < n_fx_slots; ++s)
+    {
+        for (auto &t : fxmodsync[s])
+        {
+            ModulationRouting r;
+            r.depth = fxsync[s].p[t.whichForReal].set_modulation_f01(t.depth);
+            r.source_id = t.source_id;
+            r.destination_id = storage.getPatch().fx[s].p[t.whichForReal].id;
+            r.muted = false;
+            r.source_index = t.source_index;
+            r.source_scene = t.source_scene;
+            if (r.depth != 0)
+                mv->push_back(r);
+        }
+    }
+    storage.publishModRouting();
+
+    for (int s = 0; s < n_fx_slots; ++s)
+        for (auto &t : fxmodsync[s])
+            for (auto l : modListeners)
+                l->modSet(storage.getPatch().fx[s].p[t.whichForReal].id,
+                          (modsources)t.source_id, t.source_scene, t.source_index, t.depth, true);
+
+    fx_reload_mod[target] = true;
+
     if (m != FXReorderMode::COPY)
     {
         fx_reload[source] = true;
+        fx_reload_mod[source] = true;
     }
 
     // Finally deal with the bitmask
@@ -25,7 +25,8 @@
 #include "SurgeStorage.h"
 #include "SurgeVoice.h"
 #include "Effect.h"
-#include "BiquadFilter.h"
+#include "BiquadCascade.h"
+#include "RealtimeWorkerPool.h"
 #include <set>
 #include <sst/filters/HalfRateFilter.h>
 
@@ -34,6 +35,7 @@ struct QuadFilterChainState;
 #include <list>
 #include <utility>
 #include <atomic>
+#include <algorithm>
 #include <cstdio>
 #include <bitset>
 
@@ -99,6 +101,28 @@ class alignas(16) SurgeSynthesizer
     int getMpeMainChannel(int voiceChannel, int key);
     void process();
 
+    /*
+     * The wrappers start notes which land in a block before rendering it, and say where in
+     * that block each one lands. Voices started while this is non-zero run that many samples
+     * late for their whole life, which makes note starts sample accurate even though we
+     * still render in whole blocks. Everything else still acts on whole blocks.
+     */
+    void setEventSampleOffset(int offset)
+    {
+        eventSampleOffset = std::clamp(offset, 0, BLOCK_SIZE - 1);
+    }
+    int eventSampleOffset{0};
+
+    /*
+     * An instance which has been silent for a while with nothing left ringing goes to sleep:
+     * process() writes silence and returns straight away until a voice, audio input or a
+     * queued change gives it something to do. Hosts keep calling every idle track in a
+     * session, so this is most of what an idle instance costs. Clearing sleepWhenIdle keeps
+     * the engine running, for comparing against.
+     */
+    bool sleepWhenIdle{true};
+    bool isSleeping() const { return sleeping; }
+
     PluginLayer *getParent();
 
     // protected:
@@ -108,6 +132,20 @@ class alignas(16) SurgeSynthesizer
 
     void resetStateFromTimeData();
     void processControl();
+    // Whether a sleeping engine can stay asleep for this block
+    bool nothingToWakeFor();
+    // Called at the end of a full block to decide whether the next one can sleep
+    void updateSleepState();
+    bool sleeping{false};
+    int silentBlocks{0};
+    // -120 dBFS
+    static constexpr float sleepSilence = 1e-6f;
+    // Longer than any effect can leave between a sound and its next repeat, such as a long
+    // delay with feedback, so silent output for this long means there is nothing left inside
+    static constexpr float sleepHoldSeconds = 10.f;
+    void processVoiceLFOs(int scene);
+    // Clear to leave the voice LFOs to each voice's calc_ctrldata, for comparing against.
+    bool groupVoiceLFOs{true};
     /*
      * processAudioThreadOpsWhenAudioEngineUnavailable reloads a patch if the audio thread
      * isn't running but if it is running lets the deferred queue handle it. But it has an option
@@ -117,6 +155,14 @@ class alignas(16) SurgeSynthesizer
      */
     void
     processAudioThreadOpsWhenAudioEngineUnavailable(bool doItEvenIfAudioIsRunningDANGER = false);
+    /*
+     * Work the audio thread sets up but mustn't do itself, like growing and trimming the
+     * oscillator memory pools or freeing the routing snapshots it retired. Call it regularly
+     * from anything but the audio thread; the plugin does so from a timer on the message
+     * thread. Until it runs, the audio thread falls back to allocating in the pools as it
+     * always has.
+     */
+    void runHousekeeping();
     bool loadFx(bool initp, bool force_reload_all);
     void enqueueFXOff(int whichFX);
     bool loadOscalgos();
@@ -333,6 +379,8 @@ class alignas(16) SurgeSynthesizer
                          bool clearEvenIfInvalid = false);
     // clear the modulation routings on the algorithm-specific sliders
     void clear_osc_modulation(int scene, int entry);
+    // clear every routing onto an FX slot's parameters, publishing once for the lot
+    void clear_fx_modulation(int slot);
 
     /*
      * The modulation API (setModDepth01 etc...) is called from all sorts of places
@@ -358,12 +406,53 @@ class alignas(16) SurgeSynthesizer
     void removeModulationAPIListener(ModulationAPIListener *l) { modListeners.erase(l); }
 
   public:
-    std::atomic<bool> rawLoadEnqueued{false}, rawLoadNeedsUIDawExtraState{false};
+    std::atomic<bool> rawLoadNeedsUIDawExtraState{false};
+    /*
+     * Raw patch loads are handed to the audio thread through a single slot mailbox. The
+     * enqueuing thread copies the data and swaps it in (freeing any load which was never
+     * picked up, since only the latest state matters) and the audio thread swaps it out, so
+     * the hand-off itself never blocks. Once loaded, the audio thread pushes the load onto
+     * spentLoads rather than freeing it, and the next enqueue or runHousekeeping frees it.
+     * rawLoadQueueMutex now only guards the DAW extra state a load leaves behind for the UI,
+     * and the audio thread only ever try-locks it.
+     *
+     * Single parameter changes have a queue of their own below, notes from the UI go through
+     * the processor's midiFromGUI fifo, and mod routing edits are published as snapshots
+     * (see publishModRouting), so none of those share this mailbox.
+     */
+    struct EnqueuedLoad
+    {
+        std::unique_ptr<char[]> data;
+        int size{0};
+        EnqueuedLoad *nextSpent{nullptr};
+    };
+    std::atomic<EnqueuedLoad *> enqueuedLoad{nullptr}, spentLoads{nullptr};
+    void freeSpentLoads();
     std::mutex rawLoadQueueMutex;
-    std::unique_ptr<char[]> enqueuedLoadData{nullptr}; // if this is set I need to free it
-    int enqueuedLoadSize{0};
     void enqueuePatchForLoad(const void *data, int size); // safe from any thread
-    void processEnqueuedPatchIfNeeded();                  // only safe from audio thread
+    // only safe from audio thread, or with the audio engine unavailable (and then waitForLocks)
+    void processEnqueuedPatchIfNeeded(bool waitForLocks = false);
+
+    /*
+     * Parameter changes from a thread which isn't the audio thread and doesn't otherwise own
+     * the patch (OSC, for one) queue here and land through setParameter01 at the top of the
+     * next block. It is a fixed ring with one producer and the audio thread as its consumer,
+     * so neither side locks or allocates; if it fills up, the change is dropped and this
+     * returns false. Values are normalized as for setParameter01.
+     *
+     * Mod routing edits don't come through here. Applying them on the audio thread would
+     * mean publishing their snapshots there, so their editors keep publishing them directly.
+     */
+    bool enqueueParameterChange(const ID &id, float value01);
+    void processQueuedParameterChanges();
+    struct QueuedParameterChange
+    {
+        int id{0};
+        float value01{0.f};
+    };
+    static constexpr uint32_t parameterQueueSize{1024};
+    std::array<QueuedParameterChange, parameterQueueSize> parameterQueue;
+    std::atomic<uint32_t> parameterQueueRead{0}, parameterQueueWrite{0};
 
     void loadRaw(const void *data, int size, bool preset = false);
     void loadPatch(int id);
@@ -383,7 +472,8 @@ class alignas(16) SurgeSynthesizer
     void savePatch(bool factoryInPlace = false, bool skipOverwrite = false);
     void updateUsedState();
     void prepareModsourceDoProcess(int scenemask);
-    unsigned int saveRaw(void **data);
+    // binaryState writes the compact "sub4" chunk rather than the XML based "sub3" one
+    unsigned int saveRaw(void **data, bool binaryState = false);
 
     // synth -> editor variables
     bool refresh_editor, patch_loaded;
@@ -405,6 +495,22 @@ class alignas(16) SurgeSynthesizer
     float vu_peak[8];
     std::atomic<float> cpu_level{0.f};
 
+    /*
+     * A compact summary of which engine-side state the editor shows has changed. Bits are
+     * or-ed in as things happen (mostly on the audio thread) and the editor drains them all at
+     * once on idle, so it can skip whole sections and their repaints when nothing moved.
+     */
+    enum GUIDirtyFlags : uint32_t
+    {
+        gui_dirty_params = 1 << 0, // refresh_ctrl_queue, refresh_parameter_queue, overflow
+        gui_dirty_meters = 1 << 1, // vu_peak, cpu_level and the FX VUs
+        gui_dirty_voices = 1 << 2, // polydisplay
+    };
+    std::atomic<uint32_t> guiDirty{0};
+    float cpu_level_marked{0.f};
+    void markGUIDirty(uint32_t flags) { guiDirty.fetch_or(flags, std::memory_order_release); }
+    uint32_t takeGUIDirty() { return guiDirty.exchange(0, std::memory_order_acquire); }
+
     void populateDawExtraState();
 
     void loadFromDawExtraState();
@@ -418,6 +524,29 @@ class alignas(16) SurgeSynthesizer
     std::list<SurgeVoice *> voices[n_scenes];
     std::unique_ptr<Effect> fx[n_fx_slots];
     std::atomic<bool> halt_engine;
+
+    /*
+     * The two scene insert chains don't depend on each other, and neither do the send
+     * effects once the inserts are done, so process() can run each group across these
+     * workers. Results are summed in slot order afterwards so the output is the same as
+     * running them one after another.
+     *
+     * Every synth in the process shares one pool, which nobody starts until a synth turns
+     * this on, and which only holds workers for as many chains as can run at once. Call
+     * setProcessFXInParallel off the audio thread. Wrappers rendering offline should drop
+     * workerPriority so live instances get the workers first.
+     */
+    static constexpr int maxParallelFXChains{std::max(n_scenes, n_send_slots)};
+    std::shared_ptr<RealtimeWorkerPool> fxWorkers;
+    std::atomic<bool> processFXInParallel{false};
+    void setProcessFXInParallel(bool b);
+    /*
+     * Effects in those chains draw their random numbers from a generator of their slot's,
+     * seeded the same every time, so the output doesn't depend on which thread ran them.
+     */
+    SurgeStorage::RNGGen fxRNG[n_fx_slots];
+    int workerPriority{RealtimeWorkerPool::priority_normal};
+    void processFXTasks(int n, RealtimeWorkerPool::task_t task, void *context);
     MidiChannelState channelState[16];
     bool mpeEnabled = false;
     int mpeVoices = 0;
@@ -438,10 +567,18 @@ class alignas(16) SurgeSynthesizer
     static constexpr int n_hpBQ = 4;
 
     // TODO: FIX SCENE ASSUMPTION (use std::array)
-    std::array<BiquadFilter, n_hpBQ> hpA, hpB;
+    BiquadCascade<n_hpBQ> hpA, hpB;
+
+    /*
+     * Everything between a scene's filter output and the FX: the oversampled clip, the
+     * decimation, then the low cut and the clip at the base rate, which run as one pass.
+     */
+    void processSceneOutput(int scene, sst::filters::HalfRate::HalfRateFilter &halfband,
+                            BiquadCascade<n_hpBQ> &lowcut);
 
     bool fx_reload[n_fx_slots];   // if true, reload new effect parameters from fxsync
     FxStorage fxsync[n_fx_slots]; // used for synchronisation of parameter init
+    // set by reorderFx, which has already rewritten the slot's routing, so loadFx leaves it be
     bool fx_reload_mod[n_fx_slots];
 
     struct FXModSyncItem
@@ -452,7 +589,6 @@ class alignas(16) SurgeSynthesizer
         int whichForReal;
         float depth;
     };
-    std::array<std::vector<FXModSyncItem>, n_fx_slots> fxmodsync;
     int32_t fx_suspend_bitmask;
 
     // hold pedal stuff
@@ -228,17 +228,17 @@ void SurgeSynthesizer::loadPatch(int id)
 bool SurgeSynthesizer::loadPatchByPath(const char *fxpPath, int categoryId, const char *patchName,
                                        bool forceIsPreset)
 {
-    std::filebuf f;
-    if (!f.open(string_to_path(fxpPath), std::ios::binary | std::ios::in))
+    auto f = storage.openDataFileForRead(string_to_path(fxpPath));
+    if (!f)
         return false;
     fxChunkSetCustom fxp;
-    auto read = f.sgetn(reinterpret_cast<char *>(&fxp), sizeof(fxp));
+    auto read = f->sgetn(reinterpret_cast<char *>(&fxp), sizeof(fxp));
     // FIXME - error if read != chunk size
     if ((mech::endian_read_int32BE(fxp.chunkMagic) != 'CcnK') ||
         (mech::endian_read_int32BE(fxp.fxMagic) != 'FPCh') ||
         (mech::endian_read_int32BE(fxp.fxID) != 'cjs3'))
     {
-        f.close();
+        f.reset();
         auto cm = mech::endian_read_int32BE(fxp.chunkMagic);
         auto fm = mech::endian_read_int32BE(fxp.fxMagic);
         auto id = mech::endian_read_int32BE(fxp.fxID);
@@ -272,12 +272,12 @@ bool SurgeSynthesizer::loadPatchByPath(const char *fxpPath, int categoryId, cons
     int cs = mech::endian_read_int32BE(fxp.chunkSize);
     std::unique_ptr<char[]> data{new char[cs]};
 
-    if (f.sgetn(data.get(), cs) != cs)
+    if (f->sgetn(data.get(), cs) != cs)
     {
         perror("Error while loading patch!");
     }
 
-    f.close();
+    f.reset();
 
     storage.getPatch().comment = "";
     storage.getPatch().author = "";
@@ -398,37 +398,125 @@ void SurgeSynthesizer::enqueuePatchForLoad(const void *data, int size)
         has_patchid_file = false;
         patchid_queue = -1;
     }
+
+    freeSpentLoads();
+
+    auto load = std::make_unique<EnqueuedLoad>();
+    load->data.reset(new char[size]);
+    memcpy(load->data.get(), data, size);
+    load->size = size;
+
+    rawLoadNeedsUIDawExtraState = false;
+
+    // if a prior load never got picked up, it is stale now so just drop it
+    std::unique_ptr<EnqueuedLoad> stale(enqueuedLoad.exchange(load.release()));
+}
+
+void SurgeSynthesizer::freeSpentLoads()
+{
+    auto *l = spentLoads.exchange(nullptr, std::memory_order_acquire);
+
+    while (l)
     {
-        std::lock_guard<std::mutex> g(rawLoadQueueMutex);
+        auto *next = l->nextSpent;
+        delete l;
+        l = next;
+    }
+}
+
+bool SurgeSynthesizer::enqueueParameterChange(const ID &id, float value01)
+{
+    auto w = parameterQueueWrite.load(std::memory_order_relaxed);
+
+    if (w - parameterQueueRead.load(std::memory_order_acquire) >= parameterQueueSize)
+        return false;
 
-        enqueuedLoadData.reset(new char[size]);
-        memcpy(enqueuedLoadData.get(), data, size);
-        enqueuedLoadSize = size;
-        rawLoadEnqueued = true;
-        rawLoadNeedsUIDawExtraState = false;
+    parameterQueue[w % parameterQueueSize] = {id.getSynthSideId(), value01};
+    parameterQueueWrite.store(w + 1, std::memory_order_release);
+
+    return true;
+}
+
+void SurgeSynthesizer::processQueuedParameterChanges()
+{
+    auto r = parameterQueueRead.load(std::memory_order_relaxed);
+    auto w = parameterQueueWrite.load(std::memory_order_acquire);
+
+    if (r == w)
+        return;
+
+    for (; r != w; ++r)
+    {
+        auto &c = parameterQueue[r % parameterQueueSize];
+        setParameter01(c.id, c.value01, true);
     }
+
+    parameterQueueRead.store(r, std::memory_order_release);
+    storage.getPatch().isDirty = true;
 }
 
-void SurgeSynthesizer::processEnqueuedPatchIfNeeded()
+void SurgeSynthesizer::processEnqueuedPatchIfNeeded(bool waitForLocks)
 {
-    bool expected = true;
-    if (rawLoadEnqueued.compare_exchange_weak(expected, true) && expected)
+    if (!enqueuedLoad.load(std::memory_order_acquire))
     {
+        return;
+    }
+
+    /*
+     * Both of these can be held by other threads for a while (the UI reading the extra state
+     * of the last load, or a background patch load), so on the audio thread rather than stall
+     * we leave the load in the mailbox and try again next block.
+     */
+    std::unique_lock<std::mutex> g(rawLoadQueueMutex, std::defer_lock);
+
+    if (waitForLocks)
+    {
+        g.lock();
+    }
+    else if (!g.try_lock())
+    {
+        return;
+    }
+
+    std::unique_ptr<EnqueuedLoad> load;
+
+    {
+        std::unique_lock<std::mutex> mg(patchLoadSpawnMutex, std::defer_lock);
+
+        if (waitForLocks)
+        {
+            mg.lock();
+        }
+        else if (!mg.try_lock())
         {
-            // If we are forcing values on, we don't want to do any enqueued loads
-            // or want to wait for them to complete
-            std::lock_guard<std::mutex> mg(patchLoadSpawnMutex);
-            has_patchid_file = false;
-            patchid_queue = -1;
+            return;
         }
-        std::lock_guard<std::mutex> g(rawLoadQueueMutex);
-        rawLoadEnqueued = false;
-        loadRaw(enqueuedLoadData.get(), enqueuedLoadSize);
-        loadFromDawExtraState();
 
-        rawLoadNeedsUIDawExtraState = true;
-        refresh_editor = true;
+        load.reset(enqueuedLoad.exchange(nullptr));
+
+        if (!load)
+        {
+            return;
+        }
+
+        // If we are forcing values on, we don't want to do any enqueued loads
+        // or want to wait for them to complete
+        has_patchid_file = false;
+        patchid_queue = -1;
     }
+
+    loadRaw(load->data.get(), load->size);
+    loadFromDawExtraState();
+
+    rawLoadNeedsUIDawExtraState = true;
+    refresh_editor = true;
+
+    // the buffer goes back to the enqueuing side to free, rather than being freed here
+    auto *spent = load.release();
+    spent->nextSpent = spentLoads.load(std::memory_order_relaxed);
+    while (!spentLoads.compare_exchange_weak(spent->nextSpent, spent, std::memory_order_release,
+                                             std::memory_order_relaxed))
+        ;
 }
 
 void SurgeSynthesizer::loadRaw(const void *data, int size, bool preset)
@@ -439,8 +527,12 @@ void SurgeSynthesizer::loadRaw(const void *data, int size, bool preset)
         for (int i = 0; i < n_customcontrollers; i++)
             storage.getPatch().scene[s].modsources[ms_ctrl1 + i]->reset();
 
-    storage.getPatch().init_default_values();
-    storage.getPatch().load_patch(data, size, preset);
+    {
+        std::lock_guard<std::recursive_mutex> lockModulation(storage.modRoutingMutex);
+        storage.getPatch().init_default_values();
+        storage.getPatch().load_patch(data, size, preset);
+        storage.publishModRouting();
+    }
     storage.getPatch().update_controls(false, nullptr, true);
     for (int i = 0; i < n_fx_slots; i++)
     {
@@ -660,4 +752,7 @@ void SurgeSynthesizer::savePatchToPath(fs::path filename, bool refreshPatchList)
     }
 }
 
-unsigned int SurgeSynthesizer::saveRaw(void **data) { return storage.getPatch().save_patch(data); }
+unsigned int SurgeSynthesizer::saveRaw(void **data, bool binaryState)
+{
+    return storage.getPatch().save_patch(data, binaryState);
+}
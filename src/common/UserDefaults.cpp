@@ -329,6 +329,14 @@ std::string defaultKeyToString(DefaultKey k)
         r = "ignoreMidiProgramChange";
         break;
 
+    case BinaryDAWState:
+        r = "binaryDAWState";
+        break;
+
+    case ParallelFXChains:
+        r = "parallelFXChains";
+        break;
+
     case DontShowAudioErrorsAgain:
         r = "dontShowAudioErrorsAgain";
         break;
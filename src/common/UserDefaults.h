@@ -159,6 +159,12 @@ enum DefaultKey
 
     IgnoreMIDIProgramChange,
 
+    // Save DAW state as a binary chunk, which older versions of Surge can't read
+    BinaryDAWState,
+
+    // Run the scene insert and send FX chains on worker threads
+    ParallelFXChains,
+
     DontShowAudioErrorsAgain,
 
     // OSC (Open Sound Control)
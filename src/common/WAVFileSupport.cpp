@@ -53,9 +53,9 @@ bool SurgeStorage::load_wt_wav_portable(std::string fn, Wavetable *wt)
     std::cout << "  fn = '" << fn << "'" << std::endl;
 #endif
 
-    std::filebuf fp;
+    auto fp = openDataFileForRead(string_to_path(fn));
 
-    if (!fp.open(string_to_path(fn), std::ios::binary | std::ios::in))
+    if (!fp)
     {
         std::ostringstream oss;
         oss << "Unable to open file '" << fn << "'!";
@@ -64,10 +64,10 @@ bool SurgeStorage::load_wt_wav_portable(std::string fn, Wavetable *wt)
     }
 
     char riff[4], szd[4], wav[4];
-    auto hds = fp.sgetn(riff, sizeof(riff));
+    auto hds = fp->sgetn(riff, sizeof(riff));
 
-    hds += fp.sgetn(szd, sizeof(szd));
-    hds += fp.sgetn(wav, sizeof(wav));
+    hds += fp->sgetn(szd, sizeof(szd));
+    hds += fp->sgetn(wav, sizeof(wav));
 
     if (hds != 12)
     {
@@ -112,12 +112,12 @@ bool SurgeStorage::load_wt_wav_portable(std::string fn, Wavetable *wt)
         char chunkType[4], chunkSzD[4];
         int br;
 
-        if (fp.sgetn(chunkType, sizeof(chunkType)) != sizeof(chunkType))
+        if (fp->sgetn(chunkType, sizeof(chunkType)) != sizeof(chunkType))
         {
             break;
         }
 
-        br = fp.sgetn(chunkSzD, sizeof(chunkSzD));
+        br = fp->sgetn(chunkSzD, sizeof(chunkSzD));
 
         // FIXME - deal with br
         int cs = pl_int(chunkSzD);
@@ -136,7 +136,7 @@ bool SurgeStorage::load_wt_wav_portable(std::string fn, Wavetable *wt)
         tbr += 8 + cs;
 
         char *data = (char *)malloc(cs);
-        br = fp.sgetn(data, cs);
+        br = fp->sgetn(data, cs);
 
         if (br != cs)
         {
@@ -75,6 +75,13 @@ class alignas(16) Effect
     } // for controllers that should run regardless of the audioprocess
     virtual bool process_ringout(float *dataL, float *dataR,
                                  bool indata_present = true); // returns rtue if outdata is present
+    // Whether process_ringout has stopped running us, i.e. we have been fed silence for at
+    // least get_ringout_decay() blocks and so are known to be silent ourselves
+    bool hasRungOut()
+    {
+        auto d = get_ringout_decay();
+        return !((d < 0) || (ringout < d) || (ringout == 0));
+    }
     // virtual void processSSE(float *dataL, float *dataR){ return; }
     // virtual void processSSE2(float *dataL, float *dataR){ return; }
     // virtual void processSSE3(float *dataL, float *dataR){ return; }
@@ -53,8 +53,8 @@ namespace sdsp = sst::basic_blocks::dsp;
 #define AssertReasonableAudioFloat(x)
 #endif
 
-template <int config, bool A, bool WS, bool B>
-void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *OutR)
+template <int blockSizeOS, int config, bool A, bool WS, bool B>
+void ProcessFBQuad(QuadFilterChainStateT<blockSizeOS> &d, fbq_global &g, float *OutL, float *OutR)
 {
     const __m128 hb_c = _mm_set1_ps(0.5f); // If this is changed from 0.5, make sure to change
                                            // this in the code because it is assumed to be half
@@ -63,7 +63,7 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
     switch (config)
     {
     case fc_serial1: // no feedback at all  (saves CPU)
-        for (int k = 0; k < BLOCK_SIZE_OS; k++)
+        for (int k = 0; k < blockSizeOS; k++)
         {
             __m128 input = d.DL[k];
             __m128 x = input, y = d.DR[k];
@@ -99,7 +99,7 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
         }
         break;
     case fc_serial2:
-        for (int k = 0; k < BLOCK_SIZE_OS; k++)
+        for (int k = 0; k < blockSizeOS; k++)
         {
             d.FB = _mm_add_ps(d.FB, d.dFB);
             __m128 input = vMul(d.FB, d.FBlineL);
@@ -139,7 +139,7 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
         break;
     case fc_serial3: // filter 2 is only heard in the feedback path, good for physical modelling
                      // with comb as f2
-        for (int k = 0; k < BLOCK_SIZE_OS; k++)
+        for (int k = 0; k < blockSizeOS; k++)
         {
             d.FB = _mm_add_ps(d.FB, d.dFB);
             __m128 input = vMul(d.FB, d.FBlineL);
@@ -180,7 +180,7 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
         }
         break;
     case fc_dual1:
-        for (int k = 0; k < BLOCK_SIZE_OS; k++)
+        for (int k = 0; k < blockSizeOS; k++)
         {
             d.FB = _mm_add_ps(d.FB, d.dFB);
             __m128 fb = _mm_mul_ps(d.FB, d.FBlineL);
@@ -213,7 +213,7 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
         }
         break;
     case fc_dual2:
-        for (int k = 0; k < BLOCK_SIZE_OS; k++)
+        for (int k = 0; k < blockSizeOS; k++)
         {
             d.FB = _mm_add_ps(d.FB, d.dFB);
             __m128 fb = _mm_mul_ps(d.FB, d.FBlineL);
@@ -246,7 +246,7 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
         }
         break;
     case fc_ring:
-        for (int k = 0; k < BLOCK_SIZE_OS; k++)
+        for (int k = 0; k < blockSizeOS; k++)
         {
             d.FB = _mm_add_ps(d.FB, d.dFB);
             __m128 fb = _mm_mul_ps(d.FB, d.FBlineL);
@@ -282,7 +282,7 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
         }
         break;
     case fc_stereo:
-        for (int k = 0; k < BLOCK_SIZE_OS; k++)
+        for (int k = 0; k < blockSizeOS; k++)
         {
             d.FB = _mm_add_ps(d.FB, d.dFB);
             __m128 fb = _mm_mul_ps(d.FB, d.FBlineL);
@@ -319,7 +319,7 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
         }
         break;
     case fc_wide:
-        for (int k = 0; k < BLOCK_SIZE_OS; k++)
+        for (int k = 0; k < blockSizeOS; k++)
         {
             d.FB = _mm_add_ps(d.FB, d.dFB);
             __m128 fbL = _mm_mul_ps(d.FB, d.FBlineL);
@@ -377,23 +377,24 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
     }
 }
 
-template <int config> FBQFPtr GetFBQPointer2(bool A, bool WS, bool B)
+template <int blockSizeOS, int config>
+FBQFPtrFor<blockSizeOS> GetFBQPointer2(bool A, bool WS, bool B)
 {
     if (A)
     {
         if (B)
         {
             if (WS)
-                return ProcessFBQuad<config, 1, 1, 1>;
+                return ProcessFBQuad<blockSizeOS, config, 1, 1, 1>;
             else
-                return ProcessFBQuad<config, 1, 0, 1>;
+                return ProcessFBQuad<blockSizeOS, config, 1, 0, 1>;
         }
         else
         {
             if (WS)
-                return ProcessFBQuad<config, 1, 1, 0>;
+                return ProcessFBQuad<blockSizeOS, config, 1, 1, 0>;
             else
-                return ProcessFBQuad<config, 1, 0, 0>;
+                return ProcessFBQuad<blockSizeOS, config, 1, 0, 0>;
         }
     }
     else
@@ -401,46 +402,48 @@ template <int config> FBQFPtr GetFBQPointer2(bool A, bool WS, bool B)
         if (B)
         {
             if (WS)
-                return ProcessFBQuad<config, 0, 1, 1>;
+                return ProcessFBQuad<blockSizeOS, config, 0, 1, 1>;
             else
-                return ProcessFBQuad<config, 0, 0, 1>;
+                return ProcessFBQuad<blockSizeOS, config, 0, 0, 1>;
         }
         else
         {
             if (WS)
-                return ProcessFBQuad<config, 0, 1, 0>;
+                return ProcessFBQuad<blockSizeOS, config, 0, 1, 0>;
             else
-                return ProcessFBQuad<config, 0, 0, 0>;
+                return ProcessFBQuad<blockSizeOS, config, 0, 0, 0>;
         }
     }
     return 0;
 }
 
-FBQFPtr GetFBQPointer(int config, bool A, bool WS, bool B)
+template <int blockSizeOS>
+FBQFPtrFor<blockSizeOS> GetFBQPointerFor(int config, bool A, bool WS, bool B)
 {
     switch (config)
     {
     case fc_serial1:
-        return GetFBQPointer2<fc_serial1>(A, WS, B);
+        return GetFBQPointer2<blockSizeOS, fc_serial1>(A, WS, B);
     case fc_serial2:
-        return GetFBQPointer2<fc_serial2>(A, WS, B);
+        return GetFBQPointer2<blockSizeOS, fc_serial2>(A, WS, B);
     case fc_serial3:
-        return GetFBQPointer2<fc_serial3>(A, WS, B);
+        return GetFBQPointer2<blockSizeOS, fc_serial3>(A, WS, B);
     case fc_dual1:
-        return GetFBQPointer2<fc_dual1>(A, WS, B);
+        return GetFBQPointer2<blockSizeOS, fc_dual1>(A, WS, B);
     case fc_dual2:
-        return GetFBQPointer2<fc_dual2>(A, WS, B);
+        return GetFBQPointer2<blockSizeOS, fc_dual2>(A, WS, B);
     case fc_ring:
-        return GetFBQPointer2<fc_ring>(A, WS, B);
+        return GetFBQPointer2<blockSizeOS, fc_ring>(A, WS, B);
     case fc_stereo:
-        return GetFBQPointer2<fc_stereo>(A, WS, B);
+        return GetFBQPointer2<blockSizeOS, fc_stereo>(A, WS, B);
     case fc_wide:
-        return GetFBQPointer2<fc_wide>(A, WS, B);
+        return GetFBQPointer2<blockSizeOS, fc_wide>(A, WS, B);
     }
     return 0;
 }
 
-void InitQuadFilterChainStateToZero(QuadFilterChainState *Q)
+template <int blockSizeOS>
+void InitQuadFilterChainStateToZero(QuadFilterChainStateT<blockSizeOS> *Q)
 {
     Q->Gain = _mm_setzero_ps();
     Q->FB = _mm_setzero_ps();
@@ -457,7 +460,7 @@ void InitQuadFilterChainStateToZero(QuadFilterChainState *Q)
     Q->FBlineL = _mm_setzero_ps();
     Q->FBlineR = _mm_setzero_ps();
 
-    for (auto i = 0; i < BLOCK_SIZE_OS; ++i)
+    for (auto i = 0; i < blockSizeOS; ++i)
     {
         Q->DL[i] = _mm_setzero_ps();
         Q->DR[i] = _mm_setzero_ps();
@@ -472,3 +475,8 @@ void InitQuadFilterChainStateToZero(QuadFilterChainState *Q)
     Q->dOut2L = _mm_setzero_ps();
     Q->dOut2R = _mm_setzero_ps();
 }
+
+template FBQFPtrFor<BLOCK_SIZE_OS> GetFBQPointerFor<BLOCK_SIZE_OS>(int, bool, bool, bool);
+template FBQFPtrFor<BLOCK_SIZE_OS / 2> GetFBQPointerFor<BLOCK_SIZE_OS / 2>(int, bool, bool, bool);
+template void InitQuadFilterChainStateToZero(QuadFilterChainStateT<BLOCK_SIZE_OS> *);
+template void InitQuadFilterChainStateToZero(QuadFilterChainStateT<BLOCK_SIZE_OS / 2> *);
@@ -125,8 +125,18 @@
 #include "sst/filters.h"
 #include "sst/waveshapers.h"
 
-struct QuadFilterChainState
+/*
+ * The chain only knows its block size through the length of DL and DR and the loops over
+ * them, so the state and ProcessFBQuad take it as a template parameter. That lets more than
+ * one size be built into a binary, with the caller choosing one when it makes its states.
+ * QuadFilterChain.cpp builds the engine's BLOCK_SIZE_OS and half that. The engine only uses
+ * the first so far; it is also the size the ramps (dGain and friends) are worked out for,
+ * so a caller running another size has to set those up for its own block.
+ */
+template <int blockSizeOS> struct QuadFilterChainStateT
 {
+    static constexpr int blockSize{blockSizeOS};
+
     sst::filters::QuadFilterUnitState FU[4];      // 2 filters left and right
     sst::waveshapers::QuadWaveshaperState WSS[2]; // 1 shaper left and right
 
@@ -135,18 +145,24 @@ struct QuadFilterChainState
 
     __m128 wsLPF, FBlineL, FBlineR;
 
-    __m128 DL[BLOCK_SIZE_OS], DR[BLOCK_SIZE_OS]; // wavedata
+    __m128 DL[blockSizeOS], DR[blockSizeOS]; // wavedata
 
     __m128 OutL, OutR, dOutL, dOutR;
     __m128 Out2L, Out2R, dOut2L, dOut2R; // fc_stereo only
 };
 
+// the engine's, and a struct of its own so the voice and synth headers can forward declare it
+struct QuadFilterChainState : QuadFilterChainStateT<BLOCK_SIZE_OS>
+{
+};
+
 /*
 ** I originally had this as a member but since moved it out of line so as to
 ** not run any risk of alignment problems in QuadFilterChainState where
 ** only the head of the array is __align_malloced
 */
-void InitQuadFilterChainStateToZero(QuadFilterChainState *Q);
+template <int blockSizeOS>
+void InitQuadFilterChainStateToZero(QuadFilterChainStateT<blockSizeOS> *Q);
 
 struct fbq_global
 {
@@ -154,8 +170,16 @@ struct fbq_global
     sst::waveshapers::QuadWaveshaperPtr WSptr;
 };
 
-typedef void (*FBQFPtr)(QuadFilterChainState &, fbq_global &, float *, float *);
+template <int blockSizeOS>
+using FBQFPtrFor = void (*)(QuadFilterChainStateT<blockSizeOS> &, fbq_global &, float *, float *);
+typedef FBQFPtrFor<BLOCK_SIZE_OS> FBQFPtr;
 
-FBQFPtr GetFBQPointer(int config, bool A, bool WS, bool B);
+// only the sizes QuadFilterChain.cpp instantiates will link
+template <int blockSizeOS>
+FBQFPtrFor<blockSizeOS> GetFBQPointerFor(int config, bool A, bool WS, bool B);
+inline FBQFPtr GetFBQPointer(int config, bool A, bool WS, bool B)
+{
+    return GetFBQPointerFor<BLOCK_SIZE_OS>(config, A, WS, B);
+}
 
 #endif // SURGE_SRC_COMMON_DSP_QUADFILTERCHAIN_H
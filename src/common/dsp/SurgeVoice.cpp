@@ -25,6 +25,7 @@
 #include "QuadFilterChain.h"
 #include "globals.h"
 #include <cmath>
+#include <algorithm>
 #ifndef SURGE_SKIP_ODDSOUND_MTS
 #include "libMTSClient.h"
 #endif
@@ -479,9 +480,9 @@ void SurgeVoice::switch_toggled()
     /*
      * Since we have updated the keytrack output here we need to re-update the localcopy modulators
      */
-    vector<ModulationRouting>::iterator iter;
-    iter = scene->modulation_voice.begin();
-    while (iter != scene->modulation_voice.end())
+    auto &modvoice = storage->currentModRouting()->voice[state.scene_id];
+    auto iter = modvoice.begin();
+    while (iter != modvoice.end())
     {
         int src_id = iter->source_id;
         int dst_id = iter->destination_id;
@@ -695,26 +696,41 @@ int SurgeVoice::routefilter(int r)
     return r;
 }
 
-template <bool first> void SurgeVoice::calc_ctrldata(QuadFilterChainState *Q, int e)
+void SurgeVoice::processLFO(int i)
 {
     // Always process LFO1 so the gate retrigger always work
-    lfo[0].process_block();
-    velocitySource.process_block();
+    if (i == 0)
+    {
+        lfo[0].process_block();
+    }
 
-    for (int i = 0; i < n_lfos_voice; i++)
+    if (scene->lfo[i].shape.val.i == lt_formula)
     {
-        if (scene->lfo[i].shape.val.i == lt_formula)
-        {
-            Surge::Formula::setupEvaluatorStateFrom(lfo[i].formulastate, storage->getPatch());
-            Surge::Formula::setupEvaluatorStateFrom(lfo[i].formulastate, this);
-        }
+        Surge::Formula::setupEvaluatorStateFrom(lfo[i].formulastate, storage->getPatch());
+        Surge::Formula::setupEvaluatorStateFrom(lfo[i].formulastate, this);
+    }
+
+    if (i != 0 && scene->modsource_doprocess[ms_lfo1 + i])
+    {
+        lfo[i].process_block();
+    }
+
+    lfosProcessedForBlock = true;
+}
 
-        if (i != 0 && scene->modsource_doprocess[ms_lfo1 + i])
+template <bool first> void SurgeVoice::calc_ctrldata(QuadFilterChainState *Q, int e)
+{
+    if (first || !lfosProcessedForBlock)
+    {
+        for (int i = 0; i < n_lfos_voice; i++)
         {
-            lfo[i].process_block();
+            processLFO(i);
         }
     }
 
+    lfosProcessedForBlock = false;
+    velocitySource.process_block();
+
     for (int i = 0; i < n_lfos_voice; ++i)
     {
         if (lfo[i].retrigger_AEG)
@@ -1200,6 +1216,27 @@ bool SurgeVoice::process_block(QuadFilterChainState &Q, int Qe)
     // pre-filter gain
     osclevels[le_pfg].multiply_2_blocks(output[0], output[1], BLOCK_SIZE_OS_QUAD);
 
+    if (startOffset > 0)
+    {
+        /*
+         * This note landed part way into its first block, so the whole voice runs that many
+         * samples late: each block goes on to the filters shifted along by the offset, with
+         * the end of the block before in front of it. The note starts, attack and all, where
+         * it landed rather than being cut to fit the rest of the block.
+         */
+        const int so = startOffset * OSC_OVERSAMPLING;
+        float tail alignas(16)[BLOCK_SIZE_OS];
+
+        for (int c = 0; c < 2; ++c)
+        {
+            std::copy(output[c] + BLOCK_SIZE_OS - so, output[c] + BLOCK_SIZE_OS, tail);
+            std::copy_backward(output[c], output[c] + BLOCK_SIZE_OS - so,
+                               output[c] + BLOCK_SIZE_OS);
+            std::copy(startOffsetCarry[c], startOffsetCarry[c] + so, output[c]);
+            std::copy(tail, tail + so, startOffsetCarry[c]);
+        }
+    }
+
     for (int i = 0; i < BLOCK_SIZE_OS; i++)
     {
         _mm_store_ss(((float *)&Q.DL[i] + Qe), _mm_load_ss(&output[0][i]));
@@ -1216,9 +1253,9 @@ bool SurgeVoice::process_block(QuadFilterChainState &Q, int Qe)
 
 template <bool noLFOSources> void SurgeVoice::applyModulationToLocalcopy()
 {
-    vector<ModulationRouting>::iterator iter;
-    iter = scene->modulation_voice.begin();
-    while (iter != scene->modulation_voice.end())
+    auto *routing = storage->currentModRouting();
+    auto iter = routing->voice[state.scene_id].begin();
+    while (iter != routing->voice[state.scene_id].end())
     {
         int src_id = iter->source_id;
         int dst_id = iter->destination_id;
@@ -1240,8 +1277,8 @@ template <bool noLFOSources> void SurgeVoice::applyModulationToLocalcopy()
         // See github issue 1214. This basically compensates for
         // channel AT being per-voice in MPE mode (since it is per channel)
         // vs per-scene (since it is per keyboard in non MPE mode).
-        iter = scene->modulation_scene.begin();
-        while (iter != scene->modulation_scene.end())
+        iter = routing->scene[state.scene_id].begin();
+        while (iter != routing->scene[state.scene_id].end())
         {
             int src_id = iter->source_id;
             if (src_id == ms_aftertouch && modsources[src_id])
@@ -65,6 +65,14 @@ class alignas(16) SurgeVoice
     SurgeVoiceState state;
     int age, age_release;
 
+    /*
+     * Samples into its first block at which this voice's note actually starts. The voice
+     * runs this far behind the block for its whole life, carrying the end of each block's
+     * oscillator output over to the start of the next.
+     */
+    int startOffset{0};
+    float startOffsetCarry alignas(16)[2][BLOCK_SIZE_OS]{};
+
     bool matchesChannelKeyId(int16_t channel, int16_t key, int32_t host_noteid);
 
     /*
@@ -206,6 +214,15 @@ class alignas(16) SurgeVoice
 
     void retriggerLFOEnvelopes();
     void retriggerOSCWithIndependentAttacks();
+
+    /*
+     * The synth runs each voice LFO across all voices of a scene before the voices render
+     * (see SurgeSynthesizer::processVoiceLFOs), so every voice walks the same shape and
+     * deform path back to back with its tables warm. processLFO runs one of them and marks
+     * the block so calc_ctrldata doesn't run it again.
+     */
+    void processLFO(int i);
+    bool lfosProcessedForBlock{false};
     void resetPortamentoFrom(int key, int channel);
 
     static float channelKeyEquvialent(float key, int channel, bool isMpeEnabled,
@@ -23,7 +23,7 @@
 #ifndef SURGE_SRC_COMMON_DSP_EFFECTS_GRAPHICEQ11BANDEFFECT_H
 #define SURGE_SRC_COMMON_DSP_EFFECTS_GRAPHICEQ11BANDEFFECT_H
 #include "Effect.h"
-#include "BiquadFilter.h"
+#include "BiquadCascade.h"
 #include "DSPUtils.h"
 #include "AllpassFilter.h"
 
@@ -75,7 +75,7 @@ class GraphicEQ11BandEffect : public Effect
         "30 Hz", "60 Hz", "120 Hz", "250 Hz", "500 Hz", "1 kHz",
         "2 kHz", "4 kHz", "8 kHz",  "12 kHz", "16 kHz",
     };
-    BiquadFilter band1, band2, band3, band4, band5, band6, band7, band8, band9, band10, band11;
+    BiquadCascade<geq11_gain> bands;
     int bi; // block increment (to keep track of events not occurring every n blocks)
 };
 
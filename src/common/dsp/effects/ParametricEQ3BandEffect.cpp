@@ -25,11 +25,9 @@
 
 ParametricEQ3BandEffect::ParametricEQ3BandEffect(SurgeStorage *storage, FxStorage *fxdata,
                                                  pdata *pd)
-    : Effect(storage, fxdata, pd), band1(storage), band2(storage), band3(storage)
+    : Effect(storage, fxdata, pd), bands(storage)
 {
-    band1.setBlockSize(BLOCK_SIZE * slowrate); // does not matter ATM as they're smoothed
-    band2.setBlockSize(BLOCK_SIZE * slowrate);
-    band3.setBlockSize(BLOCK_SIZE * slowrate);
+    bands.setBlockSize(BLOCK_SIZE * slowrate); // does not matter ATM as they're smoothed
 
     gain.set_blocksize(BLOCK_SIZE);
     mix.set_blocksize(BLOCK_SIZE);
@@ -40,27 +38,27 @@ ParametricEQ3BandEffect::~ParametricEQ3BandEffect() {}
 void ParametricEQ3BandEffect::init()
 {
     setvars(true);
-    band1.suspend();
-    band2.suspend();
-    band3.suspend();
+    bands.suspend();
     bi = 0;
 }
 
 void ParametricEQ3BandEffect::setvars(bool init)
 {
+    // each band is a gain, freq, bw triplet starting at eq3_gain1
+    static constexpr int stride = eq3_gain2 - eq3_gain1;
+
     if (init)
     {
         // Set the bands to 0dB so the EQ fades in init
-        band1.coeff_peakEQ(band1.calc_omega(fxdata->p[eq3_freq1].val.f * (1.f / 12.f)),
-                           fxdata->p[eq3_bw1].val.f, 1.f);
-        band2.coeff_peakEQ(band2.calc_omega(fxdata->p[eq3_freq2].val.f * (1.f / 12.f)),
-                           fxdata->p[eq3_bw2].val.f, 1.f);
-        band3.coeff_peakEQ(band3.calc_omega(fxdata->p[eq3_freq3].val.f * (1.f / 12.f)),
-                           fxdata->p[eq3_bw3].val.f, 1.f);
+        for (int i = 0; i < bands.size; ++i)
+        {
+            auto p0 = eq3_gain1 + i * stride;
+            bands.coeff_peakEQ(
+                i, bands[i].calc_omega(fxdata->p[p0 + 1].val.f * (1.f / 12.f)),
+                fxdata->p[p0 + 2].val.f, 1.f);
+        }
 
-        band1.coeff_instantize();
-        band2.coeff_instantize();
-        band3.coeff_instantize();
+        bands.coeff_instantize();
 
         gain.set_target(1.f);
         mix.set_target(1.f);
@@ -70,12 +68,12 @@ void ParametricEQ3BandEffect::setvars(bool init)
     }
     else
     {
-        band1.coeff_peakEQ(band1.calc_omega(*pd_float[eq3_freq1] * (1.f / 12.f)),
-                           *pd_float[eq3_bw1], *pd_float[eq3_gain1]);
-        band2.coeff_peakEQ(band2.calc_omega(*pd_float[eq3_freq2] * (1.f / 12.f)),
-                           *pd_float[eq3_bw2], *pd_float[eq3_gain2]);
-        band3.coeff_peakEQ(band3.calc_omega(*pd_float[eq3_freq3] * (1.f / 12.f)),
-                           *pd_float[eq3_bw3], *pd_float[eq3_gain3]);
+        for (int i = 0; i < bands.size; ++i)
+        {
+            auto p0 = eq3_gain1 + i * stride;
+            bands.coeff_peakEQ(i, bands[i].calc_omega(*pd_float[p0 + 1] * (1.f / 12.f)),
+                               *pd_float[p0 + 2], *pd_float[p0]);
+        }
     }
 }
 
@@ -89,12 +87,10 @@ void ParametricEQ3BandEffect::process(float *dataL, float *dataR)
     mech::copy_from_to<BLOCK_SIZE>(dataL, L);
     mech::copy_from_to<BLOCK_SIZE>(dataR, R);
 
-    if (!fxdata->p[eq3_gain1].deactivated)
-        band1.process_block(L, R);
-    if (!fxdata->p[eq3_gain2].deactivated)
-        band2.process_block(L, R);
-    if (!fxdata->p[eq3_gain3].deactivated)
-        band3.process_block(L, R);
+    bands.setActive(0, !fxdata->p[eq3_gain1].deactivated);
+    bands.setActive(1, !fxdata->p[eq3_gain2].deactivated);
+    bands.setActive(2, !fxdata->p[eq3_gain3].deactivated);
+    bands.process_block(L, R);
 
     gain.set_target_smoothed(storage->db_to_linear(*pd_float[eq3_gain]));
     gain.multiply_2_blocks(L, R, BLOCK_SIZE_QUAD);
@@ -23,7 +23,7 @@
 #ifndef SURGE_SRC_COMMON_DSP_EFFECTS_PARAMETRICEQ3BANDEFFECT_H
 #define SURGE_SRC_COMMON_DSP_EFFECTS_PARAMETRICEQ3BANDEFFECT_H
 #include "Effect.h"
-#include "BiquadFilter.h"
+#include "BiquadCascade.h"
 #include "DSPUtils.h"
 #include "AllpassFilter.h"
 
@@ -73,7 +73,7 @@ class ParametricEQ3BandEffect : public Effect
                                            int currentSynthStreamingRevision) override;
 
   private:
-    BiquadFilter band1, band2, band3;
+    BiquadCascade<3> bands;
     int bi; // block increment (to keep track of events not occurring every n blocks)
 };
 
@@ -31,15 +31,10 @@ namespace sdsp = sst::basic_blocks::dsp;
 float bend(float x, float b) { return (1.f + b) * x - b * x * x * x; }
 
 PhaserEffect::PhaserEffect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd)
-    : Effect(storage, fxdata, pd), lp(storage), hp(storage),
+    : Effect(storage, fxdata, pd), biquad(storage), lp(storage), hp(storage),
       modLFOL(storage->samplerate, storage->samplerate_inv),
       modLFOR(storage->samplerate, storage->samplerate_inv)
 {
-    for (int i = 0; i < n_bq_units; i++)
-    {
-        biquad[i] = new BiquadFilter(storage);
-    }
-
     n_bq_units_initialised = n_bq_units;
     feedback.setBlockSize(BLOCK_SIZE * slowrate);
     tone.setBlockSize(BLOCK_SIZE);
@@ -50,11 +45,7 @@ PhaserEffect::PhaserEffect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd)
     bi = 0;
 }
 
-PhaserEffect::~PhaserEffect()
-{
-    for (int i = 0; i < n_bq_units_initialised; i++)
-        delete biquad[i];
-}
+PhaserEffect::~PhaserEffect() {}
 
 void PhaserEffect::init()
 {
@@ -62,10 +53,7 @@ void PhaserEffect::init()
     dL = 0;
     dR = 0;
 
-    for (int i = 0; i < n_bq_units_initialised; i++)
-    {
-        biquad[i]->suspend();
-    }
+    biquad.suspend();
 
     mech::clear_block<BLOCK_SIZE>(L);
     mech::clear_block<BLOCK_SIZE>(R);
@@ -90,10 +78,11 @@ inline void PhaserEffect::init_stages()
 
     if (n_bq_units_initialised < n_bq_units)
     {
-        // we need to increase the number of stages
+        // we need to increase the number of stages. They all live in the cascade already,
+        // so just start the new ones from silence rather than allocate on the audio thread
         for (int k = n_bq_units_initialised; k < n_bq_units; k++)
         {
-            biquad[k] = new BiquadFilter(storage);
+            biquad[k].suspend();
         }
 
         n_bq_units_initialised = n_bq_units;
@@ -141,12 +130,12 @@ void PhaserEffect::setvars()
         // 4 stages in original phaser mode
         for (int i = 0; i < 2; i++)
         {
-            double omega = biquad[2 * i]->calc_omega(2 * *pd_float[ph_center] + legacy_freq[i] +
-                                                     legacy_span[i] * modLFOL.value());
-            biquad[2 * i]->coeff_APF(omega, 1.0 + 0.8 * *pd_float[ph_sharpness]);
-            omega = biquad[2 * i + 1]->calc_omega(2 * *pd_float[ph_center] + legacy_freq[i] +
-                                                  legacy_span[i] * modLFOR.value());
-            biquad[2 * i + 1]->coeff_APF(omega, 1.0 + 0.8 * *pd_float[ph_sharpness]);
+            double omega = biquad[2 * i].calc_omega(2 * *pd_float[ph_center] + legacy_freq[i] +
+                                                    legacy_span[i] * modLFOL.value());
+            biquad[2 * i].coeff_APF(omega, 1.0 + 0.8 * *pd_float[ph_sharpness]);
+            omega = biquad[2 * i + 1].calc_omega(2 * *pd_float[ph_center] + legacy_freq[i] +
+                                                 legacy_span[i] * modLFOR.value());
+            biquad[2 * i + 1].coeff_APF(omega, 1.0 + 0.8 * *pd_float[ph_sharpness]);
         }
     }
     else
@@ -155,13 +144,13 @@ void PhaserEffect::setvars()
         {
             double center = powf(2, (i + 1.0) * 2 / n_stages);
             double omega =
-                biquad[2 * i]->calc_omega(2 * *pd_float[ph_center] + *pd_float[ph_spread] * center +
-                                          2.0 / (i + 1) * modLFOL.value());
-            biquad[2 * i]->coeff_APF(omega, 1.0 + 0.8 * *pd_float[ph_sharpness]);
-            omega = biquad[2 * i + 1]->calc_omega(2 * *pd_float[ph_center] +
-                                                  *pd_float[ph_spread] * center +
-                                                  (2.0 / (i + 1) * modLFOR.value()));
-            biquad[2 * i + 1]->coeff_APF(omega, 1.0 + 0.8 * *pd_float[ph_sharpness]);
+                biquad[2 * i].calc_omega(2 * *pd_float[ph_center] + *pd_float[ph_spread] * center +
+                                         2.0 / (i + 1) * modLFOL.value());
+            biquad[2 * i].coeff_APF(omega, 1.0 + 0.8 * *pd_float[ph_sharpness]);
+            omega = biquad[2 * i + 1].calc_omega(2 * *pd_float[ph_center] +
+                                                 *pd_float[ph_spread] * center +
+                                                 (2.0 / (i + 1) * modLFOR.value()));
+            biquad[2 * i + 1].coeff_APF(omega, 1.0 + 0.8 * *pd_float[ph_sharpness]);
         }
     }
 
@@ -212,8 +201,8 @@ void PhaserEffect::process(float *dataL, float *dataR)
 
         for (int curr_stage = 0; curr_stage < n_stages; curr_stage++)
         {
-            dL = biquad[2 * curr_stage]->process_sample(dL);
-            dR = biquad[2 * curr_stage + 1]->process_sample(dR);
+            dL = biquad[2 * curr_stage].process_sample(dL);
+            dR = biquad[2 * curr_stage + 1].process_sample(dR);
         }
 
         L[i] = dL;
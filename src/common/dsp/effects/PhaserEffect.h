@@ -23,7 +23,7 @@
 #ifndef SURGE_SRC_COMMON_DSP_EFFECTS_PHASEREFFECT_H
 #define SURGE_SRC_COMMON_DSP_EFFECTS_PHASEREFFECT_H
 #include "Effect.h"
-#include "BiquadFilter.h"
+#include "BiquadCascade.h"
 #include "DSPUtils.h"
 #include "AllpassFilter.h"
 #include "ModControl.h"
@@ -78,7 +78,8 @@ class PhaserEffect : public Effect
     int n_bq_units = default_stages << 1;
     int n_bq_units_initialised = 0;
     float dL, dR;
-    BiquadFilter *biquad[max_stages * 2], lp, hp;
+    BiquadCascade<max_stages * 2> biquad;
+    BiquadFilter lp, hp;
     int bi; // block increment (to keep track of events not occurring every n blocks)
     void init_stages();
 
@@ -43,49 +43,108 @@ float Reverb2Effect::allpass::process(float in, float coeff)
     return result;
 }
 
-Reverb2Effect::delay::delay()
+Reverb2Effect::allpass4::allpass4()
+{
+    for (int b = 0; b < NUM_BLOCKS; ++b)
+    {
+        _k[b] = 0;
+        _len[b] = 1;
+    }
+    memset(_data, 0, sizeof(_data));
+}
+
+void Reverb2Effect::allpass4::setLen(int lane, int len)
+{
+    _len[lane] = std::clamp(len, 0, MAX_ALLPASS_LEN - 1);
+}
+
+__m128 Reverb2Effect::allpass4::process(__m128 in, __m128 coeff)
+{
+    for (int b = 0; b < NUM_BLOCKS; ++b)
+    {
+        _k[b]++;
+        if (_k[b] >= _len[b])
+            _k[b] = 0;
+    }
+
+    // gathered with a set rather than a load from an array, which would stall on the stores
+    auto dv = _mm_set_ps(_data[3][_k[3]], _data[2][_k[2]], _data[1][_k[1]], _data[0][_k[0]]);
+    auto delay_in = _mm_sub_ps(in, _mm_mul_ps(coeff, dv));
+    auto result = _mm_add_ps(dv, _mm_mul_ps(coeff, delay_in));
+
+    float d alignas(16)[NUM_BLOCKS];
+    _mm_store_ps(d, delay_in);
+    for (int b = 0; b < NUM_BLOCKS; ++b)
+        _data[b][_k[b]] = d[b];
+
+    return result;
+}
+
+Reverb2Effect::delay4::delay4()
 {
     _k = 0;
-    _len = 1;
-    memset(_data, 0, MAX_DELAY_LEN * sizeof(float));
+    for (int b = 0; b < NUM_BLOCKS; ++b)
+        _len[b] = 1;
+    memset(_data, 0, sizeof(_data));
 }
 
-void Reverb2Effect::delay::setLen(int len) { _len = std::clamp(len, 0, MAX_DELAY_LEN - 1); }
+void Reverb2Effect::delay4::setLen(int lane, int len)
+{
+    _len[lane] = std::clamp(len, 0, MAX_DELAY_LEN - 1);
+}
 
-float Reverb2Effect::delay::process(float in, int tap1, float &tap_out1, int tap2, float &tap_out2,
-                                    int modulation)
+__m128 Reverb2Effect::delay4::read(__m128i modulation, const int *tap1, float *tap_out1,
+                                   const int *tap2, float *tap_out2)
 {
     _k = (_k + 1) & DELAY_LEN_MASK;
 
-    tap_out1 = _data[(_k - tap1) & DELAY_LEN_MASK];
-    tap_out2 = _data[(_k - tap2) & DELAY_LEN_MASK];
+    auto modulation_int = _mm_srai_epi32(modulation, DELAY_SUBSAMPLE_BITS);
+    auto modulation_frac1 = _mm_and_si128(modulation, _mm_set1_epi32(DELAY_SUBSAMPLE_RANGE - 1));
+    auto modulation_frac2 = _mm_sub_epi32(_mm_set1_epi32(DELAY_SUBSAMPLE_RANGE), modulation_frac1);
+
+    int mi alignas(16)[NUM_BLOCKS];
+    _mm_store_si128((__m128i *)mi, modulation_int);
 
-    int modulation_int = modulation >> DELAY_SUBSAMPLE_BITS;
-    int modulation_frac1 = modulation & (DELAY_SUBSAMPLE_RANGE - 1);
-    int modulation_frac2 = DELAY_SUBSAMPLE_RANGE - modulation_frac1;
+    for (int b = 0; b < NUM_BLOCKS; ++b)
+    {
+        tap_out1[b] = _data[b][(_k - tap1[b]) & DELAY_LEN_MASK];
+        tap_out2[b] = _data[b][(_k - tap2[b]) & DELAY_LEN_MASK];
+    }
 
-    float d1 = _data[(_k - _len + modulation_int + 1) & DELAY_LEN_MASK];
-    float d2 = _data[(_k - _len + modulation_int) & DELAY_LEN_MASK];
-    const float multiplier = 1.f / (float)(DELAY_SUBSAMPLE_RANGE);
+    auto i1 = [&](int b) { return (_k - _len[b] + mi[b] + 1) & DELAY_LEN_MASK; };
+    auto i2 = [&](int b) { return (_k - _len[b] + mi[b]) & DELAY_LEN_MASK; };
+    auto d1 = _mm_set_ps(_data[3][i1(3)], _data[2][i1(2)], _data[1][i1(1)], _data[0][i1(0)]);
+    auto d2 = _mm_set_ps(_data[3][i2(3)], _data[2][i2(2)], _data[1][i2(1)], _data[0][i2(0)]);
 
-    float result = (d1 * (float)modulation_frac1 + d2 * (float)modulation_frac2) * multiplier;
-    _data[_k] = in;
+    const auto multiplier = _mm_set1_ps(1.f / (float)(DELAY_SUBSAMPLE_RANGE));
 
-    return result;
+    return _mm_mul_ps(
+        _mm_add_ps(_mm_mul_ps(d1, _mm_cvtepi32_ps(modulation_frac1)),
+                   _mm_mul_ps(d2, _mm_cvtepi32_ps(modulation_frac2))),
+        multiplier);
 }
 
-Reverb2Effect::onepole_filter::onepole_filter() { a0 = 0.f; }
+void Reverb2Effect::delay4::write(__m128 x)
+{
+    float d alignas(16)[NUM_BLOCKS];
+    _mm_store_ps(d, x);
+
+    for (int b = 0; b < NUM_BLOCKS; ++b)
+        _data[b][_k] = d[b];
+}
 
-float Reverb2Effect::onepole_filter::process_lowpass(float x, float c0)
+Reverb2Effect::onepole_filter::onepole_filter() { a0 = _mm_setzero_ps(); }
+
+__m128 Reverb2Effect::onepole_filter::process_lowpass(__m128 x, float c0)
 {
-    a0 = a0 * c0 + x * (1.f - c0);
+    a0 = _mm_add_ps(_mm_mul_ps(a0, _mm_set1_ps(c0)), _mm_mul_ps(x, _mm_set1_ps(1.f - c0)));
     return a0;
 }
 
-float Reverb2Effect::onepole_filter::process_highpass(float x, float c0)
+__m128 Reverb2Effect::onepole_filter::process_highpass(__m128 x, float c0)
 {
-    a0 = a0 * (1.f - c0) + x * c0;
-    return x - a0;
+    a0 = _mm_add_ps(_mm_mul_ps(a0, _mm_set1_ps(1.f - c0)), _mm_mul_ps(x, _mm_set1_ps(c0)));
+    return _mm_sub_ps(x, a0);
 }
 
 Reverb2Effect::Reverb2Effect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd)
@@ -126,21 +185,21 @@ void Reverb2Effect::calc_size(float scale)
     _input_allpass[2].setLen(msToSamples(10.13, m, storage->samplerate));
     _input_allpass[3].setLen(msToSamples(16.72, m, storage->samplerate));
 
-    _allpass[0][0].setLen(msToSamples(38.2, m, storage->samplerate));
-    _allpass[0][1].setLen(msToSamples(53.4, m, storage->samplerate));
-    _delay[0].setLen(msToSamples(178.8, m, storage->samplerate));
+    _allpass[0].setLen(0, msToSamples(38.2, m, storage->samplerate));
+    _allpass[1].setLen(0, msToSamples(53.4, m, storage->samplerate));
+    _delay.setLen(0, msToSamples(178.8, m, storage->samplerate));
 
-    _allpass[1][0].setLen(msToSamples(44.0, m, storage->samplerate));
-    _allpass[1][1].setLen(msToSamples(41, m, storage->samplerate));
-    _delay[1].setLen(msToSamples(126.5, m, storage->samplerate));
+    _allpass[0].setLen(1, msToSamples(44.0, m, storage->samplerate));
+    _allpass[1].setLen(1, msToSamples(41, m, storage->samplerate));
+    _delay.setLen(1, msToSamples(126.5, m, storage->samplerate));
 
-    _allpass[2][0].setLen(msToSamples(48.3, m, storage->samplerate));
-    _allpass[2][1].setLen(msToSamples(60.5, m, storage->samplerate));
-    _delay[2].setLen(msToSamples(106.1, m, storage->samplerate));
+    _allpass[0].setLen(2, msToSamples(48.3, m, storage->samplerate));
+    _allpass[1].setLen(2, msToSamples(60.5, m, storage->samplerate));
+    _delay.setLen(2, msToSamples(106.1, m, storage->samplerate));
 
-    _allpass[3][0].setLen(msToSamples(38.9, m, storage->samplerate));
-    _allpass[3][1].setLen(msToSamples(42.2, m, storage->samplerate));
-    _delay[3].setLen(msToSamples(139.4, m, storage->samplerate));
+    _allpass[0].setLen(3, msToSamples(38.9, m, storage->samplerate));
+    _allpass[1].setLen(3, msToSamples(42.2, m, storage->samplerate));
+    _delay.setLen(3, msToSamples(139.4, m, storage->samplerate));
 }
 
 void Reverb2Effect::setvars(bool init)
@@ -211,38 +270,44 @@ void Reverb2Effect::process(float *dataL, float *dataR)
         in = _input_allpass[1].process(in, _diffusion.v);
         in = _input_allpass[2].process(in, _diffusion.v);
         in = _input_allpass[3].process(in, _diffusion.v);
-        float x = _state;
 
+        auto hdc = limit_range(_hf_damp_coefficent.v, 0.01f, 0.99f);
+        auto ldc = limit_range(_lf_damp_coefficent.v, 0.01f, 0.99f);
+
+        // lane b is block b, and each block's lfo is a quarter turn on from the last
+        auto lfos = _mm_set_ps(-_lfo.i, -_lfo.r, _lfo.i, _lfo.r);
+        auto modulation = _mm_cvttps_epi32(
+            _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(_modulation.v), lfos),
+                       _mm_set1_ps((float)DELAY_SUBSAMPLE_RANGE)));
+
+        float tap_outL[NUM_BLOCKS], tap_outR[NUM_BLOCKS];
+        auto d = _delay.read(modulation, _tap_timeL, tap_outL, _tap_timeR, tap_outR);
+        d = _mm_mul_ps(d, _mm_set1_ps(_decay_multiply.v));
+
+        // each block is fed by the one before it, and the first by the last one's output
+        // from the previous sample
+        d = _mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 1, 0, 3));
+        float x = _mm_cvtss_f32(d);
+        auto xb = _mm_add_ps(_mm_move_ss(d, _mm_set_ss(_state)), _mm_set1_ps(in));
+
+        for (int c = 0; c < NUM_ALLPASSES_PER_BLOCK; c++)
+        {
+            xb = _allpass[c].process(xb, _mm_set1_ps(_buildup.v));
+        }
+
+        xb = _hf_damper.process_lowpass(xb, hdc);
+        xb = _lf_damper.process_highpass(xb, ldc);
+
+        _delay.write(xb);
+
+        // summed in block order so we match the scalar loop this replaced
         float outL = 0.f;
         float outR = 0.f;
 
-        float lfos[NUM_BLOCKS];
-        lfos[0] = _lfo.r;
-        lfos[1] = _lfo.i;
-        lfos[2] = -_lfo.r;
-        lfos[3] = -_lfo.i;
-
-        auto hdc = limit_range(_hf_damp_coefficent.v, 0.01f, 0.99f);
-        auto ldc = limit_range(_lf_damp_coefficent.v, 0.01f, 0.99f);
         for (int b = 0; b < NUM_BLOCKS; b++)
         {
-            x = x + in;
-            for (int c = 0; c < NUM_ALLPASSES_PER_BLOCK; c++)
-            {
-                x = _allpass[b][c].process(x, _buildup.v);
-            }
-
-            x = _hf_damper[b].process_lowpass(x, hdc);
-            x = _lf_damper[b].process_highpass(x, ldc);
-
-            int modulation = (int)(_modulation.v * lfos[b] * (float)DELAY_SUBSAMPLE_RANGE);
-            float tap_outL = 0.f;
-            float tap_outR = 0.f;
-            x = _delay[b].process(x, _tap_timeL[b], tap_outL, _tap_timeR[b], tap_outR, modulation);
-            outL += tap_outL * _tap_gainL[b];
-            outR += tap_outR * _tap_gainR[b];
-
-            x *= _decay_multiply.v;
+            outL += tap_outL[b] * _tap_gainL[b];
+            outR += tap_outR[b] * _tap_gainR[b];
         }
 
         wetL[k] = outL;
@@ -54,18 +54,39 @@ class Reverb2Effect : public Effect
         float _data[MAX_ALLPASS_LEN];
     };
 
-    class delay
+    /*
+     * The loop blocks look serial, but each block takes its input from the delay at the end
+     * of the block before it, which was written at least a delay length ago. So all four
+     * blocks can run side by side, one per SSE lane, as long as every delay is read before
+     * any of them is written. The lines for all four lanes sit in one contiguous array.
+     */
+    class allpass4
     {
       public:
-        delay();
-        float process(float x, int tap1, float &tap_out1, int tap2, float &tap_out2,
-                      int modulation);
-        void setLen(int len);
+        allpass4();
+        __m128 process(__m128 x, __m128 coeff);
+        void setLen(int lane, int len);
 
       private:
-        int _len;
+        int _len[NUM_BLOCKS];
+        int _k[NUM_BLOCKS];
+        float _data[NUM_BLOCKS][MAX_ALLPASS_LEN];
+    };
+
+    class delay4
+    {
+      public:
+        delay4();
+        // Advance a sample and return the modulated outputs, with the two output taps of each
+        __m128 read(__m128i modulation, const int *tap1, float *tap_out1, const int *tap2,
+                    float *tap_out2);
+        void write(__m128 x);
+        void setLen(int lane, int len);
+
+      private:
+        int _len[NUM_BLOCKS];
         int _k;
-        float _data[MAX_DELAY_LEN];
+        float _data[NUM_BLOCKS][MAX_DELAY_LEN];
     };
 
     class predelay
@@ -94,11 +115,11 @@ class Reverb2Effect : public Effect
     {
       public:
         onepole_filter();
-        float process_lowpass(float x, float c0);
-        float process_highpass(float x, float c0);
+        __m128 process_lowpass(__m128 x, float c0);
+        __m128 process_highpass(__m128 x, float c0);
 
       private:
-        float a0;
+        __m128 a0;
     };
 
     lipol_ps_blocksz mix alignas(16), width alignas(16);
@@ -141,10 +162,10 @@ class Reverb2Effect : public Effect
     void update_rtime();
     int ringout_time;
     allpass _input_allpass[NUM_INPUT_ALLPASSES];
-    allpass _allpass[NUM_BLOCKS][NUM_ALLPASSES_PER_BLOCK];
-    onepole_filter _hf_damper[NUM_BLOCKS];
-    onepole_filter _lf_damper[NUM_BLOCKS];
-    delay _delay[NUM_BLOCKS];
+    allpass4 _allpass[NUM_ALLPASSES_PER_BLOCK];
+    onepole_filter _hf_damper;
+    onepole_filter _lf_damper;
+    delay4 _delay;
     predelay _predelay;
     int _tap_timeL[NUM_BLOCKS];
     int _tap_timeR[NUM_BLOCKS];
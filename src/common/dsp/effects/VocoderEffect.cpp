@@ -45,6 +45,89 @@ const float vocoder_freq_vsm201[n_vocoder_bands] = {180,  219,  266,  324,  394,
 
 //------------------------------------------------------------------------------------------------
 
+VocoderModulatorAnalysis::VocoderModulatorAnalysis()
+{
+    for (int c = 0; c < 2; c++)
+    {
+        gain[c].set_blocksize(BLOCK_SIZE);
+
+        for (int j = 0; j < voc_vector_size; j++)
+            envState[c][j] = vZero;
+    }
+}
+
+//------------------------------------------------------------------------------------------------
+
+void VocoderModulatorAnalysis::setCoefficients()
+{
+    float Freq[4];
+
+    for (int j = 0; j < settings.groups && j < voc_vector_size; j++)
+    {
+        for (int b = 0; b < 4; b++)
+            Freq[b] = settings.freq[j * 4 + b];
+
+        band[0][j].SetCoeff(Freq, settings.Q, settings.spread);
+        band[1][j].CopyCoeff(band[0][j]);
+    }
+}
+
+//------------------------------------------------------------------------------------------------
+
+void VocoderModulatorAnalysis::process(float *inL, float *inR)
+{
+    vFloat Rate = vLoad1(settings.rate);
+    vFloat Ratem1 = vLoad1(1.f - settings.rate);
+    vFloat GateLevel = vLoad1(settings.gate * settings.gate);
+    const vFloat MaxLevel = vLoad1(6.f);
+
+    // mono and one sided modes analyse one channel, through the left bands and followers
+    gain[0].set_target_smoothed(settings.gain);
+    gain[1].set_target_smoothed(settings.gain);
+
+    float *in[2] = {inL, inR};
+    int channels = 1;
+
+    if (settings.mode == VocoderEffect::vim_stereo)
+    {
+        gain[0].multiply_block(inL, BLOCK_SIZE_QUAD);
+        gain[1].multiply_block(inR, BLOCK_SIZE_QUAD);
+        channels = 2;
+    }
+    else if (settings.mode == VocoderEffect::vim_right)
+    {
+        gain[1].multiply_block(inR, BLOCK_SIZE_QUAD);
+        in[0] = inR;
+    }
+    else
+    {
+        gain[0].multiply_block(inL, BLOCK_SIZE_QUAD);
+    }
+
+    // a band group at a time, so its filter and follower stay in registers for the block
+    for (int c = 0; c < channels; c++)
+    {
+        for (int j = 0; j < settings.groups && j < voc_vector_size; j++)
+        {
+            auto &f = band[c][j];
+            auto e = envState[c][j];
+
+            for (int k = 0; k < BLOCK_SIZE; k++)
+            {
+                vFloat Mod = f.CalcBPF(vLoad1(in[c][k]));
+                Mod = vMin(vMul(Mod, Mod), MaxLevel);
+                Mod = vAnd(Mod, vCmpGE(Mod, GateLevel));
+                e = vMAdd(e, Ratem1, vMul(Rate, Mod));
+                env[c][j][k] = vSqrtFast(e);
+            }
+
+            envState[c][j] = e;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------
+
 VocoderEffect::VocoderEffect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd)
     : Effect(storage, fxdata, pd), mBI(0)
 {
@@ -54,13 +137,6 @@ VocoderEffect::VocoderEffect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd
     mUnvoicedLevel = 0.f;*/
 
     active_bands = n_vocoder_bands;
-    mGain.set_blocksize(BLOCK_SIZE);
-    mGainR.set_blocksize(BLOCK_SIZE);
-    for (int i = 0; i < voc_vector_size; i++)
-    {
-        mEnvF[i] = vZero;
-        mEnvFR[i] = vZero;
-    }
 }
 
 //------------------------------------------------------------------------------------------------
@@ -77,7 +153,7 @@ void VocoderEffect::setvars(bool init)
 {
     modulator_mode = *pd_float[voc_mod_input];
     wet = *pd_float[voc_mix];
-    float Freq[4], FreqM[4];
+    float Freq[4];
 
     const float Q = 20.f * (1.f + 0.5f * *pd_float[voc_q]);
     const float Spread = 0.4f / Q;
@@ -133,38 +209,30 @@ void VocoderEffect::setvars(bool init)
         mdhz = pow(2.f, dM / 12.f);
     }
 
+    auto &as = mAnalysis.settings;
+    as.groups = active_bands >> 2;
+    as.Q = Q;
+    as.spread = Spread;
+    std::fill(std::begin(as.freq), std::end(as.freq), 0.f);
+
     for (int i = 0; i < active_bands && i < n_vocoder_bands; i++)
     {
         Freq[i & 3] = fb * storage->samplerate_inv;
-        FreqM[i & 3] = mb * storage->samplerate_inv;
+        // without its own range, the modulator listens through the carrier's bands
+        as.freq[i] = (sepMod ? mb : fb) * storage->samplerate_inv;
 
         if ((i & 3) == 3)
         {
             int j = i >> 2;
             mCarrierL[j].SetCoeff(Freq, Q, Spread);
             mCarrierR[j].CopyCoeff(mCarrierL[j]);
-            if (sepMod)
-            {
-                mModulator[j].SetCoeff(FreqM, Q, Spread);
-                if (modulator_mode == vim_stereo)
-                {
-                    mModulatorR[j].SetCoeff(FreqM, Q, Spread);
-                }
-                else
-                {
-                    mModulatorR[j].CopyCoeff(mModulator[j]);
-                }
-            }
-            else
-            {
-                mModulator[j].CopyCoeff(mCarrierL[j]);
-                mModulatorR[j].CopyCoeff(mCarrierR[j]);
-            }
         }
         fb *= dhz;
         mb *= mdhz;
     }
 
+    mAnalysis.setCoefficients();
+
     /*mVoicedDetect.coeff_LP(BiquadFilter::calc_omega_from_Hz(1000.f), 0.707);
     mUnvoicedDetect.coeff_HP(BiquadFilter::calc_omega_from_Hz(5000.f), 0.707);
 
@@ -189,7 +257,6 @@ void VocoderEffect::process(float *dataL, float *dataR)
     wet = *pd_float[voc_mix];
     float EnvFRate = 0.001f * powf(2.f, 4.f * *pd_float[voc_envfollow]);
 
-    // the left channel variables are used for mono when stereo is disabled
     float modulator_in alignas(16)[BLOCK_SIZE];
     float modulator_inR alignas(16)[BLOCK_SIZE];
 
@@ -205,115 +272,86 @@ void VocoderEffect::process(float *dataL, float *dataR)
     }
 
     float Gain = *pd_float[voc_input_gain] + 24.f;
-    mGain.set_target_smoothed(storage->db_to_linear(Gain));
-    mGain.multiply_block(modulator_in, BLOCK_SIZE_QUAD);
-
-    mGainR.set_target_smoothed(storage->db_to_linear(Gain));
-    mGainR.multiply_block(modulator_inR, BLOCK_SIZE_QUAD);
-
-    vFloat Rate = vLoad1(EnvFRate);
-    vFloat Ratem1 = vLoad1(1.f - EnvFRate);
 
-    float Gate = storage->db_to_linear(*pd_float[voc_input_gate] + Gain);
-    vFloat GateLevel = vLoad1(Gate * Gate);
+    auto &as = mAnalysis.settings;
+    as.mode = modulator_mode;
+    as.gain = storage->db_to_linear(Gain);
+    as.gate = storage->db_to_linear(*pd_float[voc_input_gate] + Gain);
+    as.rate = EnvFRate;
 
-    const vFloat MaxLevel = vLoad1(6.f);
-
-    // Voiced / Unvoiced detection
-    /*   mVoicedDetect.process_block_to(modulator_in, modulator_tbuf);
-       float a = min(4.f, get_squaremax(modulator_tbuf,BLOCK_SIZE_QUAD));
-       mVoicedLevel = mVoicedLevel * (1.f - EnvFRate) + a * EnvFRate;
-
-       mUnvoicedDetect.process_block_to(modulator_in, modulator_tbuf);
-       a = min(4.f, get_squaremax(modulator_tbuf, BLOCK_SIZE_QUAD));
-       mUnvoicedLevel = mUnvoicedLevel * (1.f - EnvFRate) + a * EnvFRate;
+    analyseModulator(modulator_in, modulator_inR);
 
-       float Ratio = db_to_linear(*pd_float[voc_unvoiced_threshold]);
+    // the carrier bank, again a band group at a time over the block
+    vFloat LeftSum alignas(16)[BLOCK_SIZE], RightSum alignas(16)[BLOCK_SIZE];
 
-       if (mUnvoicedLevel > (mVoicedLevel * Ratio))
-         // mix carrier with noise
-         for(int i = 0; i < BLOCK_SIZE; i++)
-         {
-            float rand11 = storage->rand_pm1();
-            dataL[i] = rand11;
-            rand11 = storage->rand_pm1();
-            dataR[i] = rand11;
-         }*/
-
-    if (modulator_mode == vim_mono || modulator_mode == vim_left || modulator_mode == vim_right)
+    for (int k = 0; k < BLOCK_SIZE; k++)
     {
-        float *input;
+        LeftSum[k] = vZero;
+        RightSum[k] = vZero;
+    }
 
-        if (modulator_mode == vim_mono || modulator_mode == vim_left)
-        {
-            input = modulator_in;
-        }
-        else
-        {
-            input = modulator_inR;
-        }
+    auto &envL = mAnalysis.env[0];
+    auto &envR = mAnalysis.env[modulator_mode == vim_stereo ? 1 : 0];
 
+    for (int j = 0; (j < (active_bands >> 2)) && (j < voc_vector_size); j++)
+    {
         for (int k = 0; k < BLOCK_SIZE; k++)
         {
-            vFloat In = vLoad1(input[k]);
+            LeftSum[k] =
+                vAdd(LeftSum[k], mCarrierL[j].CalcBPF(vMul(vLoad1(dataL[k]), envL[j][k])));
+            RightSum[k] =
+                vAdd(RightSum[k], mCarrierR[j].CalcBPF(vMul(vLoad1(dataR[k]), envR[j][k])));
+        }
+    }
 
-            vFloat Left = vLoad1(dataL[k]);
-            vFloat Right = vLoad1(dataR[k]);
+    float inMul = 1.0 - wet;
 
-            vFloat LeftSum = vZero;
-            vFloat RightSum = vZero;
+    for (int k = 0; k < BLOCK_SIZE; k++)
+    {
+        dataL[k] = dataL[k] * inMul + wet * vSum(LeftSum[k]) * 4.f;
+        dataR[k] = dataR[k] * inMul + wet * vSum(RightSum[k]) * 4.f;
+    }
+}
 
-            for (int j = 0; (j < (active_bands >> 2)) && (j < voc_vector_size); j++)
-            {
-                vFloat Mod = mModulator[j].CalcBPF(In);
-                Mod = vMin(vMul(Mod, Mod), MaxLevel);
-                Mod = vAnd(Mod, vCmpGE(Mod, GateLevel));
-                mEnvF[j] = vMAdd(mEnvF[j], Ratem1, vMul(Rate, Mod));
-                Mod = vSqrtFast(mEnvF[j]);
+//------------------------------------------------------------------------------------------------
 
-                LeftSum = vAdd(LeftSum, mCarrierL[j].CalcBPF(vMul(Left, Mod)));
-                RightSum = vAdd(RightSum, mCarrierR[j].CalcBPF(vMul(Right, Mod)));
-            }
+void VocoderEffect::analyseModulator(float *inL, float *inR)
+{
+    auto *cache = storage->vocoderAnalysis.get();
+    auto block = storage->blockNumber;
 
-            float inMul = 1.0 - wet;
-            dataL[k] = dataL[k] * inMul + wet * vSum(LeftSum) * 4.f;
-            dataR[k] = dataR[k] * inMul + wet * vSum(RightSum) * 4.f;
-        }
+    // nothing numbers the blocks outside the synth, so there we can't tell a fresh result
+    if (!cache || block == 0)
+    {
+        mAnalysis.process(inL, inR);
+        return;
     }
-    else if (modulator_mode == vim_stereo)
+
+    /*
+     * FX chains may run on several threads, so never wait for the cache: if someone else has
+     * it, doing the analysis ourselves is as quick as waiting and always correct.
+     */
     {
-        for (int k = 0; k < BLOCK_SIZE; k++)
+        std::unique_lock<std::mutex> g(cache->mutex, std::try_to_lock);
+
+        if (g.owns_lock() && cache->block == block &&
+            cache->analysis.settings == mAnalysis.settings)
         {
-            vFloat InL = vLoad1(modulator_in[k]);
-            vFloat InR = vLoad1(modulator_inR[k]);
-            vFloat Left = vLoad1(dataL[k]);
-            vFloat Right = vLoad1(dataR[k]);
+            mAnalysis = cache->analysis;
+            cache->shared++;
+            return;
+        }
+    }
 
-            vFloat LeftSum = vZero;
-            vFloat RightSum = vZero;
+    mAnalysis.process(inL, inR);
 
-            for (int j = 0; j < (active_bands >> 2) && j < (n_vocoder_bands >> 2); j++)
-            {
-                vFloat ModL = mModulator[j].CalcBPF(InL);
-                vFloat ModR = mModulatorR[j].CalcBPF(InR);
-                ModL = vMin(vMul(ModL, ModL), MaxLevel);
-                ModR = vMin(vMul(ModR, ModR), MaxLevel);
-
-                ModL = vAnd(ModL, vCmpGE(ModL, GateLevel));
-                ModR = vAnd(ModR, vCmpGE(ModR, GateLevel));
-
-                mEnvF[j] = vMAdd(mEnvF[j], Ratem1, vMul(Rate, ModL));
-                mEnvFR[j] = vMAdd(mEnvFR[j], Ratem1, vMul(Rate, ModR));
-                ModL = vSqrtFast(mEnvF[j]);
-                ModR = vSqrtFast(mEnvFR[j]);
-                LeftSum = vAdd(LeftSum, mCarrierL[j].CalcBPF(vMul(Left, ModL)));
-                RightSum = vAdd(RightSum, mCarrierR[j].CalcBPF(vMul(Right, ModR)));
-            }
+    std::unique_lock<std::mutex> g(cache->mutex, std::try_to_lock);
 
-            float inMul = 1.0 - wet;
-            dataL[k] = dataL[k] * inMul + wet * vSum(LeftSum) * 4.f;
-            dataR[k] = dataR[k] * inMul + wet * vSum(RightSum) * 4.f;
-        }
+    // the first analysis of a block is the one on offer for the rest of it
+    if (g.owns_lock() && cache->block != block)
+    {
+        cache->analysis = mAnalysis;
+        cache->block = block;
     }
 }
 
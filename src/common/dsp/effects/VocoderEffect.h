@@ -31,9 +31,69 @@
 
 #include <vembertech/lipol.h>
 
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+
 const int n_vocoder_bands = 20;
 const int voc_vector_size = n_vocoder_bands >> 2;
 
+/*
+ * The modulator half of the vocoder: input gain, band filters and envelope followers, run a
+ * band group at a time over the whole block to give every band's envelope at every sample.
+ * The result depends only on the audio input, these settings and the state, so vocoders in one
+ * instance listening with the same settings share one analysis per block through
+ * VocoderAnalysisCache rather than each running their own.
+ */
+struct VocoderModulatorAnalysis
+{
+    struct Settings
+    {
+        int mode{-1};
+        int groups{0};
+        float gain{0.f}, gate{0.f}, rate{0.f};
+        float Q{0.f}, spread{0.f};
+        float freq[n_vocoder_bands]{};
+
+        bool operator==(const Settings &o) const
+        {
+            return mode == o.mode && groups == o.groups && gain == o.gain && gate == o.gate &&
+                   rate == o.rate && Q == o.Q && spread == o.spread &&
+                   std::equal(std::begin(freq), std::end(freq), std::begin(o.freq));
+        }
+    };
+
+    VocoderModulatorAnalysis();
+
+    // Takes the band frequencies, Q and spread from settings
+    void setCoefficients();
+    // Analyses a block of gain staged modulator input; inR is only read in stereo mode
+    void process(float *inL, float *inR);
+
+    Settings settings;
+
+    // the right channel ones are only used in stereo mode
+    VectorizedSVFilter band alignas(16)[2][voc_vector_size];
+    vFloat envState alignas(16)[2][voc_vector_size];
+    lipol_ps_blocksz gain alignas(16)[2];
+
+    // square root of each band's envelope at each sample of the last block
+    vFloat env alignas(16)[2][voc_vector_size][BLOCK_SIZE];
+};
+
+/*
+ * The analysis the first vocoder made this block, for any other with the same settings to
+ * pick up. It is the storage's, and only the synth creates one, since only it numbers its
+ * blocks (see SurgeStorage::blockNumber).
+ */
+struct VocoderAnalysisCache
+{
+    std::mutex mutex;
+    uint64_t block{0};
+    uint64_t shared{0}; // how many analyses were picked up rather than run, for the tests
+    VocoderModulatorAnalysis analysis;
+};
+
 class VocoderEffect : public Effect
 {
   public:
@@ -86,14 +146,12 @@ class VocoderEffect : public Effect
                                            int currentSynthStreamingRevision) override;
 
   private:
+    // Fills mAnalysis for this block, from the cache if another vocoder already has
+    void analyseModulator(float *inL, float *inR);
+
     VectorizedSVFilter mCarrierL alignas(16)[voc_vector_size];
     VectorizedSVFilter mCarrierR alignas(16)[voc_vector_size];
-    VectorizedSVFilter mModulator alignas(16)[voc_vector_size];
-    VectorizedSVFilter mModulatorR alignas(16)[voc_vector_size];
-    vFloat mEnvF alignas(16)[voc_vector_size];
-    vFloat mEnvFR alignas(16)[voc_vector_size];
-    lipol_ps_blocksz mGain alignas(16);
-    lipol_ps_blocksz mGainR alignas(16);
+    VocoderModulatorAnalysis mAnalysis;
     int modulator_mode;
     float wet;
     int mBI; // block increment (to keep track of events not occurring every n blocks)
@@ -0,0 +1,181 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+#ifndef SURGE_SRC_COMMON_DSP_FILTERS_BIQUADCASCADE_H
+#define SURGE_SRC_COMMON_DSP_FILTERS_BIQUADCASCADE_H
+
+#include "BiquadFilter.h"
+
+#include <array>
+#include <cmath>
+#include <utility>
+
+/*
+ * A fixed bank of stereo biquads run one after the other, for the EQs, the phaser and the
+ * scene low cut. Each biquad already runs left and right side by side in one SSE register,
+ * so what the bank adds is knowing which bands it can leave out of the chain.
+ *
+ * A band is skipped if it has been switched off with setActive(), or if it is a peaking band
+ * whose gain has sat at 0 dB long enough for its coefficient smoothing to land on the
+ * identity filter. At that point running it is a (slow) copy, so we snap its coefficients
+ * onto the target and stop calling it until the gain moves again, when it glides away from
+ * the identity exactly as it would have done otherwise. Most bands of a graphic EQ spend
+ * most of their lives at 0 dB.
+ */
+template <int N> class BiquadCascade
+{
+  public:
+    static constexpr int size = N;
+
+    explicit BiquadCascade(SurgeStorage *storage)
+        : BiquadCascade(storage, std::make_index_sequence<N>())
+    {
+    }
+
+    BiquadFilter &operator[](int i) { return bands[i]; }
+    const BiquadFilter &operator[](int i) const { return bands[i]; }
+
+    void setBlockSize(int bs)
+    {
+        for (auto &b : bands)
+            b.setBlockSize(bs);
+    }
+
+    void suspend()
+    {
+        for (int i = 0; i < N; ++i)
+        {
+            bands[i].suspend();
+            flatSamples[i] = 0;
+            settled[i] = false;
+        }
+    }
+
+    void coeff_instantize()
+    {
+        for (auto &b : bands)
+            b.coeff_instantize();
+    }
+
+    // Like BiquadFilter::coeff_peakEQ, but notices when the band has gone flat
+    void coeff_peakEQ(int i, double omega, double BW, double gain)
+    {
+        bands[i].coeff_peakEQ(omega, BW, gain);
+
+        if (std::fabs(gain) < flatGain)
+        {
+            flat[i] = true;
+        }
+        else
+        {
+            flat[i] = false;
+            settled[i] = false;
+            flatSamples[i] = 0;
+        }
+    }
+
+    // Bands default to active. Switching one off leaves its state alone, like not calling it.
+    void setActive(int i, bool a) { active[i] = a; }
+
+    // Whether process_block would run band i right now
+    bool isProcessing(int i) const { return active[i] && !settled[i]; }
+
+    void process_block(float *dataL, float *dataR)
+    {
+        for (int i = 0; i < N; ++i)
+        {
+            if (!isProcessing(i))
+                continue;
+
+            bands[i].process_block(dataL, dataR);
+            noteProcessed(i);
+        }
+    }
+
+    /*
+     * The same filtering as process_block, but sample by sample through every band in turn
+     * and then through post (any float(float), such as a clipper) on the way out, so the
+     * bank and whatever follows it are one pass over the block instead of one per band.
+     */
+    template <typename Post> void process_block_fused(float *dataL, float *dataR, Post post)
+    {
+        int run[N];
+        int nRun = 0;
+
+        for (int i = 0; i < N; ++i)
+        {
+            if (isProcessing(i))
+                run[nRun++] = i;
+        }
+
+        for (int k = 0; k < BLOCK_SIZE; ++k)
+        {
+            float L = dataL[k], R = dataR[k];
+
+            for (int r = 0; r < nRun; ++r)
+                bands[run[r]].process_sample(L, R, L, R);
+
+            dataL[k] = post(L);
+            dataR[k] = post(R);
+        }
+
+        for (int r = 0; r < nRun; ++r)
+            noteProcessed(run[r]);
+    }
+
+  private:
+    void noteProcessed(int i)
+    {
+        if (flat[i])
+        {
+            flatSamples[i] += BLOCK_SIZE;
+
+            if (flatSamples[i] >= storage->samplerate * settleSeconds)
+            {
+                bands[i].coeff_instantize();
+                settled[i] = true;
+            }
+        }
+    }
+
+    template <size_t... I>
+    BiquadCascade(SurgeStorage *s, std::index_sequence<I...>)
+        : storage(s), bands{{((void)I, s)...}}
+    {
+        active.fill(true);
+        flat.fill(false);
+        settled.fill(false);
+        flatSamples.fill(0);
+    }
+
+    // Far enough under the point where the peaking design returns the identity filter
+    static constexpr double flatGain = 1e-5;
+
+    // Much longer than the biquad coefficient smoothing takes to converge
+    static constexpr float settleSeconds = 0.25f;
+
+    SurgeStorage *storage;
+    std::array<BiquadFilter, N> bands;
+    std::array<bool, N> active, flat, settled;
+    std::array<int, N> flatSamples;
+};
+
+#endif // SURGE_SRC_COMMON_DSP_FILTERS_BIQUADCASCADE_H
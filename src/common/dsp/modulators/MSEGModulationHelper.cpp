@@ -22,6 +22,7 @@
 
 #include "MSEGModulationHelper.h"
 #include <cmath>
+#include <algorithm>
 #include <iostream>
 #include "DebugHelpers.h"
 #include "basic_dsp.h" // for limit_range
@@ -32,6 +33,209 @@ namespace Surge
 namespace MSEG
 {
 
+/*
+ * The shape parameters which only depend on a segment's control point. These are solved
+ * once per segment in rebuildCache, but valueAt falls back to calling them directly when
+ * the cache is stale, so keep them the single source of truth for the math.
+ */
+static float controlPointCurve(float cpv)
+{
+    /*
+     * Alright so we have a functional form (e^ax-1)/(e^a-1) = y;
+     * We also know that since we have vertical only motion here x = 1/2 and y is where we want
+     * to hit ( specifically since we are generating a 0,1 line and cpv is -1,1 then
+     * here we get y = 0.5 * cpv + 0.5.
+     *
+     * Fine so lets show our work. I'm going to use X and V for now
+     *
+     * (e^aX-1)/(e^a-1) = V  @ x=1/2
+     * introduce Q = e^a/2
+     * (Q - 1) / ( Q^2 - 1 ) = V
+     * Q - 1 = V Q^2 - V
+     * V Q^2 - Q + ( 1-V ) = 0
+     *
+     * OK cool we know how to solve that (for V != 0)
+     *
+     * Q = (1 +/- sqrt( 1 - 4 * V * (1-V) )) / 2 V
+     *
+     * and since Q = e^a/2
+     *
+     * a = 2 * log(Q)
+     *
+     */
+
+    float V = 0.5 * cpv + 0.5;
+    float amul = 1;
+
+    if (V < 0.5)
+    {
+        amul = -1;
+        V = 1 - V;
+    }
+
+    float disc = (1 - 4 * V * (1 - V));
+    float a = 0;
+
+    if (fabs(V) > 1e-3)
+    {
+        float Q = limit_range((1 - sqrt(disc)) / (2 * V), 0.00001f, 1000000.f);
+        a = amul * 2 * log(Q);
+    }
+
+    return a;
+}
+
+static int controlPointSteps(MSEGStorage::segment::Type type, float cpv)
+{
+    switch (type)
+    {
+    case MSEGStorage::segment::SINE:
+    case MSEGStorage::segment::SAWTOOTH:
+    case MSEGStorage::segment::TRIANGLE:
+    case MSEGStorage::segment::SQUARE:
+    {
+        float pct = (cpv + 1) * 0.5;
+        float as = 5.0;
+        float scaledpct = (exp(as * pct) - 1) / (exp(as) - 1);
+
+        return (int)(scaledpct * 100);
+    }
+    case MSEGStorage::segment::STAIRS:
+    case MSEGStorage::segment::SMOOTH_STAIRS:
+    {
+        auto pct = (cpv + 1) * 0.5;
+        auto as = 5.0;
+        auto scaledpct = (exp(as * pct) - 1) / (exp(as) - 1);
+
+        return (int)(scaledpct * 100) + 2;
+    }
+    default:
+        break;
+    }
+
+    return 0;
+}
+
+static const MSEGStorage::segmentShape *cachedShapeFor(const MSEGStorage *ms, int idx)
+{
+    if (ms->cachedSegments != ms->n_activeSegments || idx < 0 || idx >= ms->cachedSegments)
+    {
+        return nullptr;
+    }
+
+    auto &sh = ms->shapeCache[idx];
+    auto &r = ms->segments[idx];
+
+    if (sh.cpv != r.cpv || sh.type != r.type)
+    {
+        return nullptr;
+    }
+
+    return &sh;
+}
+
+static void rebuildLookupTables(MSEGStorage *ms)
+{
+    ms->cachedSegments = -1;
+    ms->timeLookupScale = 0;
+
+    int n = ms->n_activeSegments;
+
+    if (n <= 0)
+    {
+        return;
+    }
+
+    for (int i = 0; i < n; ++i)
+    {
+        auto &r = ms->segments[i];
+        auto &sh = ms->shapeCache[i];
+
+        sh.cpv = r.cpv;
+        sh.type = r.type;
+        sh.cpCurve = controlPointCurve(r.cpv);
+        sh.steps = controlPointSteps(r.type, r.cpv);
+    }
+
+    ms->cachedSegments = n;
+
+    /*
+     * The time lookup relies on segments being contiguous and in order, which they are by
+     * construction. If an edit ever leaves them otherwise we just don't use the table and
+     * timeToSegment scans like it always did.
+     */
+    if (ms->totalDuration <= MSEGStorage::minimumDuration || ms->segmentStart[0] != 0)
+    {
+        return;
+    }
+
+    for (int i = 1; i < n; ++i)
+    {
+        if (ms->segmentStart[i] != ms->segmentEnd[i - 1] ||
+            ms->segmentEnd[i] < ms->segmentEnd[i - 1])
+        {
+            return;
+        }
+    }
+
+    double dt = (double)ms->totalDuration / MSEGStorage::timeLookupSize;
+    int seg = 0;
+
+    for (int i = 0; i < MSEGStorage::timeLookupSize; ++i)
+    {
+        double t = i * dt;
+
+        while (seg < n - 1 && ms->segmentEnd[seg] < t)
+        {
+            seg++;
+        }
+
+        ms->timeLookup[i] = seg;
+    }
+
+    ms->timeLookupScale = 1.0 / dt;
+}
+
+/*
+ * Returns the first segment with start <= t < end (or start <= t <= end if includeEnd),
+ * which is exactly what the linear scans below find, or -1 if the lookup table can't
+ * answer. Since segments are contiguous that's the first segment whose end is past t, and
+ * the table gets us to within a step or two of it; walking both ways from there makes the
+ * result independent of rounding at the table's bucket edges.
+ */
+static int lookupSegment(const MSEGStorage *ms, double t, bool includeEnd)
+{
+    if (ms->timeLookupScale <= 0 || ms->cachedSegments != ms->n_activeSegments || t < 0)
+    {
+        return -1;
+    }
+
+    int n = ms->n_activeSegments;
+    auto endsBefore = [ms, t, includeEnd](int i) {
+        return includeEnd ? ms->segmentEnd[i] < t : ms->segmentEnd[i] <= t;
+    };
+
+    int b = std::clamp((int)(t * ms->timeLookupScale), 0, MSEGStorage::timeLookupSize - 1);
+    int idx = ms->timeLookup[b];
+
+    while (idx > 0 && !endsBefore(idx - 1))
+    {
+        idx--;
+    }
+
+    while (idx < n && endsBefore(idx))
+    {
+        idx++;
+    }
+
+    if (idx >= n || t < ms->segmentStart[idx])
+    {
+        return -1;
+    }
+
+    return idx;
+}
+
 void rebuildCache(MSEGStorage *ms)
 {
     if (ms->loop_start > ms->n_activeSegments - 1)
@@ -112,6 +316,8 @@ void rebuildCache(MSEGStorage *ms)
             ms->segmentEnd[(ms->loop_end >= 0 ? ms->loop_end : ms->n_activeSegments - 1)] -
             ms->segmentStart[(ms->loop_start >= 0 ? ms->loop_start : 0)];
     }
+
+    rebuildLookupTables(ms);
 }
 
 float valueAt(int ip, float fup, float df, MSEGStorage *ms, EvaluatorState *es, bool forceOneShot)
@@ -323,49 +529,8 @@ float valueAt(int ip, float fup, float df, MSEGStorage *ms, EvaluatorState *es,
         }
 
         // So we want to handle control points
-        auto cpd = r.cpv;
-
-        /*
-         * Alright so we have a functional form (e^ax-1)/(e^a-1) = y;
-         * We also know that since we have vertical only motion here x = 1/2 and y is where we want
-         * to hit ( specifically since we are generating a 0,1 line and cpv is -1,1 then
-         * here we get y = 0.5 * cpv + 0.5.
-         *
-         * Fine so lets show our work. I'm going to use X and V for now
-         *
-         * (e^aX-1)/(e^a-1) = V  @ x=1/2
-         * introduce Q = e^a/2
-         * (Q - 1) / ( Q^2 - 1 ) = V
-         * Q - 1 = V Q^2 - V
-         * V Q^2 - Q + ( 1-V ) = 0
-         *
-         * OK cool we know how to solve that (for V != 0)
-         *
-         * Q = (1 +/- sqrt( 1 - 4 * V * (1-V) )) / 2 V
-         *
-         * and since Q = e^a/2
-         *
-         * a = 2 * log(Q)
-         *
-         */
-
-        float V = 0.5 * r.cpv + 0.5;
-        float amul = 1;
-
-        if (V < 0.5)
-        {
-            amul = -1;
-            V = 1 - V;
-        }
-
-        float disc = (1 - 4 * V * (1 - V));
-        float a = 0;
-
-        if (fabs(V) > 1e-3)
-        {
-            float Q = limit_range((1 - sqrt(disc)) / (2 * V), 0.00001f, 1000000.f);
-            a = amul * 2 * log(Q);
-        }
+        auto shape = cachedShapeFor(ms, idx);
+        float a = shape ? shape->cpCurve : controlPointCurve(r.cpv);
 
         // OK so frac is the 0,1 line point
         auto cpline = frac;
@@ -502,10 +667,8 @@ float valueAt(int ip, float fup, float df, MSEGStorage *ms, EvaluatorState *es,
     case MSEGStorage::segment::TRIANGLE:
     case MSEGStorage::segment::SQUARE:
     {
-        float pct = (r.cpv + 1) * 0.5;
-        float as = 5.0;
-        float scaledpct = (exp(as * pct) - 1) / (exp(as) - 1);
-        int steps = (int)(scaledpct * 100);
+        auto shape = cachedShapeFor(ms, idx);
+        int steps = shape ? shape->steps : controlPointSteps(r.type, r.cpv);
         auto frac = timeAlongSegment / r.duration;
         float kernel = 0;
 
@@ -575,10 +738,8 @@ float valueAt(int ip, float fup, float df, MSEGStorage *ms, EvaluatorState *es,
 
     case MSEGStorage::segment::STAIRS:
     {
-        auto pct = (r.cpv + 1) * 0.5;
-        auto as = 5.0;
-        auto scaledpct = (exp(as * pct) - 1) / (exp(as) - 1);
-        auto steps = (int)(scaledpct * 100) + 2;
+        auto shape = cachedShapeFor(ms, idx);
+        auto steps = shape ? shape->steps : controlPointSteps(r.type, r.cpv);
         auto frac = (float)((int)(steps * timeAlongSegment / r.duration)) / (steps - 1);
 
         if (df < 0)
@@ -596,10 +757,8 @@ float valueAt(int ip, float fup, float df, MSEGStorage *ms, EvaluatorState *es,
     }
     case MSEGStorage::segment::SMOOTH_STAIRS:
     {
-        auto pct = (r.cpv + 1) * 0.5;
-        auto as = 5.0;
-        auto scaledpct = (exp(as * pct) - 1) / (exp(as) - 1);
-        auto steps = (int)(scaledpct * 100) + 2;
+        auto shape = cachedShapeFor(ms, idx);
+        auto steps = shape ? shape->steps : controlPointSteps(r.type, r.cpv);
         auto frac = timeAlongSegment / r.duration;
 
         auto c = df < 0.f ? 1.0 + df * 0.7 : 1.0 + df * 3.0;
@@ -747,7 +906,14 @@ int timeToSegment(MSEGStorage *ms, double t, bool ignoreLoops, float &amountAlon
             }
         }
 
-        int idx = -1;
+        int idx = lookupSegment(ms, t, false);
+
+        if (idx >= 0)
+        {
+            amountAlongSegment = t - ms->segmentStart[idx];
+
+            return idx;
+        }
 
         for (int i = 0; i < ms->n_activeSegments; ++i)
         {
@@ -771,6 +937,15 @@ int timeToSegment(MSEGStorage *ms, double t, bool ignoreLoops, float &amountAlon
         // So are we before the first loop end point
         if (t <= ms->durationToLoopEnd)
         {
+            auto idx = lookupSegment(ms, t, true);
+
+            if (idx >= 0)
+            {
+                amountAlongSegment = t - ms->segmentStart[idx];
+
+                return idx;
+            }
+
             for (int i = 0; i < ms->n_activeSegments; ++i)
                 if (t >= ms->segmentStart[i] && t <= ms->segmentEnd[i])
                 {
@@ -805,6 +980,15 @@ int timeToSegment(MSEGStorage *ms, double t, bool ignoreLoops, float &amountAlon
             // and we need to offset it by the starting point
             nt += ms->segmentStart[ls];
 
+            auto idx = lookupSegment(ms, nt, true);
+
+            if (idx >= 0)
+            {
+                amountAlongSegment = nt - ms->segmentStart[idx];
+
+                return idx;
+            }
+
             for (int i = 0; i < ms->n_activeSegments; ++i)
                 if (nt >= ms->segmentStart[i] && nt <= ms->segmentEnd[i])
                 {
@@ -53,13 +53,14 @@ const uint8_t alias_sinetable[256] = {
 };
 
 static uint8_t shaped_sinetable[7][256];
-static bool initializedShapedSinetable = false;
 
-void AliasOscillator::init(float pitch, bool is_display, bool nonzero_init_drift)
+/*
+ * Only alias oscillators need these, so they are built the first time one starts rather
+ * than at load. Several instances can get here at once, which the static local takes care of.
+ */
+static void initializeShapedSinetable()
 {
-    if (!initializedShapedSinetable)
-    {
-        initializedShapedSinetable = true;
+    static bool initialized = []() {
         float dPhase = 2.0 * M_PI / (256 - 1);
         for (int i = 0; i < 7; ++i)
         {
@@ -72,7 +73,14 @@ void AliasOscillator::init(float pitch, bool is_display, bool nonzero_init_drift
                 shaped_sinetable[i][k] = (uint8_t)(r01 * 0xFF);
             }
         }
-    }
+        return true;
+    }();
+    (void)initialized;
+}
+
+void AliasOscillator::init(float pitch, bool is_display, bool nonzero_init_drift)
+{
+    initializeShapedSinetable();
 
     n_unison = is_display ? 1 : oscdata->p[ao_unison_voices].val.i;
 
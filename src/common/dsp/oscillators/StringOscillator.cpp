@@ -88,43 +88,132 @@ std::string stringosc_excitation_name(int i)
     return "Unknown";
 }
 
-StringOscillator::~StringOscillator()
+StringOscillator::~StringOscillator() { releaseDelayLines(); };
+
+size_t StringOscillator::delayLineSizeFor(double samples)
 {
-    if (storage && !ownDelayLines)
-    {
-        if (delayLine[0])
-            storage->memoryPools->stringDelayLines.returnItem(delayLine[0]);
-        if (delayLine[1])
-            storage->memoryPools->stringDelayLines.returnItem(delayLine[1]);
-    }
-    else
+    using pools = Surge::Memory::SurgeMemoryPools;
+
+    for (auto n = pools::minStringDelayLine; n < pools::maxStringDelayLine; n *= 2)
     {
-        if (delayLine[0])
-            delete delayLine[0];
-        if (delayLine[1])
-            delete delayLine[1];
+        if (samples <= n)
+            return n;
     }
-};
+
+    return pools::maxStringDelayLine;
+}
+
+size_t StringOscillator::longestDelayLineFor(SurgeStorage *storage, OscillatorStorage *oscdata,
+                                             float lowestNote)
+{
+    auto &detune = oscdata->p[str_str2_detune];
+
+    // an absolute detune can take the second string down to 10Hz whatever the note
+    if (detune.absolute)
+        return Surge::Memory::SurgeMemoryPools::maxStringDelayLine;
+
+    auto lowest = std::min(148.f, lowestNote + std::min(0.f, detune.get_extended(detune.val.f)));
+    auto pitchmult_inv =
+        std::max(1.0, storage->dsamplerate_os * (1 / 8.175798915) *
+                          storage->note_to_pitch_inv(std::max(-128.f, lowest)));
+    auto os = (oscdata->p[str_exciter_level].deform_type & os_twox) ? 2 : 1;
+
+    // as in init()
+    return delayLineSizeFor(2 * pitchmult_inv * os + FIRipol_N + 100);
+}
+
+void StringOscillator::acquireDelayLines(size_t size)
+{
+    withDelayLineSize(size, [this](auto n) {
+        static constexpr size_t N = decltype(n)::value;
+        auto &dl = delayLinesOfSize<N>();
+
+        for (auto &d : dl)
+        {
+            if (ownDelayLines)
+                d = new SSESincDelayLine<N>(storage->sinctable);
+            else
+                d = storage->memoryPools->stringDelayLinePool<N>().getItem(storage->sinctable);
+        }
+
+        delayLineSize = N;
+    });
+}
+
+void StringOscillator::releaseDelayLines()
+{
+    if (!delayLineSize)
+        return;
+
+    withDelayLineSize(delayLineSize, [this](auto n) {
+        static constexpr size_t N = decltype(n)::value;
+        auto &dl = delayLinesOfSize<N>();
+
+        for (auto &d : dl)
+        {
+            if (!d)
+                continue;
+
+            if (storage && !ownDelayLines)
+                storage->memoryPools->stringDelayLinePool<N>().returnItem(d);
+            else
+                delete d;
+
+            d = nullptr;
+        }
+    });
+
+    delayLineSize = 0;
+}
+
+void StringOscillator::growDelayLinesTo(size_t size)
+{
+    if (size <= delayLineSize)
+        return;
+
+    withDelayLineSize(delayLineSize, [this, size](auto f) {
+        withDelayLineSize(size, [this, f](auto t) {
+            static constexpr size_t From = decltype(f)::value, To = decltype(t)::value;
+
+            if constexpr (To > From)
+            {
+                auto &from = delayLinesOfSize<From>();
+                auto &to = delayLinesOfSize<To>();
+
+                for (int i = 0; i < 2; ++i)
+                {
+                    if (ownDelayLines)
+                        to[i] = new SSESincDelayLine<To>(storage->sinctable);
+                    else
+                        to[i] = storage->memoryPools->stringDelayLinePool<To>().getItem(
+                            storage->sinctable);
+
+                    // replay the old ring oldest first, so the taps read the same history
+                    to[i]->clear();
+                    for (size_t q = From; q > 0; --q)
+                        to[i]->write(from[i]->buffer[(from[i]->wp + From - q) & (From - 1)]);
+
+                    if (ownDelayLines)
+                        delete from[i];
+                    else
+                        storage->memoryPools->stringDelayLinePool<From>().returnItem(from[i]);
+
+                    from[i] = nullptr;
+                }
+
+                delayLineSize = To;
+            }
+        });
+    });
+}
 
 void StringOscillator::init(float pitch, bool is_display, bool nzi)
 {
-    // fixme - alloc in is_display but for now just deal with the race
-    // delayLine[0] = std::make_unique<SSESincDelayLine<16384>>();
-    // delayLine[1] = std::make_unique<SSESincDelayLine<16384>>();
-    if (is_display)
-    {
-        ownDelayLines = true;
-        delayLine[0] = new SSESincDelayLine<16384>(storage->sinctable);
-        delayLine[1] = new SSESincDelayLine<16384>(storage->sinctable);
-    }
-    else
-    {
-        ownDelayLines = false;
-        if (!delayLine[0])
-            delayLine[0] = storage->memoryPools->stringDelayLines.getItem(storage->sinctable);
-        if (!delayLine[1])
-            delayLine[1] = storage->memoryPools->stringDelayLines.getItem(storage->sinctable);
-    }
+    // displays run off the audio thread so can't use the pools
+    if (delayLineSize && ownDelayLines != is_display)
+        releaseDelayLines();
+
+    ownDelayLines = is_display;
 
     memset((void *)dustBuffer, 0, 2 * (BLOCK_SIZE_OS) * sizeof(float));
 
@@ -180,13 +269,43 @@ void StringOscillator::init(float pitch, bool is_display, bool nzi)
     tap[1].startValue(pitchmult2_inv);
     t2level.startValue(0.5 * limit_range(localcopy[id_strbalance].f, -1.f, 1.f) + 0.5);
 
+    for (int i = 0; i < 2; ++i)
+    {
+        driftLFO[i].init(nzi);
+    }
+
+    /*
+     * Size the lines for the longest period we expect, with an octave of headroom for bends
+     * and modulation. Anything further down grows the lines while playing.
+     */
+    auto longest = std::max(pitchmult_inv, pitchmult2_inv) * getOversampleLevel();
+    auto want = delayLineSizeFor(2 * longest + FIRipol_N + 100);
+
+    if (delayLineSize && delayLineSize < want)
+        releaseDelayLines();
+
+    if (!delayLineSize)
+        acquireDelayLines(want);
+
+    delayLineNeeded = 0;
+
+    withDelayLineSize(delayLineSize, [&](auto n) {
+        prefillDelayLines<decltype(n)::value>(pitch, is_display, pitchmult_inv, pitchmult2_inv);
+    });
+}
+
+template <size_t N>
+void StringOscillator::prefillDelayLines(float pitch, bool is_display, double pitchmult_inv,
+                                         double pitchmult2_inv)
+{
+    auto &delayLine = delayLinesOfSize<N>();
+
     // we need a big prefill to support the delay line for FM
     auto prefill = (int)floor(10 * std::max(pitchmult_inv, pitchmult2_inv) * getOversampleLevel());
 
     for (int i = 0; i < 2; ++i)
     {
         delayLine[i]->clear();
-        driftLFO[i].init(nzi);
     }
 
     auto mode = (exciter_modes)oscdata->p[str_exciter_mode].val.i;
@@ -469,6 +588,25 @@ int StringOscillator::getOversampleLevel()
 }
 
 void StringOscillator::process_block(float pitch, float drift, bool stereo, bool FM, float fmdepthV)
+{
+    using pools = Surge::Memory::SurgeMemoryPools;
+
+    // FM can stretch the taps far past the note period, so it always gets the longest lines
+    if (FM)
+        growDelayLinesTo(pools::maxStringDelayLine);
+    else if (delayLineNeeded > delayLineSize)
+        growDelayLinesTo(delayLineSizeFor(delayLineNeeded));
+
+    delayLineNeeded = 0;
+
+    withDelayLineSize(delayLineSize, [&](auto n) {
+        process_block_sized<decltype(n)::value>(pitch, drift, stereo, FM, fmdepthV);
+    });
+}
+
+template <size_t N>
+void StringOscillator::process_block_sized(float pitch, float drift, bool stereo, bool FM,
+                                           float fmdepthV)
 {
 #define P(m)                                                                                       \
     case m:                                                                                        \
@@ -476,22 +614,22 @@ void StringOscillator::process_block(float pitch, float drift, bool stereo, bool
         {                                                                                          \
             if (oss & StringOscillator::os_onex)                                                   \
             {                                                                                      \
-                process_block_internal<true, m, 1>(pitch, drift, stereo, fmdepthV);                \
+                process_block_internal<N, true, m, 1>(pitch, drift, stereo, fmdepthV);             \
             }                                                                                      \
             else                                                                                   \
             {                                                                                      \
-                process_block_internal<true, m, 2>(pitch, drift, stereo, fmdepthV);                \
+                process_block_internal<N, true, m, 2>(pitch, drift, stereo, fmdepthV);             \
             }                                                                                      \
         }                                                                                          \
         else                                                                                       \
         {                                                                                          \
             if (oss & StringOscillator::os_onex)                                                   \
             {                                                                                      \
-                process_block_internal<false, m, 1>(pitch, drift, stereo, fmdepthV);               \
+                process_block_internal<N, false, m, 1>(pitch, drift, stereo, fmdepthV);            \
             }                                                                                      \
             else                                                                                   \
             {                                                                                      \
-                process_block_internal<false, m, 2>(pitch, drift, stereo, fmdepthV);               \
+                process_block_internal<N, false, m, 2>(pitch, drift, stereo, fmdepthV);            \
             }                                                                                      \
         }                                                                                          \
         break;
@@ -523,9 +661,10 @@ void StringOscillator::process_block(float pitch, float drift, bool stereo, bool
 #undef P
 }
 
-template <bool FM, StringOscillator::exciter_modes mode, int OS>
+template <size_t N, bool FM, StringOscillator::exciter_modes mode, int OS>
 void StringOscillator::process_block_internal(float pitch, float drift, bool stereo, float fmdepthV)
 {
+    auto &delayLine = delayLinesOfSize<N>();
     auto lfodetune = drift * driftLFO[0].next();
     auto pitchadj = pitchAdjustmentForStiffness();
     auto pitch_t = std::min(148.f, pitch + lfodetune + pitchadj);
@@ -582,8 +721,21 @@ void StringOscillator::process_block_internal(float pitch, float drift, bool ste
     dp1 /= OS;
     dp2 /= OS;
 
-    pitchmult_inv = std::min(pitchmult_inv, (delayLine[0]->comb_size - 100) * 1.0);
-    pitchmult2_inv = std::min(pitchmult2_inv, (delayLine[0]->comb_size - 100) * 1.0);
+    auto maxTap = (delayLine[0]->comb_size - 100) * 1.0;
+
+    if constexpr (N < Surge::Memory::SurgeMemoryPools::maxStringDelayLine)
+    {
+        // ask for longer lines next block, and keep the oversampled tap inside these meanwhile
+        auto need = std::max(pitchmult_inv, pitchmult2_inv) * OS + FIRipol_N + 100;
+
+        if (need > N)
+            delayLineNeeded = std::max(delayLineNeeded, need);
+
+        maxTap /= OS;
+    }
+
+    pitchmult_inv = std::min(pitchmult_inv, maxTap);
+    pitchmult2_inv = std::min(pitchmult2_inv, maxTap);
 
     tap[0].newValue(pitchmult_inv);
     tap[1].newValue(pitchmult2_inv);
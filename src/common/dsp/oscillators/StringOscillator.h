@@ -27,6 +27,8 @@
 #include "BiquadFilter.h"
 #include "OscillatorCommonFunctions.h"
 #include <random>
+#include <tuple>
+#include <type_traits>
 #include <sst/filters/HalfRateFilter.h>
 
 class StringOscillator : public Oscillator
@@ -100,7 +102,9 @@ class StringOscillator : public Oscillator
     virtual void process_block(float pitch, float drift = 0.f, bool stereo = false, bool FM = false,
                                float FMdepth = 0.f) override;
 
-    template <bool FM, exciter_modes mode, int OS>
+    template <size_t N>
+    void process_block_sized(float pitch, float drift, bool stereo, bool FM, float FMdepth);
+    template <size_t N, bool FM, exciter_modes mode, int OS>
     void process_block_internal(float pitch, float drift, bool stereo, float FMdepth);
 
     float phase1 = 0, phase2 = 0;
@@ -109,7 +113,47 @@ class StringOscillator : public Oscillator
 
     lag<float, true> examp, tap[2], t2level, feedback[2], tone, fmdepth;
 
-    std::array<SSESincDelayLine<16384> *, 2> delayLine{nullptr, nullptr};
+    /*
+     * The delay lines come in size classes (see SurgeMemoryPools) and only the pair of size
+     * delayLineSize is held at once. If the strings are asked for a longer period than that
+     * holds, the next process_block moves the contents to a larger class.
+     */
+    template <size_t N> using DelayLinePair = std::array<SSESincDelayLine<N> *, 2>;
+    std::tuple<DelayLinePair<2048>, DelayLinePair<4096>, DelayLinePair<8192>, DelayLinePair<16384>>
+        delayLines{};
+    template <size_t N> DelayLinePair<N> &delayLinesOfSize()
+    {
+        return std::get<DelayLinePair<N>>(delayLines);
+    }
+    template <typename F> static void withDelayLineSize(size_t size, F &&f)
+    {
+        switch (size)
+        {
+        case 2048:
+            f(std::integral_constant<size_t, 2048>());
+            break;
+        case 4096:
+            f(std::integral_constant<size_t, 4096>());
+            break;
+        case 8192:
+            f(std::integral_constant<size_t, 8192>());
+            break;
+        default:
+            f(std::integral_constant<size_t, 16384>());
+            break;
+        }
+    }
+    size_t delayLineSize{0};
+    double delayLineNeeded{0};
+    static size_t delayLineSizeFor(double samples);
+    // The size class init() picks for the lowest note this oscillator is expected to play
+    static size_t longestDelayLineFor(SurgeStorage *storage, OscillatorStorage *oscdata,
+                                      float lowestNote);
+    void acquireDelayLines(size_t size);
+    void releaseDelayLines();
+    void growDelayLinesTo(size_t size);
+    template <size_t N> void prefillDelayLines(float pitch, bool is_display, double pitchmult_inv,
+                                               double pitchmult2_inv);
     bool ownDelayLines{false};
     float priorSample[2] = {0, 0};
     Surge::Oscillator::DriftLFO driftLFO[2];
@@ -22,6 +22,9 @@
 
 #include "TwistOscillator.h"
 #include "DebugHelpers.h"
+#include "SurgeMemoryPools.h"
+
+#include <new>
 
 #define TEST
 #ifndef _MSC_VER
@@ -275,16 +278,14 @@ static struct EngineDynamicDeact : public ParameterDynamicDeactivationFunction
     }
 } etDynamicDeact;
 
-TwistOscillator::TwistOscillator(SurgeStorage *storage, OscillatorStorage *oscdata,
-                                 pdata *localcopy)
-    : Oscillator(storage, oscdata, localcopy), charFilt(storage)
+TwistOscillator::State::State()
 {
+    int error{0};
 #if SAMPLERATE_LANCZOS
-    lancRes = std::make_unique<sst::basic_blocks::dsp::LanczosResampler<BLOCK_SIZE>>(
-        48000, storage->dsamplerate_os);
-    srcstate = nullptr;
+    // the output rate is set on reset, once we know which storage we are playing into
+    lancRes = std::make_unique<sst::basic_blocks::dsp::LanczosResampler<BLOCK_SIZE>>(48000, 48000);
+    intRes = std::make_unique<IntegerRatioUpsampler<BLOCK_SIZE>>();
 #else
-    int error;
     srcstate = src_new(SRC_SINC_FASTEST, 2, &error);
     // srcstate = src_new(SRC_LINEAR, 2, &error);
     if (error != 0)
@@ -293,13 +294,12 @@ TwistOscillator::TwistOscillator(SurgeStorage *storage, OscillatorStorage *oscda
     }
 #endif
     voice = std::make_unique<plaits::Voice>();
-    shared_buffer = new char[16384];
-    alloc = std::make_unique<stmlib::BufferAllocator>(shared_buffer, 16384);
+    shared_buffer = std::make_unique<char[]>(shared_buffer_size);
+    alloc = std::make_unique<stmlib::BufferAllocator>(shared_buffer.get(), shared_buffer_size);
     patch = std::make_unique<plaits::Patch>();
     mod = std::make_unique<plaits::Modulations>();
 
     // FM downsampling with a linear interpolator is absolutely fine
-    int error;
     fmdownsamplestate = src_new(SRC_LINEAR, 1, &error);
     if (error != 0)
     {
@@ -307,6 +307,49 @@ TwistOscillator::TwistOscillator(SurgeStorage *storage, OscillatorStorage *oscda
     }
 }
 
+TwistOscillator::State::~State()
+{
+    if (srcstate)
+        srcstate = src_delete(srcstate);
+
+    if (fmdownsamplestate)
+        fmdownsamplestate = src_delete(fmdownsamplestate);
+}
+
+void TwistOscillator::State::reset(SurgeStorage *storage)
+{
+#if SAMPLERATE_LANCZOS
+    // rebuild in place rather than assign, since the resampler buffers are large
+    using resampler_t = sst::basic_blocks::dsp::LanczosResampler<BLOCK_SIZE>;
+    lancRes->~resampler_t();
+    new (lancRes.get()) resampler_t(48000, storage->dsamplerate_os);
+
+    auto ratio = storage->dsamplerate_os / 48000.0;
+    integerRatio = IntegerRatioUpsampler<BLOCK_SIZE>::isIntegerRatio(ratio) ? (int)ratio : 0;
+
+    if (integerRatio)
+    {
+        intRes->setRatio(integerRatio);
+        intRes->reset();
+    }
+#endif
+
+    if (srcstate)
+        src_reset(srcstate);
+
+    if (fmdownsamplestate)
+        src_reset(fmdownsamplestate);
+
+    // plaits carves its engine buffers out of this in Voice::Init, so start from the top
+    alloc->Init(shared_buffer.get(), shared_buffer_size);
+}
+
+TwistOscillator::TwistOscillator(SurgeStorage *storage, OscillatorStorage *oscdata,
+                                 pdata *localcopy)
+    : Oscillator(storage, oscdata, localcopy), charFilt(storage)
+{
+}
+
 float TwistOscillator::tuningAwarePitch(float pitch)
 {
     if (storage->tuningApplicationMode == SurgeStorage::RETUNE_ALL &&
@@ -324,13 +367,34 @@ float TwistOscillator::tuningAwarePitch(float pitch)
 
 void TwistOscillator::init(float pitch, bool is_display, bool nonzero_drift)
 {
-    voice->Init(alloc.get());
+    if (!state)
+    {
+        // displays build oscillators off the audio thread, so they can't share the pool
+        ownState = is_display;
+        state = ownState ? new State() : storage->memoryPools->twistStates.getItem();
+    }
+
+    state->reset(storage);
+
+    voice = state->voice.get();
+    patch = state->patch.get();
+    mod = state->mod.get();
+    alloc = state->alloc.get();
+    srcstate = state->srcstate;
+    fmdownsamplestate = state->fmdownsamplestate;
+#if SAMPLERATE_LANCZOS
+    lancRes = state->lancRes.get();
+    intRes = state->integerRatio ? state->intRes.get() : nullptr;
+    fmDecimation = state->integerRatio;
+#endif
+
+    voice->Init(alloc);
 
     charFilt.init(storage->getPatch().character.val.i);
 
     float tpitch = tuningAwarePitch(pitch);
-    memset((void *)patch.get(), 0, sizeof(plaits::Patch));
-    memset((void *)mod.get(), 0, sizeof(plaits::Modulations));
+    memset((void *)patch, 0, sizeof(plaits::Patch));
+    memset((void *)mod, 0, sizeof(plaits::Modulations));
 
     driftLFO.init(nonzero_drift);
 
@@ -350,24 +414,34 @@ void TwistOscillator::init(float pitch, bool is_display, bool nonzero_drift)
     fmrp = 0;
     fmwp = (int)(BLOCK_SIZE_OS * 48000 * storage->dsamplerate_os_inv);
 
-    process_block_internal<false, true>(pitch, 0, false, 0, std::ceil(cycleInSamples));
+#if SAMPLERATE_LANCZOS
+    if (intRes)
+        process_block_internal<false, true>(intRes, pitch, 0, false, 0, std::ceil(cycleInSamples));
+    else
+        process_block_internal<false, true>(lancRes, pitch, 0, false, 0, std::ceil(cycleInSamples));
+#else
+    process_block_internal<false, true, void>(nullptr, pitch, 0, false, 0,
+                                              std::ceil(cycleInSamples));
+#endif
 }
 TwistOscillator::~TwistOscillator()
 {
-    if (shared_buffer)
-        delete[] shared_buffer;
-
-    if (srcstate)
-        srcstate = src_delete(srcstate);
+    if (!state)
+        return;
 
-    if (fmdownsamplestate)
-        fmdownsamplestate = src_delete(fmdownsamplestate);
+    if (ownState)
+        delete state;
+    else
+        storage->memoryPools->twistStates.returnItem(state);
 }
 
-template <bool FM, bool throwaway>
-void TwistOscillator::process_block_internal(float pitch, float drift, bool stereo, float FMdepth,
-                                             int throwawayBlocks)
+template <bool FM, bool throwaway, typename R>
+void TwistOscillator::process_block_internal(R *resampler, float pitch, float drift, bool stereo,
+                                             float FMdepth, int throwawayBlocks)
 {
+    if (!state)
+        return;
+
 #if SAMPLERATE_SRC
     if (!srcstate)
         return;
@@ -423,7 +497,18 @@ void TwistOscillator::process_block_internal(float pitch, float drift, bool ster
         fmdata.data_out = &(dsmaster[0]);
         fmdata.input_frames = BLOCK_SIZE_OS;
         fmdata.output_frames = BLOCK_SIZE_OS << 2;
-        src_process(fmdownsamplestate, &fmdata);
+
+        if (fmDecimation)
+        {
+            // a whole number ratio lands exactly on every n-th input sample
+            fmdata.output_frames_gen = 0;
+            for (int i = 0; i < BLOCK_SIZE_OS; i += fmDecimation)
+                dsmaster[fmdata.output_frames_gen++] = master_osc[i];
+        }
+        else
+        {
+            src_process(fmdownsamplestate, &fmdata);
+        }
 
         const float bl = -143.5, bhi = 71.7, oos = 1.0 / (bhi - bl);
         float adb = limit_range(amp_to_db(FMdepth), bl, bhi);
@@ -458,7 +543,7 @@ void TwistOscillator::process_block_internal(float pitch, float drift, bool ster
     carrover_size = 0;
 #else
     int total_generated =
-        required_blocks - lancRes->inputsRequiredToGenerateOutputs(required_blocks);
+        required_blocks - resampler->inputsRequiredToGenerateOutputs(required_blocks);
 #endif
 
     if (lpgIsOn)
@@ -503,10 +588,10 @@ void TwistOscillator::process_block_internal(float pitch, float drift, bool ster
 #if SAMPLERATE_LANCZOS
         for (int i = 0; i < subblock; ++i)
         {
-            lancRes->push(poutput[i].out / 32768.f, poutput[i].aux / 32768.f);
+            resampler->push(poutput[i].out / 32768.f, poutput[i].aux / 32768.f);
         }
         total_generated =
-            required_blocks - lancRes->inputsRequiredToGenerateOutputs(required_blocks);
+            required_blocks - resampler->inputsRequiredToGenerateOutputs(required_blocks);
 #else
         for (int i = 0; i < subblock; ++i)
         {
@@ -557,12 +642,12 @@ void TwistOscillator::process_block_internal(float pitch, float drift, bool ster
 #if SAMPLERATE_LANCZOS
     if (throwaway)
     {
-        lancRes->advanceReadPointer(required_blocks);
+        resampler->advanceReadPointer(required_blocks);
     }
     else
     {
         float tL[BLOCK_SIZE_OS], tR[BLOCK_SIZE_OS];
-        lancRes->populateNextBlockSizeOS(tL, tR);
+        resampler->populateNextBlockSizeOS(tL, tR);
 
         for (int i = 0; i < BLOCK_SIZE_OS; ++i)
         {
@@ -579,7 +664,7 @@ void TwistOscillator::process_block_internal(float pitch, float drift, bool ster
             auxmix.process();
         }
     }
-    lancRes->renormalizePhases();
+    resampler->renormalizePhases();
 #endif
 
     if (!throwaway && charFilt.doFilter)
@@ -600,14 +685,25 @@ void TwistOscillator::process_block_internal(float pitch, float drift, bool ster
 
 void TwistOscillator::process_block(float pitch, float drift, bool stereo, bool FM, float FMdepth)
 {
-    if (FM)
-    {
-        TwistOscillator::process_block_internal<true>(pitch, drift, stereo, FMdepth);
-    }
+    auto render = [&](auto *resampler) {
+        if (FM)
+        {
+            process_block_internal<true>(resampler, pitch, drift, stereo, FMdepth);
+        }
+        else
+        {
+            process_block_internal<false>(resampler, pitch, drift, stereo, FMdepth);
+        }
+    };
+
+#if SAMPLERATE_LANCZOS
+    if (intRes)
+        render(intRes);
     else
-    {
-        TwistOscillator::process_block_internal<false>(pitch, drift, stereo, FMdepth);
-    }
+        render(lancRes);
+#else
+    render((void *)nullptr);
+#endif
 }
 
 void TwistOscillator::init_ctrltypes()
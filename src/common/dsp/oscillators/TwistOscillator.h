@@ -36,6 +36,7 @@
 #if SAMPLERATE_LANCZOS
 // #include "LanczosResampler.h"
 #include "sst/basic-blocks/dsp/LanczosResampler.h"
+#include "IntegerRatioUpsampler.h"
 #endif
 
 namespace plaits
@@ -71,9 +72,10 @@ class TwistOscillator : public Oscillator
 
     void process_block(float pitch, float drift, bool stereo, bool FM, float FMdepth) override;
 
-    template <bool FM, bool throwaway = false>
-    void process_block_internal(float pitch, float drift, bool stereo, float FMdepth,
-                                int throwawayBlocks = -1);
+    // R is whichever resampler takes plaits' 48k output to our rate
+    template <bool FM, bool throwaway = false, typename R = void>
+    void process_block_internal(R *resampler, float pitch, float drift, bool stereo,
+                                float FMdepth, int throwawayBlocks = -1);
 
     virtual void init(float pitch, bool is_display = false, bool nonzero_drift = true) override;
     virtual void init_ctrltypes(int scene, int oscnum) override { init_ctrltypes(); };
@@ -88,22 +90,54 @@ class TwistOscillator : public Oscillator
         return clamp01((localcopy[oscdata->p[ps].param_id_in_scene].f + 1) * 0.5f);
     }
 
-    std::unique_ptr<plaits::Voice> voice;
-    std::unique_ptr<plaits::Patch> patch;
-    std::unique_ptr<plaits::Modulations> mod;
-    std::unique_ptr<stmlib::BufferAllocator> alloc;
-    char *shared_buffer{nullptr};
+    /*
+     * Everything heavy a Twist instance needs. Voices draw these from
+     * storage->memoryPools->twistStates rather than allocating on note on, and
+     * reset() puts a reused one back to the state a freshly built one would have.
+     */
+    struct State
+    {
+        State();
+        ~State();
+        void reset(SurgeStorage *storage);
+
+        std::unique_ptr<plaits::Voice> voice;
+        std::unique_ptr<plaits::Patch> patch;
+        std::unique_ptr<plaits::Modulations> mod;
+        std::unique_ptr<stmlib::BufferAllocator> alloc;
+        std::unique_ptr<char[]> shared_buffer;
+        static constexpr size_t shared_buffer_size{16384};
+
+        // Keep this here for now even if using lanczos since I'm using SRC for FM still
+        SRC_STATE_tag *srcstate{nullptr}, *fmdownsamplestate{nullptr};
+#if SAMPLERATE_LANCZOS
+        std::unique_ptr<sst::basic_blocks::dsp::LanczosResampler<BLOCK_SIZE>> lancRes;
+
+        // When our rate is a whole multiple of 48k we take this cheaper path instead
+        std::unique_ptr<IntegerRatioUpsampler<BLOCK_SIZE>> intRes;
+        int integerRatio{0};
+#endif
+    };
+    State *state{nullptr};
+    bool ownState{false};
+
+    // shortcuts into state, valid after init
+    plaits::Voice *voice{nullptr};
+    plaits::Patch *patch{nullptr};
+    plaits::Modulations *mod{nullptr};
+    stmlib::BufferAllocator *alloc{nullptr};
 
-    // Keep this here for now even if using lanczos since I'm using SRC for FM still
-    SRC_STATE_tag *srcstate, *fmdownsamplestate;
+    SRC_STATE_tag *srcstate{nullptr}, *fmdownsamplestate{nullptr};
     float fmlagbuffer[BLOCK_SIZE_OS << 1];
     int fmwp, fmrp;
 
     bool useCorrectLPGBlockSize{false}; // See #6760
 
 #if SAMPLERATE_LANCZOS
-    std::unique_ptr<sst::basic_blocks::dsp::LanczosResampler<BLOCK_SIZE>> lancRes;
+    sst::basic_blocks::dsp::LanczosResampler<BLOCK_SIZE> *lancRes{nullptr};
+    IntegerRatioUpsampler<BLOCK_SIZE> *intRes{nullptr}; // only set on integer ratios
 #endif
+    int fmDecimation{0}; // as above, for taking the FM input down to 48k
 
     float carryover[BLOCK_SIZE_OS][2];
     int carrover_size = 0;
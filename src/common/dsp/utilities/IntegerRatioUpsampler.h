@@ -0,0 +1,151 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_DSP_UTILITIES_INTEGERRATIOUPSAMPLER_H
+#define SURGE_SRC_COMMON_DSP_UTILITIES_INTEGERRATIOUPSAMPLER_H
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+/*
+ * A stereo Lanczos upsampler for when the output rate is an exact integer multiple of the
+ * input rate. With an integer ratio the kernel phases repeat every 'ratio' outputs, so we
+ * tabulate them once rather than evaluate the kernel at a fresh fractional offset for
+ * every output sample the way the general LanczosResampler has to.
+ *
+ * The interface mirrors the parts of LanczosResampler which TwistOscillator uses, so
+ * the render loop can be written once over either.
+ */
+template <int blockSize> struct IntegerRatioUpsampler
+{
+    static constexpr int A = 4;
+    static constexpr int filterWidth = 2 * A;
+    static constexpr int maxRatio = 8;
+    static constexpr int bufferSize = 1024, bufferMask = bufferSize - 1;
+
+    static bool isIntegerRatio(double ratio)
+    {
+        return ratio >= 1 && ratio <= maxRatio && ratio == std::floor(ratio);
+    }
+
+    void setRatio(int r)
+    {
+        assert(r >= 1 && r <= maxRatio);
+
+        if (r == ratio)
+            return;
+
+        ratio = r;
+
+        for (int p = 0; p < ratio; ++p)
+        {
+            float sum = 0;
+            for (int m = 0; m < filterWidth; ++m)
+            {
+                double x = (double)p / ratio + A - 1 - m;
+                taps[p][m] = (float)kernel(x);
+                sum += taps[p][m];
+            }
+
+            // keep DC at unity gain for every phase
+            for (int m = 0; m < filterWidth; ++m)
+                taps[p][m] /= sum;
+        }
+    }
+
+    void reset()
+    {
+        memset(input, 0, sizeof(input));
+        origin = 0;
+        inHead = 0;
+        rp = 0;
+    }
+
+    void push(float fL, float fR)
+    {
+        auto pos = (origin + inHead) & bufferMask;
+        input[0][pos] = fL;
+        input[0][pos + bufferSize] = fL;
+        input[1][pos] = fR;
+        input[1][pos + bufferSize] = fR;
+        inHead++;
+    }
+
+    size_t inputsRequiredToGenerateOutputs(size_t desiredOutputs) const
+    {
+        auto need = A + (rp + (int)desiredOutputs + ratio - 1) / ratio - inHead;
+        return (size_t)std::max(need, 0);
+    }
+
+    void populateNextBlockSizeOS(float *fL, float *fR)
+    {
+        for (int i = 0; i < blockSize << 1; ++i)
+        {
+            auto j = rp + i;
+            auto p = j % ratio;
+            auto start = (origin + j / ratio + bufferSize - A + 1) & bufferMask;
+            const float *tp = taps[p], *iL = input[0] + start, *iR = input[1] + start;
+
+            float L = 0, R = 0;
+            for (int m = 0; m < filterWidth; ++m)
+            {
+                L += tp[m] * iL[m];
+                R += tp[m] * iR[m];
+            }
+            fL[i] = L;
+            fR[i] = R;
+        }
+        rp += blockSize << 1;
+    }
+
+    void advanceReadPointer(size_t n) { rp += (int)n; }
+
+    // Fold whole input samples we have read past into the origin so the counters stay small
+    void renormalizePhases()
+    {
+        auto q = rp / ratio;
+        origin = (origin + q) & bufferMask;
+        inHead -= q;
+        rp -= q * ratio;
+    }
+
+  private:
+    static double kernel(double x)
+    {
+        if (std::fabs(x) < 1e-9)
+            return 1.0;
+        if (std::fabs(x) >= A)
+            return 0.0;
+
+        auto px = M_PI * x;
+        return A * std::sin(px) * std::sin(px / A) / (px * px);
+    }
+
+    int ratio{0};
+    float taps alignas(16)[maxRatio][filterWidth]{};
+    float input alignas(16)[2][bufferSize * 2]{};
+    int origin{0}, inHead{0}, rp{0};
+};
+
+#endif // SURGE_SRC_COMMON_DSP_UTILITIES_INTEGERRATIOUPSAMPLER_H
@@ -84,6 +84,9 @@ const int OB_LENGTH = BLOCK_SIZE_OS << 1;
 const int OB_LENGTH_QUAD = OB_LENGTH >> 2;
 const float BLOCK_SIZE_INV = (1.f / BLOCK_SIZE);
 const float BLOCK_SIZE_OS_INV = (1.f / BLOCK_SIZE_OS);
+// we wrap positions with & (BLOCK_SIZE - 1) and process in quads all over the place
+static_assert(BLOCK_SIZE >= 8 && (BLOCK_SIZE & (BLOCK_SIZE - 1)) == 0,
+              "SURGE_COMPILE_BLOCK_SIZE must be a power of two no smaller than 8");
 const int MAX_FB_COMB = 2048;               // must be 2^n
 const int MAX_FB_COMB_EXTENDED = 2048 * 64; // Only exposed in Combulator
 const int MAX_VOICES = 64;
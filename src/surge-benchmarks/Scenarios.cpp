@@ -0,0 +1,291 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "Scenarios.h"
+#include "SurgeSynthesizer.h"
+#include "BiquadCascade.h"
+
+#include <algorithm>
+#include <cctype>
+#include <memory>
+
+namespace Surge
+{
+namespace Benchmarks
+{
+static std::string slug(const std::string &name)
+{
+    std::string res;
+    for (auto c : name)
+    {
+        if (std::isalnum((unsigned char)c))
+            res += (char)std::tolower((unsigned char)c);
+        else if (!res.empty() && res.back() != '-')
+            res += '-';
+    }
+
+    while (!res.empty() && res.back() == '-')
+        res.pop_back();
+
+    return res;
+}
+
+// Spread voices over a few octaves around middle C so the filters and FX see a real chord
+static void playVoices(SurgeSynthesizer *surge, int voices, int channel = 0)
+{
+    surge->storage.getPatch().polylimit.val.i = std::max(voices, 2);
+
+    for (int v = 0; v < voices; ++v)
+        surge->playNote(channel, 36 + (v * 7) % 60, 100, 0);
+}
+
+static void setFX(SurgeSynthesizer *surge, int slot, int type)
+{
+    auto *pt = &(surge->storage.getPatch().fx[slot].type);
+    auto awv = 1.f * type / (pt->val_max.i - pt->val_min.i);
+    surge->setParameter01(surge->idForParameter(pt), awv, false);
+
+    // the swap happens on the audio thread, so give it a block to land
+    surge->process();
+}
+
+/*
+ * A graphic EQ worth of peaking bands with only a few of them away from 0 dB, which is how
+ * they usually get used. The same bank either runs every band, like the effects used to, or
+ * lets the cascade leave the flat ones out.
+ */
+struct EQBank
+{
+    static constexpr int nBands = 11;
+    std::unique_ptr<BiquadCascade<nBands>> bands;
+    float L alignas(16)[BLOCK_SIZE], R alignas(16)[BLOCK_SIZE];
+
+    void setup(SurgeStorage *storage)
+    {
+        bands = std::make_unique<BiquadCascade<nBands>>(storage);
+        for (int i = 0; i < nBands; ++i)
+        {
+            auto gain = (i == 2 || i == 5 || i == 9) ? 6.0 : 0.0;
+            (*bands)[i].setBlockSize(BLOCK_SIZE);
+            bands->coeff_peakEQ(i, (*bands)[i].calc_omega_from_Hz(30.0 * (1 << i)), 0.5, gain);
+        }
+        bands->coeff_instantize();
+
+        // long enough for the flat bands to settle
+        for (int i = 0; i < storage->samplerate / BLOCK_SIZE; ++i)
+            cascade(storage);
+    }
+
+    void fill(SurgeStorage *storage)
+    {
+        for (int k = 0; k < BLOCK_SIZE; ++k)
+        {
+            L[k] = storage->rand_pm1();
+            R[k] = storage->rand_pm1();
+        }
+    }
+
+    void chain(SurgeStorage *storage)
+    {
+        fill(storage);
+        for (int i = 0; i < nBands; ++i)
+            (*bands)[i].process_block(L, R);
+    }
+
+    void cascade(SurgeStorage *storage)
+    {
+        fill(storage);
+        bands->process_block(L, R);
+    }
+};
+
+std::vector<Scenario> allScenarios()
+{
+    std::vector<Scenario> res;
+
+    for (int ot = 0; ot < n_osc_types; ++ot)
+    {
+        for (int voices : {1, 8, 64})
+        {
+            Scenario s;
+            s.name = "osc/" + slug(osc_type_names[ot]) + "/" + std::to_string(voices);
+            s.setup = [ot, voices](SurgeSynthesizer *surge) {
+                surge->storage.getPatch().scene[0].osc[0].queue_type = ot;
+                surge->process();
+                playVoices(surge, voices);
+            };
+            res.push_back(s);
+        }
+    }
+
+    for (int ft = 0; ft < sst::filters::num_filter_types; ++ft)
+    {
+        Scenario s;
+        s.name = "filter/" + slug(sst::filters::filter_type_names[ft]);
+        s.setup = [ft](SurgeSynthesizer *surge) {
+            auto &fu = surge->storage.getPatch().scene[0].filterunit[0];
+            fu.type.val.i = ft;
+            fu.subtype.val.i = 0;
+            playVoices(surge, 8);
+        };
+        res.push_back(s);
+    }
+
+    for (int fxt = fxt_off + 1; fxt < n_fx_types; ++fxt)
+    {
+        Scenario s;
+        s.name = "fx/" + slug(fx_type_names[fxt]);
+        s.setup = [fxt](SurgeSynthesizer *surge) {
+            setFX(surge, fxslot_ains1, fxt);
+            playVoices(surge, 8);
+        };
+        res.push_back(s);
+    }
+
+    for (bool useCascade : {false, true})
+    {
+        auto bank = std::make_shared<EQBank>();
+
+        Scenario s;
+        s.name = useCascade ? "dsp/peak-eq-cascade" : "dsp/peak-eq-chain";
+        s.setup = [bank](SurgeSynthesizer *surge) { bank->setup(&surge->storage); };
+        s.step = [bank, useCascade](SurgeSynthesizer *surge, int) {
+            if (useCascade)
+                bank->cascade(&surge->storage);
+            else
+                bank->chain(&surge->storage);
+        };
+        res.push_back(s);
+    }
+
+    for (bool grouped : {false, true})
+    {
+        // every voice LFO busy on a different shape, which is where grouping them pays
+        Scenario s;
+        s.name = grouped ? "lfo/voice-lfos-grouped" : "lfo/voice-lfos-per-voice";
+        s.setup = [grouped](SurgeSynthesizer *surge) {
+            static constexpr int shapes[n_lfos_voice] = {lt_sine, lt_tri,  lt_square,
+                                                         lt_ramp, lt_snh, lt_stepseq};
+            auto &scene = surge->storage.getPatch().scene[0];
+            Parameter *targets[n_lfos_voice] = {
+                &scene.osc[0].pitch,         &scene.osc[1].pitch,
+                &scene.filterunit[0].cutoff, &scene.filterunit[1].cutoff,
+                &scene.pan,                  &scene.width};
+
+            surge->groupVoiceLFOs = grouped;
+
+            for (int i = 0; i < n_lfos_voice; ++i)
+            {
+                scene.lfo[i].shape.val.i = shapes[i];
+                surge->setModDepth01(targets[i]->id, (modsources)(ms_lfo1 + i), 0, 0, 0.1f);
+            }
+
+            playVoices(surge, 64);
+        };
+        res.push_back(s);
+    }
+
+    {
+        Scenario s;
+        s.name = "scene/dual";
+        s.setup = [](SurgeSynthesizer *surge) {
+            surge->storage.getPatch().scenemode.val.i = sm_dual;
+            playVoices(surge, 8);
+        };
+        res.push_back(s);
+    }
+
+    {
+        // one note per member channel, each bending and pressing its own way every block
+        Scenario s;
+        s.name = "mpe/8-channels";
+        s.setup = [](SurgeSynthesizer *surge) {
+            surge->mpeEnabled = true;
+            surge->storage.getPatch().polylimit.val.i = 8;
+            for (int ch = 1; ch <= 8; ++ch)
+                surge->playNote(ch, 48 + 3 * ch, 100, 0);
+        };
+        s.step = [](SurgeSynthesizer *surge, int step) {
+            for (int ch = 1; ch <= 8; ++ch)
+            {
+                auto ph = (step + 11 * ch) % 128;
+                surge->pitchBend(ch, (ph - 64) * 64);
+                surge->channelAftertouch(ch, ph);
+            }
+            surge->process();
+        };
+        res.push_back(s);
+    }
+
+    for (bool sleep : {false, true})
+    {
+        // what a track with Surge on it costs while nothing is playing
+        Scenario s;
+        s.name = sleep ? "idle/asleep" : "idle/awake";
+        s.setup = [sleep](SurgeSynthesizer *surge) {
+            surge->sleepWhenIdle = sleep;
+
+            auto hold = SurgeSynthesizer::sleepHoldSeconds + 1;
+            for (int i = 0; i < hold * surge->storage.samplerate / BLOCK_SIZE; ++i)
+                surge->process();
+        };
+        res.push_back(s);
+    }
+
+    {
+        Scenario s;
+        s.name = "io/patch-load";
+        s.loadAllPatches = true;
+        s.rendersAudio = false;
+        s.fixedSteps = 200;
+        s.step = [](SurgeSynthesizer *surge, int step) {
+            auto n = (int)surge->storage.patch_list.size();
+            if (n > 0)
+                surge->loadPatch((step * 37) % n);
+        };
+        res.push_back(s);
+    }
+
+    {
+        // a wavetable switch every block while the voices keep playing through it
+        Scenario s;
+        s.name = "io/wavetable-switch";
+        s.loadAllPatches = true;
+        s.fixedSteps = 200;
+        s.setup = [](SurgeSynthesizer *surge) {
+            surge->storage.getPatch().scene[0].osc[0].queue_type = ot_wavetable;
+            surge->process();
+            playVoices(surge, 8);
+        };
+        s.step = [](SurgeSynthesizer *surge, int step) {
+            auto n = (int)surge->storage.wt_list.size();
+            if (n > 0)
+                surge->storage.getPatch().scene[0].osc[0].wt.queue_id = (step * 13) % n;
+            surge->process();
+        };
+        res.push_back(s);
+    }
+
+    return res;
+}
+} // namespace Benchmarks
+} // namespace Surge
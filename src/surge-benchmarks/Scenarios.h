@@ -0,0 +1,66 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_SURGE_BENCHMARKS_SCENARIOS_H
+#define SURGE_SRC_SURGE_BENCHMARKS_SCENARIOS_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+class SurgeSynthesizer;
+
+namespace Surge
+{
+namespace Benchmarks
+{
+/*
+ * Bump this whenever a scenario is added, removed or changes what it plays, so results
+ * from different versions of the suite don't get compared as if they measured the same thing.
+ */
+static constexpr int suiteVersion = 4;
+
+struct Scenario
+{
+    std::string name;
+
+    // Whether the synth needs the patch and wavetable lists scanned
+    bool loadAllPatches{false};
+
+    // Configure a fresh synth and start whatever it plays. Runs before the warm up blocks.
+    std::function<void(SurgeSynthesizer *)> setup;
+
+    // One timed step. Unset means process a single block.
+    std::function<void(SurgeSynthesizer *, int step)> step;
+
+    // How many steps to time. Zero means however many blocks make up the requested length.
+    int fixedSteps{0};
+
+    // Whether each step renders one block of audio, so that a realtime factor means something
+    bool rendersAudio{true};
+};
+
+std::vector<Scenario> allScenarios();
+} // namespace Benchmarks
+} // namespace Surge
+
+#endif // SURGE_SRC_SURGE_BENCHMARKS_SCENARIOS_H
@@ -0,0 +1,265 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+/*
+ * surge-benchmarks runs a fixed set of scenarios (see Scenarios.cpp) and reports, for each,
+ * the realtime factor, the median and 99th percentile step time and how many allocations
+ * happened while it ran. Use --json to get the same thing in a form worth keeping around
+ * between releases.
+ */
+
+#include "HeadlessUtils.h"
+#include "Scenarios.h"
+#include "version.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+/*
+ * Count every operator new while a scenario is being timed, on any thread, so allocations
+ * the worker pool makes on our behalf show up too. Plain malloc calls aren't seen.
+ */
+static std::atomic<bool> countAllocations{false};
+static std::atomic<uint64_t> allocationCount{0}, allocationBytes{0};
+
+void *operator new(std::size_t sz)
+{
+    if (countAllocations.load(std::memory_order_relaxed))
+    {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocationBytes.fetch_add(sz, std::memory_order_relaxed);
+    }
+
+    if (auto p = std::malloc(sz ? sz : 1))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t sz) { return operator new(sz); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+namespace Surge
+{
+namespace Benchmarks
+{
+static constexpr int sampleRate = 48000;
+static constexpr int warmupBlocks = 50;
+
+struct Result
+{
+    std::string name;
+    int steps{0};
+    bool rendersAudio{true};
+    double realtimeFactor{0}, meanUs{0}, p50Us{0}, p99Us{0};
+    uint64_t allocations{0}, allocatedBytes{0};
+};
+
+static Result run(const Scenario &sc, double seconds)
+{
+    auto surge = Surge::Headless::createSurge(sampleRate, sc.loadAllPatches);
+
+    // the same notes and random streams every run
+    surge->storage.rngGen.g.seed(2112);
+
+    for (int i = 0; i < 10; ++i)
+        surge->process();
+
+    if (sc.setup)
+        sc.setup(surge.get());
+
+    for (int i = 0; i < warmupBlocks; ++i)
+        surge->process();
+
+    Result r;
+    r.name = sc.name;
+    r.rendersAudio = sc.rendersAudio;
+    r.steps = sc.fixedSteps > 0 ? sc.fixedSteps : (int)(seconds * sampleRate / BLOCK_SIZE);
+
+    std::vector<double> times(r.steps);
+
+    allocationCount = 0;
+    allocationBytes = 0;
+    countAllocations = true;
+
+    for (int i = 0; i < r.steps; ++i)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        if (sc.step)
+            sc.step(surge.get(), i);
+        else
+            surge->process();
+
+        auto end = std::chrono::high_resolution_clock::now();
+        times[i] = std::chrono::duration<double, std::micro>(end - start).count();
+    }
+
+    countAllocations = false;
+    r.allocations = allocationCount;
+    r.allocatedBytes = allocationBytes;
+
+    double total = 0;
+    for (auto t : times)
+        total += t;
+
+    std::sort(times.begin(), times.end());
+    r.meanUs = total / r.steps;
+    r.p50Us = times[r.steps / 2];
+    r.p99Us = times[std::min(r.steps - 1, r.steps * 99 / 100)];
+
+    if (sc.rendersAudio && total > 0)
+        r.realtimeFactor = (1e6 * r.steps * BLOCK_SIZE / sampleRate) / total;
+
+    return r;
+}
+
+static std::string jsonString(const std::string &s)
+{
+    std::string res = "\"";
+    for (auto c : s)
+    {
+        if (c == '"' || c == '\\')
+            res += '\\';
+        res += c;
+    }
+    return res + "\"";
+}
+
+static void writeJSON(std::ostream &os, const std::vector<Result> &results, double seconds)
+{
+    os << std::setprecision(6) << "{\n"
+       << "  \"suiteVersion\": " << suiteVersion << ",\n"
+       << "  \"surgeVersion\": " << jsonString(Surge::Build::FullVersionStr) << ",\n"
+       << "  \"gitHash\": " << jsonString(Surge::Build::GitHash) << ",\n"
+       << "  \"buildArch\": " << jsonString(Surge::Build::BuildArch) << ",\n"
+       << "  \"buildCompiler\": " << jsonString(Surge::Build::BuildCompiler) << ",\n"
+       << "  \"blockSize\": " << BLOCK_SIZE << ",\n"
+       << "  \"sampleRate\": " << sampleRate << ",\n"
+       << "  \"seconds\": " << seconds << ",\n"
+       << "  \"scenarios\": [\n";
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const auto &r = results[i];
+        os << "    {\"name\": " << jsonString(r.name) << ", \"steps\": " << r.steps
+           << ", \"realtimeFactor\": ";
+        if (r.rendersAudio)
+            os << r.realtimeFactor;
+        else
+            os << "null";
+        os << ", \"meanUs\": " << r.meanUs << ", \"p50Us\": " << r.p50Us
+           << ", \"p99Us\": " << r.p99Us << ", \"allocations\": " << r.allocations
+           << ", \"allocatedBytes\": " << r.allocatedBytes << "}"
+           << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+
+    os << "  ]\n}" << std::endl;
+}
+} // namespace Benchmarks
+} // namespace Surge
+
+int main(int argc, char **argv)
+{
+    using namespace Surge::Benchmarks;
+
+    std::string jsonPath, filter;
+    double seconds = 2.0;
+    bool listOnly = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            jsonPath = argv[++i];
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+            seconds = std::max(std::atof(argv[++i]), 0.01);
+        else if (strcmp(argv[i], "--list") == 0)
+            listOnly = true;
+        else
+        {
+            std::cout << "Usage: surge-benchmarks [--list] [--filter substring] [--seconds s] "
+                         "[--json file]\n\n"
+                      << "   --list             # show the scenarios and exit\n"
+                      << "   --filter substring # only run scenarios whose name contains this\n"
+                      << "   --seconds s        # audio to time for each block scenario (2)\n"
+                      << "   --json file        # write the results as JSON too, - for stdout\n";
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    std::vector<Result> results;
+
+    for (const auto &sc : allScenarios())
+    {
+        if (!filter.empty() && sc.name.find(filter) == std::string::npos)
+            continue;
+
+        if (listOnly)
+        {
+            std::cout << sc.name << "\n";
+            continue;
+        }
+
+        auto r = run(sc, seconds);
+        results.push_back(r);
+
+        std::cerr << std::fixed << std::setprecision(2) << std::left << std::setw(36) << r.name
+                  << std::right;
+        if (r.rendersAudio)
+            std::cerr << " rt x" << std::setw(8) << r.realtimeFactor;
+        else
+            std::cerr << "            ";
+        std::cerr << "  p50 " << std::setw(9) << r.p50Us << "us  p99 " << std::setw(9) << r.p99Us
+                  << "us  allocs " << r.allocations << std::endl;
+    }
+
+    if (jsonPath == "-")
+    {
+        writeJSON(std::cout, results, seconds);
+    }
+    else if (!jsonPath.empty())
+    {
+        std::ofstream of(jsonPath);
+        if (!of)
+        {
+            std::cerr << "Unable to write " << jsonPath << std::endl;
+            return 1;
+        }
+        writeJSON(of, results, seconds);
+    }
+
+    return 0;
+}
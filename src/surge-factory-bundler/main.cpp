@@ -0,0 +1,47 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+/*
+ * surge-factory-bundler packs the factory folders of a data directory into the bundle
+ * described in src/common/FactoryDataBundle.h. It runs on the build machine, so it isn't
+ * built when cross compiling, and the installers then ship the loose folders instead.
+ */
+
+#include "FactoryDataBundle.h"
+
+#include <iostream>
+
+int main(int argc, char **argv)
+{
+    if (argc != 3)
+    {
+        std::cout << "Usage: surge-factory-bundler datapath outfile" << std::endl;
+        return 1;
+    }
+
+    using Surge::Storage::FactoryDataBundle;
+
+    auto ok = FactoryDataBundle::write(string_to_path(argv[1]), FactoryDataBundle::packedSubdirs(),
+                                       string_to_path(argv[2]), std::cout);
+
+    return ok ? 0 : 1;
+}
@@ -23,11 +23,15 @@
 #include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
+#include <algorithm>
+#include <atomic>
 #include <thread>
+#include <unordered_map>
 #include <utility>
 
 #include "SurgeSynthesizer.h"
 #include "SurgeStorage.h"
+#include "RealtimeWorkerPool.h"
 #include "version.h"
 #include "filesystem/import.h"
 
@@ -735,6 +739,9 @@ class SurgeSynthesizerWithPythonExtensions : public SurgeSynthesizer
         float *dL = ptr + startBlock * BLOCK_SIZE;
         float *dR = ptr + buf.shape[1] + startBlock * BLOCK_SIZE;
 
+        // the caller holds on to the array, so other Python threads can run while we render
+        py::gil_scoped_release release;
+
         for (auto i = 0; i < blockIterations; ++i)
         {
             process();
@@ -903,6 +910,215 @@ SurgeSynthesizer *createSurge(float sr)
     return surge;
 }
 
+/*
+ * Renders a list of jobs, each a patch, some MIDI-ish events and a length, across a set of
+ * synths which are made and warmed up once when the renderer is created and then reused.
+ * Rendering runs on our own threads without the GIL, and since the synths share their
+ * read-only tables this is much lighter than a process per instance.
+ */
+class SurgePyBatchRenderer
+{
+  public:
+    enum EventKind
+    {
+        ev_noteOn,
+        ev_noteOff,
+        ev_pitchBend,
+        ev_controller,
+        ev_channelAftertouch,
+        ev_polyAftertouch,
+    };
+
+    struct Event
+    {
+        int sample;
+        EventKind kind;
+        int channel, data1, data2;
+    };
+
+    struct Job
+    {
+        std::string patch;
+        std::vector<Event> events;
+        int samples;
+    };
+
+    SurgePyBatchRenderer(float sr, int nThreads)
+    {
+        if (nThreads <= 0)
+            nThreads = std::max((int)std::thread::hardware_concurrency(), 1);
+
+        for (int i = 0; i < nThreads; ++i)
+        {
+            auto surge = std::unique_ptr<SurgeSynthesizerWithPythonExtensions>(
+                static_cast<SurgeSynthesizerWithPythonExtensions *>(createSurge(sr)));
+
+            // we are offline work, so let anyone playing live have the FX workers first
+            surge->workerPriority = RealtimeWorkerPool::priority_background;
+
+            for (int b = 0; b < 10; ++b)
+                surge->process();
+
+            // keep the startup patch around for jobs which don't name one
+            void *data{nullptr};
+            auto sz = surge->saveRaw(&data);
+            initPatch.assign((const char *)data, (const char *)data + sz);
+
+            synths.push_back(std::move(surge));
+        }
+    }
+
+    int getThreadCount() const { return (int)synths.size(); }
+
+    py::list render(const py::iterable &jobList)
+    {
+        std::vector<Job> jobs;
+        for (auto j : jobList)
+            jobs.push_back(parseJob(j.cast<py::tuple>()));
+
+        std::vector<py::array_t<float>> outputs;
+        std::vector<float *> outPtrs;
+        for (auto &j : jobs)
+        {
+            outputs.emplace_back(std::vector<py::ssize_t>{2, j.samples});
+            outPtrs.push_back(outputs.back().mutable_data());
+        }
+
+        std::vector<std::string> errors(jobs.size());
+
+        {
+            py::gil_scoped_release release;
+
+            std::atomic<size_t> nextJob{0};
+            std::vector<std::thread> threads;
+
+            for (size_t t = 0; t < synths.size() && t < jobs.size(); ++t)
+            {
+                threads.emplace_back([&, t]() {
+                    for (auto j = nextJob++; j < jobs.size(); j = nextJob++)
+                        errors[j] = renderJob(synths[t].get(), jobs[j], outPtrs[j]);
+                });
+            }
+
+            for (auto &t : threads)
+                t.join();
+        }
+
+        for (size_t j = 0; j < jobs.size(); ++j)
+        {
+            if (!errors[j].empty())
+                throw std::runtime_error("Job " + std::to_string(j) + ": " + errors[j]);
+        }
+
+        py::list res;
+        for (auto &o : outputs)
+            res.append(o);
+
+        return res;
+    }
+
+  private:
+    std::vector<std::unique_ptr<SurgeSynthesizerWithPythonExtensions>> synths;
+    std::vector<char> initPatch;
+
+    static Job parseJob(const py::tuple &t)
+    {
+        if (t.size() != 3)
+            throw std::invalid_argument("Each job must be a (patch, events, samples) tuple");
+
+        Job job;
+        if (!t[0].is_none())
+            job.patch = t[0].cast<std::string>();
+        job.samples = t[2].cast<int>();
+
+        if (job.samples <= 0)
+            throw std::invalid_argument("A job must render at least one sample");
+
+        if (!job.patch.empty() && !fs::exists(string_to_path(job.patch)))
+            throw std::invalid_argument("File not found: " + job.patch);
+
+        static const std::unordered_map<std::string, EventKind> kinds{
+            {"noteOn", ev_noteOn},
+            {"noteOff", ev_noteOff},
+            {"pitchBend", ev_pitchBend},
+            {"controller", ev_controller},
+            {"channelAftertouch", ev_channelAftertouch},
+            {"polyAftertouch", ev_polyAftertouch}};
+
+        for (auto e : t[1].cast<py::iterable>())
+        {
+            auto et = e.cast<py::tuple>();
+            if (et.size() < 4 || et.size() > 5)
+                throw std::invalid_argument(
+                    "Each event must be a (sample, kind, channel, data1[, data2]) tuple");
+
+            auto kind = kinds.find(et[1].cast<std::string>());
+            if (kind == kinds.end())
+                throw std::invalid_argument("Unknown event kind: " + et[1].cast<std::string>());
+
+            job.events.push_back({std::max(et[0].cast<int>(), 0), kind->second, et[2].cast<int>(),
+                                  et[3].cast<int>(), et.size() == 5 ? et[4].cast<int>() : 0});
+        }
+
+        std::stable_sort(job.events.begin(), job.events.end(),
+                         [](const auto &a, const auto &b) { return a.sample < b.sample; });
+
+        return job;
+    }
+
+    std::string renderJob(SurgeSynthesizerWithPythonExtensions *s, const Job &job, float *out)
+    {
+        // both of these stop every voice and rebuild the FX, so nothing rings on from the last job
+        if (job.patch.empty())
+            s->loadRaw(initPatch.data(), (int)initPatch.size(), false);
+        else if (!s->loadPatchByPath(job.patch.c_str(), -1, "Python"))
+            return "Unable to load " + job.patch;
+
+        float *outL = out, *outR = out + job.samples;
+        size_t ev = 0;
+
+        for (int pos = 0; pos < job.samples; pos += BLOCK_SIZE)
+        {
+            for (; ev < job.events.size() && job.events[ev].sample < pos + BLOCK_SIZE; ++ev)
+            {
+                const auto &e = job.events[ev];
+                s->setEventSampleOffset(e.sample - pos);
+
+                switch (e.kind)
+                {
+                case ev_noteOn:
+                    s->playNote(e.channel, e.data1, e.data2, 0);
+                    break;
+                case ev_noteOff:
+                    s->releaseNote(e.channel, e.data1, e.data2);
+                    break;
+                case ev_pitchBend:
+                    s->pitchBend(e.channel, e.data1);
+                    break;
+                case ev_controller:
+                    s->channelController(e.channel, e.data1, e.data2);
+                    break;
+                case ev_channelAftertouch:
+                    s->channelAftertouch(e.channel, e.data1);
+                    break;
+                case ev_polyAftertouch:
+                    s->polyAftertouch(e.channel, e.data1, e.data2);
+                    break;
+                }
+            }
+            s->setEventSampleOffset(0);
+
+            s->process();
+
+            auto n = std::min(BLOCK_SIZE, job.samples - pos);
+            memcpy(outL + pos, s->output[0], n * sizeof(float));
+            memcpy(outR + pos, s->output[1], n * sizeof(float));
+        }
+
+        return {};
+    }
+};
+
 // Prefix _ if using shared object within a Python package built with scikit-build
 #ifdef SKBUILD
 PYBIND11_MODULE(_surgepy, m)
@@ -914,6 +1130,18 @@ PYBIND11_MODULE(surgepy, m)
     m.def("createSurge", &createSurge, "Create a Surge XT instance", py::arg("sampleRate"));
     m.def(
         "getVersion", []() { return Surge::Build::FullVersionStr; }, "Get the version of Surge XT");
+    py::class_<SurgePyBatchRenderer>(m, "BatchRenderer")
+        .def(py::init<float, int>(), py::arg("sampleRate"), py::arg("threads") = 0)
+        .def("getThreadCount", &SurgePyBatchRenderer::getThreadCount,
+             "How many synths, and so jobs at once, this renderer has.")
+        .def("render", &SurgePyBatchRenderer::render,
+             "Render a list of (patch, events, samples) jobs in parallel, returning a list of\n"
+             "(2, samples) numpy arrays in the same order. patch is an .fxp path, or None for\n"
+             "the startup patch. Each event is (sample, kind, channel, data1[, data2]) where\n"
+             "kind is one of noteOn, noteOff, pitchBend, controller, channelAftertouch or\n"
+             "polyAftertouch.",
+             py::arg("jobs"));
+
     py::class_<SurgeSynthesizer::ID>(m, "SurgeSynthesizer_ID")
         .def(py::init<>())
         .def("getSynthSideId", &SurgeSynthesizer::ID::getSynthSideId)
@@ -1008,7 +1236,7 @@ PYBIND11_MODULE(surgepy, m)
         .def("getAllModRoutings", &SurgeSynthesizerWithPythonExtensions::getAllModRoutings,
              "Get the entire modulation matrix for this instance.")
 
-        .def("process", &SurgeSynthesizer::process,
+        .def("process", &SurgeSynthesizer::process, py::call_guard<py::gil_scoped_release>(),
              "Run Surge XT for one block and update the internal output buffer.")
         .def("getOutput", &SurgeSynthesizerWithPythonExtensions::getOutput,
              "Retrieve the internal output buffer as a 2 * BLOCK_SIZE numpy array.")
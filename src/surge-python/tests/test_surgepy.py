@@ -53,3 +53,32 @@ def test_set_tuningApplicationMode():
     s = surgepy.createSurge(44100)
     s.tuningApplicationMode = surgepy.TuningApplicationMode.RETUNE_ALL
     assert s.tuningApplicationMode == surgepy.TuningApplicationMode.RETUNE_ALL
+
+
+def test_batch_render():
+    """
+    Test rendering several jobs at once returns one buffer per job, in order.
+    """
+    r = surgepy.BatchRenderer(44100, threads=2)
+    assert r.getThreadCount() == 2
+
+    notes = [(0, "noteOn", 0, 60, 127), (20000, "noteOff", 0, 60)]
+    jobs = [(None, notes, 30000), (None, [], 1000), (None, notes, 12345)]
+    res = r.render(jobs)
+
+    assert len(res) == 3
+    assert res[0].shape == (2, 30000)
+    assert res[1].shape == (2, 1000)
+    assert res[2].shape == (2, 12345)
+    assert not np.all(res[0] == 0.0)
+    assert np.all(res[1] == 0.0)
+    assert not np.all(res[2] == 0.0)
+
+
+def test_batch_render_bad_event():
+    r = surgepy.BatchRenderer(44100, threads=1)
+    try:
+        r.render([(None, [(0, "noSuchEvent", 0, 60)], 100)])
+        assert False
+    except ValueError:
+        pass
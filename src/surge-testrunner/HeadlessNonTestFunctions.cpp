@@ -25,7 +25,9 @@
 #include <iostream>
 #include <sstream>
 #include <chrono>
-#include <deque>
+#include <iomanip>
+#include <vector>
+#include <cstring>
 
 namespace Surge
 {
@@ -534,86 +536,6 @@ void filterAnalyzer(int ft, int sft, std::ostream &os)
     middleCSawIntoFilterVsReso(ft, sft, os);
 }
 
-[[noreturn]] void performancePlay(const std::string &patchName, int mode)
-{
-    auto surge = Surge::Headless::createSurge(48000);
-    std::cout << "Performance Mode with Surge XT at 48k\n"
-              << "-- Ctrl-C to exit\n"
-              << "-- patchName = " << patchName << "\n"
-              << "-- mode = " << mode << std::endl;
-
-    surge->loadPatchByPath(patchName.c_str(), -1, "RUNTIME");
-
-#if SINE_STRESS_TEST
-    /*
-     * This was for my sine stress testing
-     */
-    for (int s = 0; s < n_scenes; ++s)
-        for (int o = 0; o < n_oscs; ++o)
-            surge->storage.getPatch().scene[s].osc[o].p[0].val.i = mode;
-#endif
-
-    for (int i = 0; i < 10; ++i)
-        surge->process();
-
-    surge->playNote(0, 60, 127, 0);
-
-    int ct = 0;
-    int nt = 0;
-    int noteOnEvery = 48000 / BLOCK_SIZE / 10;
-    std::deque<int> notesOn;
-    notesOn.push_back(60);
-
-#define PLAY_NOTES 1
-
-    int target = 48000 / BLOCK_SIZE;
-    auto cpt = std::chrono::high_resolution_clock::now();
-    std::chrono::seconds oneSec(1);
-    auto msOne = std::chrono::duration_cast<std::chrono::microseconds>(oneSec).count();
-    while (true)
-    {
-        surge->process();
-#if PLAY_NOTES
-
-        if (nt++ == noteOnEvery)
-        {
-            int nextNote = notesOn.back() + 1;
-            if (notesOn.size() == 10)
-            {
-                auto removeNote = notesOn.front();
-                notesOn.pop_front();
-                surge->releaseNote(0, removeNote, 0);
-                nextNote = removeNote - 1;
-            }
-            if (nextNote < 10)
-                nextNote = 120;
-            if (nextNote > 121)
-                nextNote = 10;
-
-            notesOn.push_back(nextNote);
-            surge->playNote(0, nextNote, 127, 0);
-            nt = 0;
-        }
-#endif
-        if (ct++ == target)
-        {
-            auto et = std::chrono::high_resolution_clock::now();
-            auto diff = et - cpt;
-            auto ms = std::chrono::duration_cast<std::chrono::microseconds>(diff).count();
-            double pct = 1.0 * ms / msOne * 100.0;
-
-            float sum = 0;
-            for (int i = 0; i < BLOCK_SIZE; ++i)
-                sum += surge->output[0][i] * surge->output[0][i];
-
-            std::cout << "Resetting timers " << ms << "ms / " << pct << "% L2N=" << sum
-                      << std::endl;
-            ct = 0;
-            cpt = et;
-        }
-    }
-}
-
 void generateNLFeedbackNorms()
 {
     /*
@@ -743,6 +665,144 @@ void generateNLFeedbackNorms()
               << "      if (useNormalization) normNumerator = lpNormTable[subtype];\n";
 }
 
+/*
+ * Compare the per-sample host copy loop the plugin processBlock used to run with the
+ * chunked copy it runs now, across a handful of host buffer sizes. Both render the same
+ * engine blocks; only the way the engine output reaches the host buffer differs.
+ */
+void processBlockCopyBenchmark()
+{
+    auto surge = Surge::Headless::createSurge(48000);
+    surge->activateExtraOutputs = true;
+
+    for (int i = 0; i < 10; ++i)
+        surge->process();
+
+    for (auto k : {48, 55, 60, 64, 67})
+        surge->playNote(0, k, 100, 0);
+
+    constexpr int samplesPerRun = 48000 * 20;
+
+    for (auto hostBlock : {32, 64, 100, 128, 256, 441, 512, 1024})
+    {
+        std::vector<float> in(hostBlock), out[6];
+        for (auto &o : out)
+            o.resize(hostBlock);
+
+        float latent[2][BLOCK_SIZE];
+
+        auto runOne = [&](bool chunked) {
+            int blockPos = 0;
+            auto start = std::chrono::high_resolution_clock::now();
+
+            for (int done = 0; done < samplesPerRun; done += hostBlock)
+            {
+                if (chunked)
+                {
+                    int i = 0;
+                    while (i < hostBlock)
+                    {
+                        if (blockPos == 0)
+                            surge->process();
+
+                        auto n = std::min(BLOCK_SIZE - blockPos, hostBlock - i);
+                        auto nb = n * sizeof(float);
+
+                        memcpy(&latent[0][blockPos], in.data() + i, nb);
+                        memcpy(&latent[1][blockPos], in.data() + i, nb);
+                        memcpy(out[0].data() + i, &surge->output[0][blockPos], nb);
+                        memcpy(out[1].data() + i, &surge->output[1][blockPos], nb);
+
+                        for (int s = 0; s < n_scenes; ++s)
+                        {
+                            memcpy(out[2 + 2 * s].data() + i, &surge->sceneout[s][0][blockPos],
+                                   nb);
+                            memcpy(out[3 + 2 * s].data() + i, &surge->sceneout[s][1][blockPos],
+                                   nb);
+                        }
+
+                        i += n;
+                        blockPos = (blockPos + n) & (BLOCK_SIZE - 1);
+                    }
+                }
+                else
+                {
+                    for (int i = 0; i < hostBlock; ++i)
+                    {
+                        if (blockPos == 0)
+                            surge->process();
+
+                        latent[0][blockPos] = in[i];
+                        latent[1][blockPos] = in[i];
+                        out[0][i] = surge->output[0][blockPos];
+                        out[1][i] = surge->output[1][blockPos];
+
+                        for (int s = 0; s < n_scenes; ++s)
+                        {
+                            out[2 + 2 * s][i] = surge->sceneout[s][0][blockPos];
+                            out[3 + 2 * s][i] = surge->sceneout[s][1][blockPos];
+                        }
+
+                        blockPos = (blockPos + 1) & (BLOCK_SIZE - 1);
+                    }
+                }
+            }
+
+            auto end = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        };
+
+        auto perSample = runOne(false);
+        auto chunked = runOne(true);
+
+        std::cout << "host block " << std::setw(5) << hostBlock << " : per-sample "
+                  << std::setw(8) << perSample << "us  chunked " << std::setw(8) << chunked
+                  << "us  ratio " << std::setprecision(3) << 1.0 * perSample / chunked
+                  << std::endl;
+    }
+}
+
+void startupBenchmark()
+{
+    /*
+     * Time from constructing an instance to having its first block in hand. We hold on to
+     * every instance so the later ones see the process-wide core the first one built,
+     * which is what a host opening a session full of Surges sees. We do it once bare and
+     * once with the patch and wavetable lists loaded, as the plugin does.
+     */
+    constexpr int instances = 16;
+
+    for (bool withLists : {false, true})
+    {
+        std::vector<std::shared_ptr<SurgeSynthesizer>> held;
+        std::vector<double> times;
+
+        for (int i = 0; i < instances; ++i)
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+
+            auto surge = Surge::Headless::createSurge(48000, withLists);
+            surge->playNote(0, 60, 100, 0);
+            surge->process();
+
+            auto end = std::chrono::high_resolution_clock::now();
+            times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+            held.push_back(surge);
+        }
+
+        double rest = 0;
+        for (int i = 1; i < instances; ++i)
+            rest += times[i];
+        rest /= instances - 1;
+
+        std::cout << (withLists ? "with patch and wavetable lists\n" : "without lists\n")
+                  << std::fixed << std::setprecision(2) << "  first instance : " << times[0]
+                  << "ms\n"
+                  << "  later instances: " << rest << "ms on average over " << instances - 1
+                  << std::endl;
+    }
+}
+
 } // namespace NonTest
 } // namespace Headless
 } // namespace Surge
@@ -22,6 +22,7 @@
 #ifndef SURGE_SRC_SURGE_TESTRUNNER_HEADLESSNONTESTFUNCTIONS_H
 #define SURGE_SRC_SURGE_TESTRUNNER_HEADLESSNONTESTFUNCTIONS_H
 #include <iostream>
+#include <string>
 
 namespace Surge
 {
@@ -34,7 +35,8 @@ void restreamTemplatesWithModifications();
 void statsFromPlayingEveryPatch();
 void filterAnalyzer(int ft, int fst, std::ostream &os);
 void generateNLFeedbackNorms();
-[[noreturn]] void performancePlay(const std::string &patchName, int mode);
+void processBlockCopyBenchmark();
+void startupBenchmark();
 } // namespace NonTest
 } // namespace Headless
 } // namespace Surge
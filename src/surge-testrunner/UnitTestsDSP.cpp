@@ -21,19 +21,24 @@
  */
 #include <iostream>
 #include <algorithm>
+#include <set>
 
 #include "HeadlessUtils.h"
 #include "Player.h"
+#include "SurgeMemoryPools.h"
 
 #include "catch2/catch2.hpp"
 
 #include "UnitTestUtilities.h"
 
 #include "samplerate.h"
+#include "IntegerRatioUpsampler.h"
+#include "BiquadCascade.h"
 
 #include "SSEComplex.h"
 #include <complex>
 #include "sst/basic-blocks/mechanics/simd-ops.h"
+#include "sst/basic-blocks/dsp/Clippers.h"
 
 #include "sst/plugininfra/cpufeatures.h"
 
@@ -464,6 +469,403 @@ TEST_CASE("Every Oscillator Plays", "[dsp]")
     }
 }
 
+TEST_CASE("Twist Note On Storms Stay In The Pool", "[osc]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto &pool = surge->storage.memoryPools->twistStates;
+
+    surge->storage.getPatch().scene[0].osc[0].queue_type = ot_twist;
+    for (int q = 0; q < 10; ++q)
+        surge->process();
+
+    REQUIRE(surge->storage.getPatch().scene[0].osc[0].type.val.i == ot_twist);
+
+    // switching to twist sizes the pool for the polyphony limit, once the housekeeping has run
+    auto poly = surge->storage.getPatch().polylimit.val.i;
+    surge->runHousekeeping();
+    surge->process();
+    auto before = pool.position;
+    REQUIRE(before == (size_t)poly + 4);
+
+    std::set<TwistOscillator::State *> preallocated(pool.pool.begin(),
+                                                    pool.pool.begin() + before);
+
+    for (int storm = 0; storm < 10; ++storm)
+    {
+        INFO("Storm " << storm);
+
+        // more notes than voices, so stealing returns and re-draws states as we go
+        for (int k = 0; k < 2 * poly; ++k)
+        {
+            surge->playNote(0, 36 + (k * 7 + storm * 5) % 60, 100, 0);
+            surge->process();
+        }
+
+        for (int q = 0; q < 20; ++q)
+            surge->process();
+
+        surge->allNotesOff();
+        for (int q = 0; q < 10; ++q)
+            surge->process();
+
+        // nothing grew, and everything handed out came back
+        REQUIRE(pool.position == before);
+        for (size_t i = 0; i < pool.position; ++i)
+            REQUIRE(preallocated.count(pool.pool[i]) == 1);
+    }
+
+    // raising the polyphony limit grows the pool off the audio thread, ahead of the notes
+    surge->storage.getPatch().polylimit.val.i = MAX_VOICES;
+    surge->process();
+    surge->runHousekeeping();
+    surge->process();
+    auto allocated = pool.allocated.load();
+    REQUIRE(allocated == (size_t)MAX_VOICES);
+
+    for (int k = 0; k < 2 * MAX_VOICES; ++k)
+    {
+        surge->playNote(0, 36 + (k * 7) % 60, 100, 0);
+        surge->process();
+    }
+    REQUIRE(pool.allocated == allocated);
+
+    surge->allNotesOff();
+    for (int q = 0; q < 10; ++q)
+        surge->process();
+    REQUIRE(pool.position == allocated);
+
+    // and reused states still sound
+    float sumAbsOut = 0;
+    surge->playNote(0, 60, 127, 0);
+    for (int q = 0; q < 100; ++q)
+    {
+        surge->process();
+        for (int s = 0; s < BLOCK_SIZE; ++s)
+            sumAbsOut += fabs(surge->output[0][s]);
+    }
+    REQUIRE(sumAbsOut > 1);
+}
+
+TEST_CASE("String Delay Lines Come In Size Classes", "[osc]")
+{
+    auto surge = Surge::Headless::createSurge(48000);
+    REQUIRE(surge);
+
+    auto &pools = *surge->storage.memoryPools;
+    auto inUse = [](const auto &pool) { return pool.allocated - pool.position; };
+    auto longInUse = [&]() {
+        return inUse(pools.stringDelayLines8k) + inUse(pools.stringDelayLines16k);
+    };
+
+    auto allocated = [&]() {
+        return std::array<size_t, 4>{
+            pools.stringDelayLines2k.allocated, pools.stringDelayLines4k.allocated,
+            pools.stringDelayLines8k.allocated, pools.stringDelayLines16k.allocated};
+    };
+    auto emptyPools = allocated();
+
+    // lift the strings two octaves, so the lowest note can't reach the longest class
+    surge->storage.getPatch().scene[0].osc[0].octave.val.i = 2;
+    surge->storage.getPatch().scene[0].osc[0].queue_type = ot_string;
+    for (int q = 0; q < 10; ++q)
+        surge->process();
+
+    REQUIRE(surge->storage.getPatch().scene[0].osc[0].type.val.i == ot_string);
+
+    // the switch only asks for the pools; nothing grows until the housekeeping has run
+    REQUIRE(allocated() == emptyPools);
+    surge->runHousekeeping();
+    surge->process();
+
+    auto poly = (size_t)surge->storage.getPatch().polylimit.val.i;
+    auto preallocated = allocated();
+    REQUIRE(preallocated[0] == poly);
+    REQUIRE(preallocated[1] == poly);
+    REQUIRE(preallocated[2] == poly);
+    REQUIRE(preallocated[3] == emptyPools[3]);
+    REQUIRE(pools.stringDelayLines2k.position == poly);
+    surge->storage.getPatch().scene[0].osc[0].octave.val.i = 0;
+
+    auto playFor = [&](int blocks) {
+        float sumAbsOut = 0;
+        for (int q = 0; q < blocks; ++q)
+        {
+            surge->process();
+            for (int s = 0; s < BLOCK_SIZE; ++s)
+            {
+                REQUIRE(std::isfinite(surge->output[0][s]));
+                sumAbsOut += fabs(surge->output[0][s]);
+            }
+        }
+        return sumAbsOut;
+    };
+
+    SECTION("High Notes Take Short Lines")
+    {
+        surge->playNote(0, 96, 127, 0);
+        REQUIRE(playFor(20) > 0.1);
+        REQUIRE(inUse(pools.stringDelayLines2k) == 2);
+        REQUIRE(inUse(pools.stringDelayLines4k) == 0);
+        REQUIRE(longInUse() == 0);
+
+        surge->allNotesOff();
+        playFor(5);
+        REQUIRE(inUse(pools.stringDelayLines2k) == 0);
+    }
+
+    SECTION("Low Notes Take Long Lines")
+    {
+        surge->playNote(0, 24, 127, 0);
+        REQUIRE(playFor(20) > 0.1);
+        REQUIRE(inUse(pools.stringDelayLines2k) == 0);
+        REQUIRE(longInUse() == 2);
+
+        surge->allNotesOff();
+        playFor(5);
+        REQUIRE(longInUse() == 0);
+    }
+
+    SECTION("Dropping Pitch While Playing Grows The Lines")
+    {
+        surge->playNote(0, 72, 127, 0);
+        playFor(10);
+        REQUIRE(inUse(pools.stringDelayLines2k) == 2);
+
+        surge->storage.getPatch().scene[0].osc[0].octave.val.i = -3;
+        REQUIRE(playFor(20) > 0.1);
+        REQUIRE(inUse(pools.stringDelayLines2k) == 0);
+        REQUIRE(inUse(pools.stringDelayLines4k) + longInUse() == 2);
+
+        surge->allNotesOff();
+        playFor(5);
+        REQUIRE(inUse(pools.stringDelayLines4k) + longInUse() == 0);
+    }
+
+    SECTION("A Full Polyphony Of Low FM'd Notes")
+    {
+        auto &osc = surge->storage.getPatch().scene[0].osc[0];
+        surge->storage.getPatch().scene[0].fm_switch.val.i = fm_2and3to1;
+        surge->storage.getPatch().scene[0].fm_depth.val.f = 0.5f;
+        osc.octave.val.i = -3;
+
+        for (int k = 0; k < surge->storage.getPatch().polylimit.val.i + 4; ++k)
+        {
+            surge->playNote(0, 24 + k, 127, 0);
+            playFor(1);
+        }
+        REQUIRE(playFor(20) > 0.1);
+        REQUIRE(longInUse() > 0);
+
+        surge->allNotesOff();
+        playFor(5);
+        REQUIRE(longInUse() == 0);
+
+        // more than the pools were sized for, so they grew; the housekeeping trims them back
+        REQUIRE(allocated() != preallocated);
+        surge->runHousekeeping();
+        playFor(1);
+        surge->runHousekeeping();
+    }
+
+    SECTION("Raising The Polyphony Limit Grows The Pools Off The Audio Thread")
+    {
+        surge->storage.getPatch().polylimit.val.i = 2 * poly;
+        playFor(1);
+        REQUIRE(allocated() == preallocated);
+
+        surge->runHousekeeping();
+        playFor(1);
+        REQUIRE(pools.stringDelayLines2k.allocated == 2 * poly);
+        REQUIRE(pools.stringDelayLines2k.position == 2 * poly);
+
+        surge->storage.getPatch().polylimit.val.i = poly;
+        playFor(1);
+        surge->runHousekeeping();
+    }
+
+    REQUIRE(allocated() == preallocated);
+    REQUIRE(pools.residentBytes() > 0);
+}
+
+TEST_CASE("Integer Ratio Upsampler Tracks A Sine", "[dsp]")
+{
+    for (int ratio : {1, 2, 4})
+    {
+        DYNAMIC_SECTION("Ratio " << ratio)
+        {
+            IntegerRatioUpsampler<BLOCK_SIZE> up;
+            up.setRatio(ratio);
+            up.reset();
+
+            const double dIn = 2.0 * M_PI * 440.0 / 48000.0, dOut = dIn / ratio;
+            int inSample = 0, outSample = 0;
+            float maxErr = 0;
+
+            for (int block = 0; block < 200; ++block)
+            {
+                while (up.inputsRequiredToGenerateOutputs(BLOCK_SIZE_OS) > 0)
+                {
+                    auto v = (float)std::sin(dIn * inSample++);
+                    up.push(v, -v);
+                }
+
+                float L[BLOCK_SIZE_OS], R[BLOCK_SIZE_OS];
+                up.populateNextBlockSizeOS(L, R);
+                up.renormalizePhases();
+
+                for (int i = 0; i < BLOCK_SIZE_OS; ++i, ++outSample)
+                {
+                    // the first few outputs still see the zeroed history
+                    if (outSample < 8 * ratio)
+                        continue;
+
+                    auto expected = (float)std::sin(dOut * outSample);
+                    maxErr = std::max(maxErr, std::fabs(L[i] - expected));
+                    REQUIRE(R[i] == Approx(-L[i]));
+                }
+            }
+
+            REQUIRE(maxErr < 2e-3);
+        }
+    }
+}
+
+TEST_CASE("Biquad Cascade Skips Flat Bands", "[dsp]")
+{
+    auto surge = Surge::Headless::createSurge(48000);
+    auto *storage = &surge->storage;
+
+    static constexpr int nBands = 4;
+    double gains[nBands] = {6.0, 0.0, -4.0, 0.0};
+
+    BiquadCascade<nBands> cascade(storage);
+    std::vector<std::unique_ptr<BiquadFilter>> chain;
+
+    for (int i = 0; i < nBands; ++i)
+    {
+        auto omega = cascade[i].calc_omega_from_Hz(100.0 * (i + 1) * (i + 1));
+        cascade.coeff_peakEQ(i, omega, 0.5, gains[i]);
+
+        chain.push_back(std::make_unique<BiquadFilter>(storage));
+        chain.back()->coeff_peakEQ(omega, 0.5, gains[i]);
+    }
+
+    cascade.suspend();
+    for (auto &f : chain)
+        f->suspend();
+
+    float cL alignas(16)[BLOCK_SIZE], cR alignas(16)[BLOCK_SIZE];
+    float rL alignas(16)[BLOCK_SIZE], rR alignas(16)[BLOCK_SIZE];
+    float maxDiff = 0;
+
+    // a second of noise is well past the point where the flat bands drop out
+    for (int b = 0; b < 48000 / BLOCK_SIZE; ++b)
+    {
+        for (int k = 0; k < BLOCK_SIZE; ++k)
+        {
+            rL[k] = cL[k] = storage->rand_pm1();
+            rR[k] = cR[k] = storage->rand_pm1();
+        }
+
+        cascade.process_block(cL, cR);
+        for (auto &f : chain)
+            f->process_block(rL, rR);
+
+        for (int k = 0; k < BLOCK_SIZE; ++k)
+            maxDiff = std::max({maxDiff, std::fabs(cL[k] - rL[k]), std::fabs(cR[k] - rR[k])});
+    }
+
+    REQUIRE(maxDiff < 1e-4);
+
+    REQUIRE(cascade.isProcessing(0));
+    REQUIRE(!cascade.isProcessing(1));
+    REQUIRE(cascade.isProcessing(2));
+    REQUIRE(!cascade.isProcessing(3));
+
+    // moving a flat band puts it straight back in the chain
+    cascade.coeff_peakEQ(1, cascade[1].calc_omega_from_Hz(400.0), 0.5, 3.0);
+    REQUIRE(cascade.isProcessing(1));
+
+    cascade.setActive(2, false);
+    REQUIRE(!cascade.isProcessing(2));
+}
+
+TEST_CASE("Fused Scene Low Cut Matches The Chain", "[dsp]")
+{
+    auto surge = Surge::Headless::createSurge(48000);
+    auto *storage = &surge->storage;
+
+    static constexpr int nBands = 4;
+
+    for (int slope = 0; slope < nBands; ++slope)
+    {
+        for (bool clip0dB : {false, true})
+        {
+            DYNAMIC_SECTION("Slope " << slope << (clip0dB ? " clip 0 dBFS" : " clip 18 dBFS"))
+            {
+                BiquadCascade<nBands> fused(storage), chain(storage);
+
+                float fL alignas(16)[BLOCK_SIZE], fR alignas(16)[BLOCK_SIZE];
+                float cL alignas(16)[BLOCK_SIZE], cR alignas(16)[BLOCK_SIZE];
+                float maxDiff = 0;
+                auto limit = clip0dB ? 1.f : 8.f;
+
+                for (int b = 0; b < 24000 / BLOCK_SIZE; ++b)
+                {
+                    // sweep the cutoff like a modulated low cut would, so the smoothing runs
+                    auto freq = -36.f + 24.f * std::sin(b * 0.05f);
+
+                    for (int i = 0; i < nBands; ++i)
+                    {
+                        fused.setActive(i, i <= slope);
+                        chain.setActive(i, i <= slope);
+
+                        if (i <= slope)
+                        {
+                            fused[i].coeff_HP(fused[i].calc_omega(freq / 12.0), 0.4);
+                            chain[i].coeff_HP(chain[i].calc_omega(freq / 12.0), 0.4);
+                        }
+                    }
+
+                    // loud enough for the clip to bite
+                    for (int k = 0; k < BLOCK_SIZE; ++k)
+                    {
+                        fL[k] = cL[k] = 12.f * storage->rand_pm1();
+                        fR[k] = cR[k] = 12.f * storage->rand_pm1();
+                    }
+
+                    chain.process_block(cL, cR);
+                    if (clip0dB)
+                    {
+                        sst::basic_blocks::dsp::hardclip_block<BLOCK_SIZE>(cL);
+                        sst::basic_blocks::dsp::hardclip_block<BLOCK_SIZE>(cR);
+                    }
+                    else
+                    {
+                        sst::basic_blocks::dsp::hardclip_block8<BLOCK_SIZE>(cL);
+                        sst::basic_blocks::dsp::hardclip_block8<BLOCK_SIZE>(cR);
+                    }
+
+                    fused.process_block_fused(fL, fR, [limit](float x) {
+                        return std::clamp(x, -limit, limit);
+                    });
+
+                    for (int k = 0; k < BLOCK_SIZE; ++k)
+                    {
+                        REQUIRE(std::fabs(fL[k]) <= limit);
+                        maxDiff = std::max(
+                            {maxDiff, std::fabs(fL[k] - cL[k]), std::fabs(fR[k] - cR[k])});
+                    }
+                }
+
+                REQUIRE(maxDiff < 1e-5);
+            }
+        }
+    }
+}
+
 TEST_CASE("Untuned is 2^x", "[dsp]")
 {
     auto surge = Surge::Headless::createSurge(44100);
@@ -26,6 +26,7 @@
 
 #include "HeadlessUtils.h"
 #include "Player.h"
+#include "QuadFilterChain.h"
 
 #include "catch2/catch2.hpp"
 
@@ -100,3 +101,65 @@ TEST_CASE("Run Every Waveshaper", "[flt]")
         }
     }
 }
+
+TEST_CASE("Quad Filter Chain Runs At Either Built Block Size", "[flt]")
+{
+    constexpr int full = BLOCK_SIZE_OS, half = BLOCK_SIZE_OS / 2;
+
+    for (int cfg = 0; cfg < n_filter_configs; ++cfg)
+    {
+        DYNAMIC_SECTION("Configuration " << cfg)
+        {
+            auto a = std::make_unique<QuadFilterChainState>();
+            auto b = std::make_unique<QuadFilterChainStateT<half>>();
+            InitQuadFilterChainStateToZero(a.get());
+            InitQuadFilterChainStateToZero(b.get());
+
+            // the ramps carry on across the two half blocks just as across the one full one
+            auto setup = [](auto &q) {
+                for (auto &fu : q.FU)
+                    for (auto &on : fu.active)
+                        on = 0xffffffff;
+                q.Gain = _mm_set1_ps(0.5f);
+                q.dGain = _mm_set1_ps(0.01f);
+                q.Mix1 = q.Mix2 = _mm_set1_ps(0.3f);
+                q.dOutL = q.dOut2L = _mm_set1_ps(0.002f);
+                q.dOutR = q.dOut2R = _mm_set1_ps(0.003f);
+            };
+            setup(*a);
+            setup(*b);
+
+            float in[full];
+            for (int k = 0; k < full; ++k)
+                in[k] = 0.1f * (k % 7) - 0.3f;
+
+            fbq_global g{};
+            float outLA[full]{}, outRA[full]{}, outLB[full]{}, outRB[full]{};
+
+            for (int k = 0; k < full; ++k)
+            {
+                a->DL[k] = _mm_set1_ps(in[k]);
+                a->DR[k] = _mm_set1_ps(-in[k]);
+            }
+            GetFBQPointer(cfg, false, false, false)(*a, g, outLA, outRA);
+
+            auto processHalf = GetFBQPointerFor<half>(cfg, false, false, false);
+            for (int h = 0; h < 2; ++h)
+            {
+                for (int k = 0; k < half; ++k)
+                {
+                    b->DL[k] = _mm_set1_ps(in[h * half + k]);
+                    b->DR[k] = _mm_set1_ps(-in[h * half + k]);
+                }
+                processHalf(*b, g, outLB + h * half, outRB + h * half);
+            }
+
+            for (int k = 0; k < full; ++k)
+            {
+                INFO("Sample " << k);
+                REQUIRE(outLA[k] == outLB[k]);
+                REQUIRE(outRA[k] == outRB[k]);
+            }
+        }
+    }
+}
@@ -28,6 +28,9 @@
 #include "Player.h"
 
 #include "SurgeStorage.h"
+#include "CombulatorEffect.h"
+#include "Reverb2Effect.h"
+#include "VocoderEffect.h"
 #include "catch2/catch2.hpp"
 
 #include "UnitTestUtilities.h"
@@ -422,3 +425,495 @@ TEST_CASE("High SampleRate Nimbus", "[fx]")
         }
     }
 }
+
+TEST_CASE("Parallel FX Chains Match Serial", "[fx]")
+{
+    auto makeSurge = [](bool parallel) {
+        auto surge = Surge::Headless::createSurge(44100);
+        REQUIRE(surge);
+
+        surge->storage.rngGen.g.seed(17);
+        surge->storage.getPatch().scenemode.val.i = sm_dual;
+
+        // a pool of our own, so the chains really do leave the audio thread on a single core
+        if (parallel)
+        {
+            surge->fxWorkers = std::make_shared<RealtimeWorkerPool>(2);
+            surge->setProcessFXInParallel(true);
+        }
+
+        // combulator's noise draws random numbers, which have to match wherever they're drawn
+        for (auto [slot, type] : {std::make_pair(fxslot_ains1, fxt_delay),
+                                  std::make_pair(fxslot_ains2, fxt_combulator),
+                                  std::make_pair(fxslot_bins1, fxt_reverb2),
+                                  std::make_pair(fxslot_send1, fxt_eq),
+                                  std::make_pair(fxslot_send2, fxt_distortion)})
+        {
+            auto *pt = &(surge->storage.getPatch().fx[slot].type);
+            auto awv = 1.f * type / (pt->val_max.i - pt->val_min.i);
+            surge->setParameter01(surge->idForParameter(pt), awv, false);
+        }
+
+        for (int sc = 0; sc < n_scenes; ++sc)
+        {
+            auto &scene = surge->storage.getPatch().scene[sc];
+            scene.send_level[0].set_value_f01(0.7);
+            scene.send_level[1].set_value_f01(0.5);
+        }
+
+        for (int i = 0; i < 10; ++i)
+            surge->process();
+
+        surge->storage.getPatch().fx[fxslot_ains2].p[CombulatorEffect::combulator_noise_mix].val.f =
+            0.5f;
+
+        return surge;
+    };
+
+    auto serial = makeSurge(false);
+    auto parallel = makeSurge(true);
+    REQUIRE(parallel->fxWorkers->workerCount() == 2);
+
+    for (auto s : {serial, parallel})
+    {
+        s->playNote(0, 48, 100, 0);
+        s->playNote(0, 55, 100, 0);
+    }
+
+    for (int b = 0; b < 500; ++b)
+    {
+        if (b == 250)
+        {
+            for (auto s : {serial, parallel})
+            {
+                s->releaseNote(0, 48, 0);
+                s->releaseNote(0, 55, 0);
+            }
+        }
+
+        serial->process();
+        parallel->process();
+
+        INFO("Block " << b);
+        for (int c = 0; c < 2; ++c)
+        {
+            for (int i = 0; i < BLOCK_SIZE; ++i)
+            {
+                REQUIRE(serial->output[c][i] == parallel->output[c][i]);
+            }
+        }
+    }
+}
+
+TEST_CASE("Idle Engine Sleeps And Wakes", "[fx]")
+{
+    auto surge = Surge::Headless::createSurge(48000);
+    REQUIRE(surge);
+
+    auto blocksFor = [&surge](float seconds) {
+        return (int)(seconds * surge->storage.samplerate / BLOCK_SIZE);
+    };
+
+    auto allZero = [&surge]() {
+        for (int c = 0; c < 2; ++c)
+            for (int k = 0; k < BLOCK_SIZE; ++k)
+                if (surge->output[c][k] != 0.f)
+                    return false;
+        return true;
+    };
+
+    SECTION("Sleeps once silent and wakes on a note")
+    {
+        for (int i = 0; i < blocksFor(SurgeSynthesizer::sleepHoldSeconds + 1); ++i)
+            surge->process();
+
+        REQUIRE(surge->isSleeping());
+        surge->process();
+        REQUIRE(allZero());
+
+        surge->playNote(0, 60, 100, 0);
+        surge->process();
+        REQUIRE(!surge->isSleeping());
+
+        float peak = 0;
+        for (int i = 0; i < 20; ++i)
+        {
+            surge->process();
+            for (int k = 0; k < BLOCK_SIZE; ++k)
+                peak = std::max(peak, std::fabs(surge->output[0][k]));
+        }
+        REQUIRE(peak > 0.01);
+
+        // and goes back to sleep once the note and its tail are gone
+        surge->releaseNote(0, 60, 0);
+        for (int i = 0; i < blocksFor(SurgeSynthesizer::sleepHoldSeconds + 5); ++i)
+            surge->process();
+        REQUIRE(surge->isSleeping());
+    }
+
+    SECTION("Stays awake when asked to")
+    {
+        surge->sleepWhenIdle = false;
+
+        for (int i = 0; i < blocksFor(SurgeSynthesizer::sleepHoldSeconds + 1); ++i)
+            surge->process();
+
+        REQUIRE(!surge->isSleeping());
+    }
+
+    SECTION("Wakes for audio input")
+    {
+        for (int i = 0; i < blocksFor(SurgeSynthesizer::sleepHoldSeconds + 1); ++i)
+            surge->process();
+        REQUIRE(surge->isSleeping());
+
+        surge->process_input = true;
+        for (int k = 0; k < BLOCK_SIZE; ++k)
+        {
+            surge->input[0][k] = 0.5f * std::sin(k * 0.1f);
+            surge->input[1][k] = surge->input[0][k];
+        }
+
+        surge->process();
+        REQUIRE(!surge->isSleeping());
+    }
+
+    SECTION("Wakes for a queued FX change")
+    {
+        for (int i = 0; i < blocksFor(SurgeSynthesizer::sleepHoldSeconds + 1); ++i)
+            surge->process();
+        REQUIRE(surge->isSleeping());
+
+        auto *pt = &(surge->storage.getPatch().fx[fxslot_ains1].type);
+        auto awv = 1.f * fxt_delay / (pt->val_max.i - pt->val_min.i);
+        surge->setParameter01(surge->idForParameter(pt), awv, false);
+
+        surge->process();
+        REQUIRE(!surge->isSleeping());
+        REQUIRE(surge->fx[fxslot_ains1]);
+    }
+}
+
+TEST_CASE("Vocoders Share Their Modulator Analysis", "[fx]")
+{
+    for (int mode : {VocoderEffect::vim_mono, VocoderEffect::vim_right, VocoderEffect::vim_stereo})
+    {
+        DYNAMIC_SECTION("Modulator input mode " << mode)
+        {
+            // the same two vocoders, one after the other, with and without the cache
+            std::shared_ptr<SurgeSynthesizer> surge[2];
+
+            for (int i = 0; i < 2; ++i)
+            {
+                surge[i] = Surge::Headless::createSurge(48000);
+                REQUIRE(surge[i]);
+                surge[i]->storage.rngGen.g.seed(17);
+
+                for (auto slot : {fxslot_ains1, fxslot_ains2})
+                {
+                    auto *pt = &(surge[i]->storage.getPatch().fx[slot].type);
+                    auto awv = 1.f * fxt_vocoder / (pt->val_max.i - pt->val_min.i);
+                    surge[i]->setParameter01(surge[i]->idForParameter(pt), awv, false);
+                }
+
+                surge[i]->process();
+
+                for (auto slot : {fxslot_ains1, fxslot_ains2})
+                    surge[i]->storage.getPatch().fx[slot].p[VocoderEffect::voc_mod_input].val.i =
+                        mode;
+
+                surge[i]->process_input = true;
+                surge[i]->playNote(0, 48, 100, 0);
+            }
+
+            surge[1]->storage.vocoderAnalysis.reset();
+
+            float maxDiff = 0, peak = 0;
+            for (int b = 0; b < 500; ++b)
+            {
+                for (int i = 0; i < 2; ++i)
+                {
+                    for (int k = 0; k < BLOCK_SIZE; ++k)
+                    {
+                        auto t = (b * BLOCK_SIZE + k) / 48000.f;
+                        surge[i]->input[0][k] = 0.5f * std::sin(2.f * M_PI * 220.f * t);
+                        surge[i]->input[1][k] = 0.3f * std::sin(2.f * M_PI * 1250.f * t);
+                    }
+                    surge[i]->process();
+                }
+
+                for (int c = 0; c < 2; ++c)
+                {
+                    for (int k = 0; k < BLOCK_SIZE; ++k)
+                    {
+                        maxDiff = std::max(maxDiff, std::fabs(surge[0]->output[c][k] -
+                                                              surge[1]->output[c][k]));
+                        peak = std::max(peak, std::fabs(surge[0]->output[c][k]));
+                    }
+                }
+            }
+
+            REQUIRE(peak > 1e-3);
+            REQUIRE(maxDiff == 0.f);
+            REQUIRE(surge[0]->storage.vocoderAnalysis->shared > 400);
+        }
+    }
+}
+
+/*
+ * Reverb2 runs its four loop blocks side by side in SSE lanes and leans on the lane shuffles
+ * to feed each block from the one before it. This is the scalar loop it replaced, kept here
+ * as the reference; it shares the reverb's storage and parameters and the same output stage.
+ */
+struct ScalarReverb2 : public Effect
+{
+    static constexpr int NUM_BLOCKS = 4, MAX_LEN = 16384 * 8, DELAY_LEN_MASK = MAX_LEN - 1,
+                         DELAY_SUBSAMPLE_BITS = 8, DELAY_SUBSAMPLE_RANGE = 1 << 8,
+                         PREDELAY_BUFFER_SIZE = 48000 * 8 * 4,
+                         PREDELAY_BUFFER_SIZE_LIMIT = 48000 * 8 * 3;
+
+    struct line
+    {
+        std::vector<float> data = std::vector<float>(MAX_LEN, 0.f);
+        int len{1}, k{0};
+        void setLen(int l) { len = std::clamp(l, 0, MAX_LEN - 1); }
+
+        float allpass(float in, float coeff)
+        {
+            k++;
+            if (k >= len)
+                k = 0;
+            float delay_in = in - coeff * data[k];
+            float result = data[k] + coeff * delay_in;
+            data[k] = delay_in;
+            return result;
+        }
+
+        float delay(float in, int tap1, float &tap_out1, int tap2, float &tap_out2, int mod)
+        {
+            k = (k + 1) & DELAY_LEN_MASK;
+            tap_out1 = data[(k - tap1) & DELAY_LEN_MASK];
+            tap_out2 = data[(k - tap2) & DELAY_LEN_MASK];
+
+            int mod_int = mod >> DELAY_SUBSAMPLE_BITS;
+            int mod_frac1 = mod & (DELAY_SUBSAMPLE_RANGE - 1);
+            int mod_frac2 = DELAY_SUBSAMPLE_RANGE - mod_frac1;
+
+            float d1 = data[(k - len + mod_int + 1) & DELAY_LEN_MASK];
+            float d2 = data[(k - len + mod_int) & DELAY_LEN_MASK];
+            const float multiplier = 1.f / (float)(DELAY_SUBSAMPLE_RANGE);
+
+            float result = (d1 * (float)mod_frac1 + d2 * (float)mod_frac2) * multiplier;
+            data[k] = in;
+            return result;
+        }
+    };
+
+    line inputAllpass[4], loopAllpass[NUM_BLOCKS][2], loopDelay[NUM_BLOCKS];
+    float hfDamper[NUM_BLOCKS]{}, lfDamper[NUM_BLOCKS]{};
+    std::vector<float> predelay = std::vector<float>(PREDELAY_BUFFER_SIZE, 0.f);
+    int predelayK{0};
+    int tapTimeL[NUM_BLOCKS], tapTimeR[NUM_BLOCKS];
+    float state{0.f};
+
+    lipol<float, true> decayMultiply, diffusion, buildup, hfDamp, lfDamp, modulation;
+    sst::basic_blocks::dsp::SurgeQuadrOsc<float> lfo;
+    lipol_ps_blocksz mix alignas(16), width alignas(16);
+
+    ScalarReverb2(SurgeStorage *storage, FxStorage *fxdata, pdata *pd)
+        : Effect(storage, fxdata, pd)
+    {
+    }
+
+    int msToSamples(float ms, float scale)
+    {
+        float a = storage->samplerate * ms * 0.001f;
+        return (int)(a * scale);
+    }
+
+    void calcSize(float m)
+    {
+        const float tl[] = {80.3, 59.3, 97.7, 122.6}, tr[] = {35.5, 101.6, 73.9, 80.3};
+        const float ia[] = {4.76, 6.81, 10.13, 16.72};
+        const float la[NUM_BLOCKS][2] = {{38.2, 53.4}, {44.0, 41}, {48.3, 60.5}, {38.9, 42.2}};
+        const float ld[] = {178.8, 126.5, 106.1, 139.4};
+
+        for (int b = 0; b < NUM_BLOCKS; ++b)
+        {
+            tapTimeL[b] = msToSamples(tl[b], m);
+            tapTimeR[b] = msToSamples(tr[b], m);
+            inputAllpass[b].setLen(msToSamples(ia[b], m));
+            loopAllpass[b][0].setLen(msToSamples(la[b][0], m));
+            loopAllpass[b][1].setLen(msToSamples(la[b][1], m));
+            loopDelay[b].setLen(msToSamples(ld[b], m));
+        }
+    }
+
+    void process(float *dataL, float *dataR) override
+    {
+        using R2 = Reverb2Effect;
+        const float db60 = powf(10.f, 0.05f * -60.f);
+        const float tapGain[NUM_BLOCKS] = {1.5f / 4.f, 1.2f / 4.f, 1.0f / 4.f, 0.8f / 4.f};
+
+        float scale = powf(2.f, 1.f * *pd_float[R2::rev2_room_size]);
+        calcSize(scale);
+
+        float wetL alignas(16)[BLOCK_SIZE], wetR alignas(16)[BLOCK_SIZE];
+
+        float loop_time_s = 0.5508 * scale;
+        float decay =
+            powf(db60, loop_time_s / (4.f * (powf(2.f, *pd_float[R2::rev2_decay_time]))));
+
+        decayMultiply.newValue(decay);
+        diffusion.newValue(0.7f * *pd_float[R2::rev2_diffusion]);
+        buildup.newValue(0.7f * *pd_float[R2::rev2_buildup]);
+        hfDamp.newValue(0.8 * *pd_float[R2::rev2_hf_damping]);
+        lfDamp.newValue(0.2 * *pd_float[R2::rev2_lf_damping]);
+        modulation.newValue(*pd_float[R2::rev2_modulation] * storage->samplerate * 0.001f * 5.f);
+
+        width.set_target_smoothed(storage->db_to_linear(*pd_float[R2::rev2_width]));
+        mix.set_target_smoothed(*pd_float[R2::rev2_mix]);
+
+        lfo.set_rate(2.0 * M_PI * powf(2, -2.f) * storage->dsamplerate_inv);
+
+        int pdt = std::clamp((int)(storage->samplerate * pow(2.f, *pd_float[R2::rev2_predelay])),
+                             1, PREDELAY_BUFFER_SIZE_LIMIT - 1);
+
+        for (int k = 0; k < BLOCK_SIZE; k++)
+        {
+            float in = (dataL[k] + dataR[k]) * 0.5f;
+
+            predelayK++;
+            if (predelayK == PREDELAY_BUFFER_SIZE)
+                predelayK = 0;
+            auto p = predelayK - pdt;
+            while (p < 0)
+                p += PREDELAY_BUFFER_SIZE;
+            auto pdOut = predelay[p];
+            predelay[predelayK] = in;
+            in = pdOut;
+
+            for (auto &a : inputAllpass)
+                in = a.allpass(in, diffusion.v);
+
+            float x = state;
+            float outL = 0.f, outR = 0.f;
+            float lfos[NUM_BLOCKS] = {lfo.r, lfo.i, -lfo.r, -lfo.i};
+
+            auto hdc = std::clamp(hfDamp.v, 0.01f, 0.99f);
+            auto ldc = std::clamp(lfDamp.v, 0.01f, 0.99f);
+
+            for (int b = 0; b < NUM_BLOCKS; b++)
+            {
+                x = x + in;
+                for (auto &a : loopAllpass[b])
+                    x = a.allpass(x, buildup.v);
+
+                hfDamper[b] = hfDamper[b] * hdc + x * (1.f - hdc);
+                x = hfDamper[b];
+                lfDamper[b] = lfDamper[b] * (1.f - ldc) + x * ldc;
+                x = x - lfDamper[b];
+
+                int mod = (int)(modulation.v * lfos[b] * (float)DELAY_SUBSAMPLE_RANGE);
+                float tapOutL = 0.f, tapOutR = 0.f;
+                x = loopDelay[b].delay(x, tapTimeL[b], tapOutL, tapTimeR[b], tapOutR, mod);
+                outL += tapOutL * tapGain[b];
+                outR += tapOutR * tapGain[b];
+
+                x *= decayMultiply.v;
+            }
+
+            wetL[k] = outL;
+            wetR[k] = outR;
+            state = x;
+            decayMultiply.process();
+            diffusion.process();
+            buildup.process();
+            hfDamp.process();
+            lfo.process();
+            modulation.process();
+        }
+
+        applyWidth(wetL, wetR, width);
+        mix.fade_2_blocks_to(dataL, wetL, dataR, wetR, dataL, dataR, BLOCK_SIZE_QUAD);
+    }
+};
+
+TEST_CASE("Reverb2 Impulse Response Matches The Scalar Loop", "[fx]")
+{
+    for (auto sr : {44100, 48000, 96000})
+    {
+        DYNAMIC_SECTION("Impulse at " << sr)
+        {
+            auto surge = Surge::Headless::createSurge(sr);
+            REQUIRE(surge);
+
+            auto &fxs = surge->storage.getPatch().fx[fxslot_ains1];
+            auto awv = 1.f * fxt_reverb2 / (fxs.type.val_max.i - fxs.type.val_min.i);
+            surge->setParameter01(surge->idForParameter(&fxs.type), awv, false);
+
+            for (int i = 0; i < 4; ++i)
+                surge->process();
+
+            REQUIRE(fxs.type.val.i == fxt_reverb2);
+
+            // off the defaults so the dampers, modulation and width all do something
+            fxs.p[Reverb2Effect::rev2_room_size].val.f = 0.3f;
+            fxs.p[Reverb2Effect::rev2_decay_time].val.f = 1.5f;
+            fxs.p[Reverb2Effect::rev2_hf_damping].val.f = 0.4f;
+            fxs.p[Reverb2Effect::rev2_lf_damping].val.f = 0.3f;
+            fxs.p[Reverb2Effect::rev2_modulation].val.f = 0.8f;
+            fxs.p[Reverb2Effect::rev2_width].val.f = -3.f;
+            fxs.p[Reverb2Effect::rev2_mix].val.f = 0.75f;
+            surge->process();
+
+            auto *pd = surge->storage.getPatch().globaldata;
+            std::unique_ptr<Effect> simd(spawn_effect(fxt_reverb2, &surge->storage, &fxs, pd));
+            auto scalar = std::make_unique<ScalarReverb2>(&surge->storage, &fxs, pd);
+            REQUIRE(simd);
+            simd->init();
+
+            float L[2][BLOCK_SIZE], R[2][BLOCK_SIZE];
+            float maxDiff = 0, peak = 0, tail = 0;
+            auto blocks = 3 * sr / BLOCK_SIZE;
+
+            for (int b = 0; b < blocks; ++b)
+            {
+                for (int i = 0; i < 2; ++i)
+                {
+                    std::fill(L[i], L[i] + BLOCK_SIZE, 0.f);
+                    std::fill(R[i], R[i] + BLOCK_SIZE, 0.f);
+                    if (b == 0)
+                    {
+                        L[i][0] = 1.f;
+                        R[i][0] = 0.5f;
+                    }
+                }
+
+                simd->process(L[0], R[0]);
+                scalar->process(L[1], R[1]);
+
+                for (int k = 0; k < BLOCK_SIZE; ++k)
+                {
+                    maxDiff = std::max({maxDiff, std::fabs(L[0][k] - L[1][k]),
+                                        std::fabs(R[0][k] - R[1][k])});
+                    peak = std::max(peak, std::fabs(L[1][k]));
+                    if (b > blocks / 2)
+                        tail = std::max(tail, std::fabs(L[1][k]));
+                }
+            }
+
+            // make sure the impulse actually rang through the loop
+            REQUIRE(peak > 1e-2);
+            REQUIRE(tail > 1e-6);
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+            // each lane does the scalar arithmetic in the scalar order, so on x86 this is exact
+            REQUIRE(maxDiff == 0.f);
+#else
+            // elsewhere the compiler is free to fuse multiply-adds differently in the two loops
+            REQUIRE(maxDiff < 1e-5 * peak);
+#endif
+        }
+    }
+}
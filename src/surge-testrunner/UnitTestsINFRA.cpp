@@ -25,6 +25,9 @@
 #include "HeadlessUtils.h"
 #include "BiquadFilter.h"
 #include "MemoryPool.h"
+#include "RealtimeWorkerPool.h"
+
+#include <thread>
 
 #include "sst/plugininfra/strnatcmp.h"
 
@@ -162,6 +165,201 @@ TEST_CASE("Memory Pool Works", "[infra]")
         REQUIRE(CountAlloc<3>::alloc == 160);
         REQUIRE(CountAlloc<3>::ct == 0);
     }
+
+    SECTION("Resize Through The Staging Area")
+    {
+        {
+            auto pool = std::make_unique<Surge::Memory::MemoryPool<CountAlloc<4>, 32, 4, 500>>();
+            std::vector<CountAlloc<4> *> held;
+            for (int i = 0; i < 10; ++i)
+                held.push_back(pool->getItem());
+
+            // a request alone builds nothing, and exchange only moves what maintain built
+            pool->requestSize(100);
+            pool->exchange();
+            REQUIRE(CountAlloc<4>::ct == 32);
+
+            pool->maintain();
+            REQUIRE(CountAlloc<4>::ct == 100);
+            REQUIRE(pool->position == 22);
+            pool->exchange();
+            REQUIRE(pool->position == 90);
+
+            // shrinking only ever frees what isn't handed out, and never below the prealloc
+            for (int i = 0; i < 85; ++i)
+                held.push_back(pool->getItem());
+            pool->requestSize(5);
+            pool->exchange();
+            REQUIRE(pool->position == 0);
+            pool->maintain();
+            REQUIRE(CountAlloc<4>::ct == 95);
+
+            for (auto h : held)
+                pool->returnItem(h);
+            pool->maintain();
+            pool->exchange();
+            pool->maintain();
+            REQUIRE(CountAlloc<4>::ct == 32);
+            REQUIRE(pool->position == 32);
+        }
+        REQUIRE(CountAlloc<4>::ct == 0);
+    }
+}
+
+TEST_CASE("Realtime Worker Pool", "[infra]")
+{
+    SECTION("Synths Share One Pool")
+    {
+        auto a = Surge::Headless::createSurge(44100);
+        auto b = Surge::Headless::createSurge(44100);
+
+        // nobody starts a thread until parallel FX is turned on
+        REQUIRE(!a->fxWorkers);
+        REQUIRE(!a->processFXInParallel);
+
+        a->setProcessFXInParallel(true);
+        b->setProcessFXInParallel(true);
+        REQUIRE(a->fxWorkers);
+        REQUIRE(a->fxWorkers == b->fxWorkers);
+        REQUIRE(a->fxWorkers == RealtimeWorkerPool::shared(0));
+        REQUIRE(a->fxWorkers->workerCount() ==
+                std::min(SurgeSynthesizer::maxParallelFXChains - 1,
+                         RealtimeWorkerPool::defaultWorkerCount()));
+
+        // turning it back off keeps the pool, so the audio thread never sees it go away
+        a->setProcessFXInParallel(false);
+        REQUIRE(a->fxWorkers == b->fxWorkers);
+    }
+
+    SECTION("The Shared Pool Grows To The Greediest Caller")
+    {
+        auto small = RealtimeWorkerPool::shared(1);
+        REQUIRE(small->workerCount() == std::min(1, RealtimeWorkerPool::defaultWorkerCount()));
+
+        auto big = RealtimeWorkerPool::shared(1000);
+        REQUIRE(big == small);
+        REQUIRE(big->workerCount() == RealtimeWorkerPool::defaultWorkerCount());
+
+        int hits[8]{};
+        big->parallelFor(
+            8, [](void *c, int i) { static_cast<int *>(c)[i]++; }, hits);
+        for (auto h : hits)
+            REQUIRE(h == 1);
+    }
+
+    SECTION("Every Task Runs Once With Many Callers")
+    {
+        RealtimeWorkerPool pool(3);
+        std::atomic<int> misses{0};
+
+        auto caller = [&](int priority) {
+            for (int it = 0; it < 500; ++it)
+            {
+                int n = 1 + it % 7;
+                int hits[8]{};
+                pool.parallelFor(
+                    n, [](void *c, int i) { static_cast<int *>(c)[i]++; }, hits, priority);
+
+                for (int i = 0; i < n; ++i)
+                    if (hits[i] != 1)
+                        misses++;
+            }
+        };
+
+        std::vector<std::thread> callers;
+        for (int t = 0; t < 6; ++t)
+            callers.emplace_back(caller, t % 3);
+        for (auto &t : callers)
+            t.join();
+
+        REQUIRE(misses == 0);
+    }
+
+    SECTION("A Stalled Worker Sends The Pool Serial")
+    {
+        RealtimeWorkerPool pool(1);
+        struct Ctx
+        {
+            std::thread::id caller;
+            std::atomic<int> offCaller{0};
+        } ctx;
+        ctx.caller = std::this_thread::get_id();
+
+        // tasks a worker picks up overrun the stall limit, so the caller waits on them
+        auto task = [](void *c, int) {
+            auto ctx = static_cast<Ctx *>(c);
+            if (std::this_thread::get_id() != ctx->caller)
+            {
+                ctx->offCaller++;
+                std::this_thread::sleep_for(RealtimeWorkerPool::stallLimit * 4);
+            }
+        };
+
+        for (int it = 0; it < 1000 && pool.stalled() == 0; ++it)
+            pool.parallelFor(8, task, &ctx);
+        REQUIRE(pool.stalled() == 1);
+
+        ctx.offCaller = 0;
+        for (int it = 0; it < 100; ++it)
+            pool.parallelFor(8, task, &ctx);
+        REQUIRE(ctx.offCaller == 0);
+        REQUIRE(pool.stalled() == 1);
+    }
+}
+
+TEST_CASE("Storage Tables Are Shared", "[infra]")
+{
+    auto a = Surge::Headless::createSurge(44100);
+    auto b = Surge::Headless::createSurge(96000);
+
+    REQUIRE(a->storage.sinctable == b->storage.sinctable);
+    REQUIRE(a->storage.table_dB == b->storage.table_dB);
+    REQUIRE(a->storage.table_two_to_the == b->storage.table_two_to_the);
+
+    REQUIRE(a->storage.table_dB[384] == Approx(1.f));
+    REQUIRE(a->storage.table_dB[384 + 20] == Approx(10.f));
+    REQUIRE(a->storage.table_two_to_the[1000] == Approx(pow(2.0, 1.0 / 12.0)));
+    REQUIRE(a->storage.table_glide_log[0] == Approx(0.f).margin(1e-6));
+    REQUIRE(a->storage.table_glide_exp[511] == Approx(1.f));
+
+    // the per-samplerate tables are still each storage's own
+    REQUIRE(a->storage.table_envrate_linear[256] != b->storage.table_envrate_linear[256]);
+}
+
+TEST_CASE("Storage Core Is Shared", "[infra]")
+{
+    auto a = Surge::Headless::createSurge(44100, true);
+    auto b = Surge::Headless::createSurge(48000, true);
+
+    REQUIRE(&a->storage.WindowWT == &b->storage.WindowWT);
+    REQUIRE(a->storage.WindowWT.size > 0);
+
+    // the second storage copies the first's factory scans, so the lists must agree exactly
+    REQUIRE(a->storage.patch_list.size() == b->storage.patch_list.size());
+    REQUIRE(a->storage.patch_category.size() == b->storage.patch_category.size());
+    REQUIRE(a->storage.wt_list.size() == b->storage.wt_list.size());
+    REQUIRE(a->storage.firstThirdPartyCategory == b->storage.firstThirdPartyCategory);
+
+    for (auto i = 0U; i < a->storage.patch_list.size(); ++i)
+    {
+        INFO("Patch " << i << " " << a->storage.patch_list[i].name);
+        REQUIRE(a->storage.patch_list[i].path == b->storage.patch_list[i].path);
+        REQUIRE(a->storage.patch_list[i].category == b->storage.patch_list[i].category);
+        REQUIRE(a->storage.patch_list[i].lastModTime != 0);
+    }
+
+    for (auto i = 0U; i < a->storage.wt_list.size(); ++i)
+    {
+        REQUIRE(a->storage.wt_list[i].path == b->storage.wt_list[i].path);
+        REQUIRE(a->storage.wt_list[i].category == b->storage.wt_list[i].category);
+    }
+
+    // and each instance's lists are still its own to change
+    if (!a->storage.patch_list.empty())
+    {
+        a->storage.patch_list[0].isFavorite = !b->storage.patch_list[0].isFavorite;
+        REQUIRE(a->storage.patch_list[0].isFavorite != b->storage.patch_list[0].isFavorite);
+    }
 }
 
 TEST_CASE("strnatcmp with spaces", "[infra]")
@@ -22,6 +22,7 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <fstream>
 #include <algorithm>
 
 #include "HeadlessUtils.h"
@@ -34,6 +35,9 @@
 #include <thread>
 
 #include "UserDefaults.h"
+#include "FactoryDataBundle.h"
+#include "BinaryDelta.h"
+#include "MSEGModulationHelper.h"
 #include <unordered_map>
 
 using namespace Surge::Test;
@@ -95,6 +99,101 @@ TEST_CASE("All .wt and .wav factory assets load", "[io]")
     }
 }
 
+TEST_CASE("Factory Data Bundle", "[io]")
+{
+    auto surge = Surge::Headless::createSurge(44100, true);
+    REQUIRE(surge.get());
+    auto &storage = surge->storage;
+
+    auto bundlePath = fs::temp_directory_path() / "surge-unittest-factory-data.sfdb";
+    std::ostringstream log;
+    REQUIRE(Surge::Storage::FactoryDataBundle::write(
+        storage.datapath, {"wavetables", "patches_factory"}, bundlePath, log));
+
+    auto bundle = Surge::Storage::FactoryDataBundle::open(bundlePath);
+    REQUIRE(bundle);
+    REQUIRE(bundle->size() > 0);
+    REQUIRE(Surge::Storage::FactoryDataBundle::open(bundlePath) == bundle);
+
+    SECTION("Wavetables Match The Files")
+    {
+        auto osc = &storage.getPatch().scene[0].osc[0];
+        auto wt = &osc->wt;
+        int compared = 0;
+
+        for (auto &p : storage.wt_list)
+        {
+            const char *d;
+            size_t sz;
+            auto rel = p.path.lexically_relative(storage.datapath).generic_string();
+
+            if (!bundle->find(rel, d, sz) || compared >= 20)
+                continue;
+
+            storage.factoryDataBundle = nullptr;
+            storage.load_wt(path_to_string(p.path), wt, osc);
+            std::vector<float> fromFile(wt->TableF32WeakPointers[0][0],
+                                        wt->TableF32WeakPointers[0][0] + wt->size);
+            auto n = wt->n_tables;
+
+            storage.factoryDataBundle = bundle;
+            storage.load_wt(path_to_string(p.path), wt, osc);
+            INFO("Comparing " << rel);
+            REQUIRE(wt->n_tables == n);
+            REQUIRE(wt->size == (int)fromFile.size());
+
+            for (int i = 0; i < wt->size; ++i)
+                REQUIRE(wt->TableF32WeakPointers[0][0][i] == fromFile[i]);
+
+            compared++;
+        }
+
+        REQUIRE(compared > 0);
+    }
+
+    SECTION("Patches Load From The Bundle")
+    {
+        storage.factoryDataBundle = bundle;
+        int loaded = 0;
+
+        for (int i = 0; i < (int)storage.patch_list.size() && loaded < 10; ++i)
+        {
+            const char *d;
+            size_t sz;
+            if (!storage.findInFactoryDataBundle(storage.patch_list[i].path, d, sz))
+                continue;
+
+            surge->loadPatch(i);
+            REQUIRE(storage.getPatch().name == storage.patch_list[i].name);
+            loaded++;
+        }
+
+        REQUIRE(loaded > 0);
+    }
+
+    SECTION("Bundles From Another Build Are Ignored")
+    {
+        REQUIRE(!Surge::Storage::FactoryDataBundle::stamp().empty());
+
+        auto stalePath = fs::temp_directory_path() / "surge-unittest-stale-factory-data.sfdb";
+        fs::copy_file(bundlePath, stalePath, fs::copy_options::overwrite_existing);
+
+        {
+            // scribble on the first byte of the version stamp, just after the header
+            std::fstream f(stalePath, std::ios::binary | std::ios::in | std::ios::out);
+            f.seekp(16);
+            f.put('?');
+        }
+
+        REQUIRE(!Surge::Storage::FactoryDataBundle::open(stalePath));
+        fs::remove(stalePath);
+    }
+
+    storage.factoryDataBundle = nullptr;
+    bundle = nullptr;
+    fs::remove(bundlePath);
+}
+
 TEST_CASE("All Patches are Loadable", "[io]")
 {
     auto surge = Surge::Headless::createSurge(44100, true);
@@ -722,3 +821,280 @@ TEST_CASE("MonoVoicePriority Streams", "[io]")
         }
     }
 }
+
+TEST_CASE("Queued Loads and Parameter Changes", "[io]")
+{
+    SECTION("Spent Patch Loads Are Freed Off The Audio Thread")
+    {
+        auto src = Surge::Headless::createSurge(44100);
+        auto dest = Surge::Headless::createSurge(44100);
+        src->storage.getPatch().scene[0].monoVoicePriorityMode = ALWAYS_HIGHEST;
+
+        void *d = nullptr;
+        auto sz = src->saveRaw(&d);
+
+        dest->enqueuePatchForLoad(d, sz);
+        REQUIRE(dest->enqueuedLoad.load());
+        dest->process();
+        REQUIRE(!dest->enqueuedLoad.load());
+        REQUIRE(dest->storage.getPatch().scene[0].monoVoicePriorityMode == ALWAYS_HIGHEST);
+
+        // the audio thread handed the buffer back rather than freeing it
+        REQUIRE(dest->spentLoads.load());
+        dest->runHousekeeping();
+        REQUIRE(!dest->spentLoads.load());
+
+        // and the next enqueue frees any it finds on its way in
+        dest->enqueuePatchForLoad(d, sz);
+        dest->process();
+        REQUIRE(dest->spentLoads.load());
+        dest->enqueuePatchForLoad(d, sz);
+        REQUIRE(!dest->spentLoads.load());
+    }
+
+    SECTION("Queued Parameter Changes Land At The Next Block")
+    {
+        auto surge = Surge::Headless::createSurge(44100);
+        auto id = surge->idForParameter(&(surge->storage.getPatch().volume));
+        auto before = surge->getParameter01(id);
+
+        REQUIRE(surge->enqueueParameterChange(id, 0.25f));
+        REQUIRE(surge->getParameter01(id) == before);
+        surge->process();
+        REQUIRE(surge->getParameter01(id) == Approx(0.25f));
+
+        // a full queue drops changes rather than growing
+        for (auto i = 0U; i < SurgeSynthesizer::parameterQueueSize; ++i)
+            REQUIRE(surge->enqueueParameterChange(id, 0.5f));
+        REQUIRE(!surge->enqueueParameterChange(id, 0.75f));
+        surge->process();
+        REQUIRE(surge->getParameter01(id) == Approx(0.5f));
+        REQUIRE(surge->enqueueParameterChange(id, 0.75f));
+    }
+}
+
+TEST_CASE("Binary DAW State", "[io]")
+{
+    auto toXML = [](std::shared_ptr<SurgeSynthesizer> s) {
+        void *d = nullptr;
+        auto sz = s->storage.getPatch().save_xml(&d);
+        auto res = std::string((char *)d, sz);
+        free(d);
+        return res;
+    };
+
+    // the patch owns the chunk saveRaw hands back, so keep a copy
+    auto saveState = [](std::shared_ptr<SurgeSynthesizer> s, bool binary) {
+        void *d = nullptr;
+        auto sz = s->saveRaw(&d, binary);
+        return std::vector<char>((char *)d, (char *)d + sz);
+    };
+
+    SECTION("Factory Patches Round Trip Exactly")
+    {
+        auto surgeS = Surge::Headless::createSurge(44100, true);
+        auto surgeD = Surge::Headless::createSurge(44100, true);
+        int n = surgeS->storage.patch_list.size();
+        REQUIRE(n > 0);
+
+        size_t xmlBytes = 0, binaryBytes = 0;
+
+        for (int i = 0; i < n; i += 7)
+        {
+            INFO("Round tripping " << surgeS->storage.patch_list[i].name);
+            surgeS->loadPatch(i);
+
+            auto xmlState = saveState(surgeS, false);
+            auto binState = saveState(surgeS, true);
+            REQUIRE(memcmp(binState.data(), "sub4", 4) == 0);
+
+            surgeD->loadRaw(binState.data(), binState.size(), false);
+            REQUIRE(toXML(surgeD) == toXML(surgeS));
+
+            xmlBytes += xmlState.size();
+            binaryBytes += binState.size();
+        }
+
+        REQUIRE(binaryBytes < xmlBytes);
+    }
+
+    SECTION("Routings, MSEGs, Formulae and Wavetables Restore")
+    {
+        auto surgeS = Surge::Headless::createSurge(44100, true);
+        auto surgeD = Surge::Headless::createSurge(44100, true);
+        auto &patchS = surgeS->storage.getPatch();
+
+        patchS.scene[0].osc[1].type.val.i = ot_wavetable;
+        surgeS->storage.load_wt(3, &patchS.scene[0].osc[1].wt, &patchS.scene[0].osc[1]);
+
+        patchS.scene[0].lfo[0].shape.val.i = lt_mseg;
+        patchS.msegs[0][0].segments[1].v0 = 0.375f;
+        patchS.msegs[0][0].loopMode = MSEGStorage::LoopMode::GATED_LOOP;
+        Surge::MSEG::rebuildCache(&patchS.msegs[0][0]);
+
+        patchS.scene[1].lfo[2].shape.val.i = lt_formula;
+        patchS.formulamods[1][2].setFormula("-- binary state\nreturn 0.25");
+
+        auto cutoff = patchS.scene[0].filterunit[0].cutoff.id;
+        surgeS->setModDepth01(cutoff, ms_lfo1, 0, 0, 0.3125f);
+        surgeS->setModDepth01(patchS.volume.id, ms_slfo1, 1, 0, -0.5f);
+        patchS.scene[0].filterunit[0].cutoff.deactivated = false;
+        patchS.scene[0].lfo[0].rate.temposync = true;
+
+        auto binState = saveState(surgeS, true);
+        surgeD->loadRaw(binState.data(), binState.size(), false);
+        auto &patchD = surgeD->storage.getPatch();
+
+        REQUIRE(surgeD->getModDepth01(cutoff, ms_lfo1, 0, 0) == 0.3125f);
+        REQUIRE(surgeD->getModDepth01(patchD.volume.id, ms_slfo1, 1, 0) == -0.5f);
+        REQUIRE(patchD.scene[0].lfo[0].rate.temposync);
+
+        REQUIRE(patchD.msegs[0][0].n_activeSegments == patchS.msegs[0][0].n_activeSegments);
+        REQUIRE(patchD.msegs[0][0].segments[1].v0 == 0.375f);
+        REQUIRE(patchD.msegs[0][0].loopMode == MSEGStorage::LoopMode::GATED_LOOP);
+
+        REQUIRE(patchD.formulamods[1][2].formulaString == "-- binary state\nreturn 0.25");
+
+        auto &wtS = patchS.scene[0].osc[1].wt, &wtD = patchD.scene[0].osc[1].wt;
+        REQUIRE(wtD.n_tables == wtS.n_tables);
+        REQUIRE(wtD.size == wtS.size);
+        for (int j = 0; j < wtS.n_tables; ++j)
+            REQUIRE(memcmp(wtD.TableI16WeakPointers[0][j], wtS.TableI16WeakPointers[0][j],
+                           wtS.size * sizeof(short)) == 0);
+        REQUIRE(std::string(patchD.scene[0].osc[1].wavetable_display_name) ==
+                std::string(patchS.scene[0].osc[1].wavetable_display_name));
+    }
+
+    SECTION("A Truncated Chunk Doesn't Crash")
+    {
+        auto surgeS = Surge::Headless::createSurge(44100);
+        auto surgeD = Surge::Headless::createSurge(44100);
+
+        auto binState = saveState(surgeS, true);
+
+        for (auto sz : {8, 20, 200, (int)binState.size() / 2})
+        {
+            auto cut = std::vector<char>(binState.begin(), binState.begin() + sz);
+            surgeD->loadRaw(cut.data(), cut.size(), false);
+        }
+    }
+
+    SECTION("A Corrupt Wavetable Is Skipped")
+    {
+        auto surgeS = Surge::Headless::createSurge(44100, true);
+        auto &patchS = surgeS->storage.getPatch();
+        patchS.scene[0].osc[1].type.val.i = ot_wavetable;
+        surgeS->storage.load_wt(3, &patchS.scene[0].osc[1].wt, &patchS.scene[0].osc[1]);
+        auto &wtS = patchS.scene[0].osc[1].wt;
+
+        auto binState = saveState(surgeS, true);
+
+        auto u32At = [&binState](size_t at) {
+            uint32_t v;
+            memcpy(&v, binState.data() + at, sizeof(v));
+            return v;
+        };
+
+        // walk the sections to the header of the one wavetable in "wavt"
+        size_t pos = 16, header = 0;
+        for (uint32_t s = 0; s < u32At(12); ++s)
+        {
+            if (memcmp(binState.data() + pos, "wavt", 4) == 0)
+            {
+                REQUIRE(u32At(pos + 8) == 1);
+                header = pos + 8 + 4 + 2 + 4;
+                break;
+            }
+            pos += 8 + u32At(pos + 4);
+        }
+        REQUIRE(header > 0);
+        REQUIRE(u32At(header + 4) == wtS.size);
+
+        auto loadTampered = [&](size_t at, const void *v, size_t n) {
+            auto tampered = binState;
+            memcpy(tampered.data() + at, v, n);
+
+            auto surgeD = Surge::Headless::createSurge(44100, true);
+            auto &patchD = surgeD->storage.getPatch();
+            surgeD->storage.load_wt(3, &patchD.scene[0].osc[1].wt, &patchD.scene[0].osc[1]);
+            surgeD->loadRaw(tampered.data(), tampered.size(), false);
+
+            for (int i = 0; i < 10; ++i)
+                surgeD->process();
+
+            // the wavetable we had is left alone
+            auto &wtD = patchD.scene[0].osc[1].wt;
+            REQUIRE(wtD.size == wtS.size);
+            REQUIRE(wtD.n_tables == wtS.n_tables);
+        };
+
+        SECTION("Samples Way Past The Section")
+        {
+            uint32_t nSamples = 1 << 30;
+            loadTampered(header + 4, &nSamples, sizeof(nSamples));
+        }
+
+        SECTION("One Table More Than The Section Holds")
+        {
+            uint16_t nTables;
+            memcpy(&nTables, binState.data() + header + 8, sizeof(nTables));
+            nTables++;
+            loadTampered(header + 8, &nTables, sizeof(nTables));
+        }
+    }
+}
+
+TEST_CASE("Binary Delta", "[io]")
+{
+    using namespace Surge::Storage;
+
+    auto chunk = [](std::shared_ptr<SurgeSynthesizer> s) {
+        void *d = nullptr;
+        auto sz = s->saveRaw(&d, true);
+        return std::vector<char>((char *)d, (char *)d + sz);
+    };
+
+    auto surge = Surge::Headless::createSurge(44100, true);
+    REQUIRE(surge->storage.patch_list.size() > 10);
+
+    SECTION("An Edit Costs About Its Size")
+    {
+        for (int i = 0; i < 10; ++i)
+        {
+            surge->loadPatch(i);
+            auto before = chunk(surge);
+
+            auto &patch = surge->storage.getPatch();
+            patch.scene[0].filterunit[0].cutoff.val.f += 3.f;
+            patch.scene[1].lfo[2].shape.val.i = lt_formula;
+            patch.formulamods[1][2].setFormula("-- a longer formula than was here\nreturn 0");
+            auto after = chunk(surge);
+
+            auto delta = BinaryDelta::diff(before.data(), before.size(), after.data(),
+                                           after.size());
+            INFO("Patch " << i << " chunk " << after.size() << " delta " << delta.size());
+            REQUIRE(delta.size() < 256);
+
+            std::vector<char> res;
+            REQUIRE(BinaryDelta::apply(before.data(), before.size(), delta, res));
+            REQUIRE(res == after);
+        }
+    }
+
+    SECTION("Unrelated Patches Still Round Trip")
+    {
+        surge->loadPatch(3);
+        auto a = chunk(surge);
+        surge->loadPatch(8);
+        auto b = chunk(surge);
+
+        auto delta = BinaryDelta::diff(a.data(), a.size(), b.data(), b.size());
+        std::vector<char> res;
+        REQUIRE(BinaryDelta::apply(a.data(), a.size(), delta, res));
+        REQUIRE(res == b);
+
+        delta.pop_back();
+        REQUIRE(!BinaryDelta::apply(a.data(), a.size(), delta, res));
+        REQUIRE(res.empty());
+    }
+}
@@ -1676,4 +1676,67 @@ TEST_CASE("Mono Modes Across Channels", "[midi]")
             }
         }
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Note Starts Are Sample Accurate Within A Block", "[midi]")
+{
+    static constexpr int blocks = 16;
+
+    // the same note started at the given offset, with nothing random left to tell runs apart
+    auto render = [](int offset) {
+        auto surge = Surge::Headless::createSurge(44100);
+        REQUIRE(surge);
+
+        auto &scene = surge->storage.getPatch().scene[0];
+        for (auto &o : scene.osc)
+            o.retrigger.val.b = true;
+        scene.drift.val.f = 0.f;
+        scene.adsr[0].a.val.f = scene.adsr[0].a.val_min.f;
+        scene.adsr[0].s.val.f = 1.f;
+
+        for (int i = 0; i < 10; ++i)
+            surge->process();
+
+        surge->storage.rngGen.g.seed(17);
+        surge->setEventSampleOffset(offset);
+        surge->playNote(0, 60, 127, 0);
+        surge->setEventSampleOffset(0);
+
+        std::vector<float> res;
+        for (int b = 0; b < blocks; ++b)
+        {
+            surge->process();
+            res.insert(res.end(), surge->output[0], surge->output[0] + BLOCK_SIZE);
+        }
+        return res;
+    };
+
+    auto reference = render(0);
+
+    for (auto offset : {1, BLOCK_SIZE / 2 + 1, BLOCK_SIZE - 1})
+    {
+        DYNAMIC_SECTION("Note Starting At Sample " << offset)
+        {
+            auto late = render(offset);
+
+            for (int i = 0; i < offset; ++i)
+                REQUIRE(late[i] == 0.f);
+
+            // the note is delayed rather than cut: its first samples are there after the offset
+            float transient{0.f};
+            for (int i = offset; i < offset + 8; ++i)
+                transient += std::fabs(late[i]);
+            REQUIRE(transient > 0.f);
+
+            // and once the ramps have settled the voice is the same note, offset samples late
+            float peak{0.f}, worst{0.f};
+            for (int i = 4 * BLOCK_SIZE; i < blocks * BLOCK_SIZE; ++i)
+            {
+                peak = std::max(peak, std::fabs(reference[i - offset]));
+                worst = std::max(worst, std::fabs(late[i] - reference[i - offset]));
+            }
+            REQUIRE(peak > 0.f);
+            REQUIRE(worst < 1e-4f * peak + 1e-6f);
+        }
+    }
+}
@@ -1430,4 +1430,201 @@ TEST_CASE("ModLFO is well behaved", "[mod]")
             }
         }
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Grouped Voice LFOs Draw The Same Random Values", "[mod]")
+{
+    auto makeSurge = [](bool grouped) {
+        auto surge = Surge::Headless::createSurge(44100);
+        REQUIRE(surge);
+
+        surge->groupVoiceLFOs = grouped;
+        surge->storage.rngGen.g.seed(23);
+
+        auto &scene = surge->storage.getPatch().scene[0];
+        scene.lfo[0].shape.val.i = lt_snh;
+        scene.lfo[1].shape.val.i = lt_noise;
+        scene.lfo[2].shape.val.i = lt_formula;
+        scene.lfo[3].shape.val.i = lt_formula;
+        scene.lfo[4].shape.val.i = lt_sine;
+
+        // two formulas drawing from the one math.random, so their order across voices shows
+        for (int f : {2, 3})
+        {
+            surge->storage.getPatch().formulamods[0][f].setFormula(R"FN(
+function process(modstate)
+    modstate["output"] = math.random() * 2 - 1
+    return modstate
+end)FN");
+        }
+
+        auto cutoff = scene.filterunit[0].cutoff.id;
+        for (int i = 0; i < 5; ++i)
+            surge->setModDepth01(cutoff, (modsources)(ms_lfo1 + i), 0, 0, 0.1);
+
+        return surge;
+    };
+
+    auto grouped = makeSurge(true);
+    auto perVoice = makeSurge(false);
+
+    for (auto s : {grouped, perVoice})
+    {
+        for (int i = 0; i < 10; ++i)
+            s->process();
+        s->playNote(0, 48, 100, 0);
+        s->playNote(0, 55, 100, 0);
+        s->playNote(0, 60, 100, 0);
+    }
+
+    for (int blk = 0; blk < 200; ++blk)
+    {
+        grouped->process();
+        perVoice->process();
+
+        REQUIRE(grouped->voices[0].size() == 3);
+        REQUIRE(perVoice->voices[0].size() == 3);
+
+        auto gv = grouped->voices[0].begin();
+        auto pv = perVoice->voices[0].begin();
+        for (; gv != grouped->voices[0].end(); ++gv, ++pv)
+        {
+            for (int i = 0; i < 5; ++i)
+            {
+                INFO("Block " << blk << " LFO " << i);
+                REQUIRE((*gv)->modsources[ms_lfo1 + i]->get_output(0) ==
+                        (*pv)->modsources[ms_lfo1 + i]->get_output(0));
+            }
+        }
+    }
+}
+
+TEST_CASE("Modulation Routing Snapshots", "[mod]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto &patch = surge->storage.getPatch();
+    auto pitch = patch.scene[0].osc[0].pitch.id;
+    auto cutoff = patch.scene[0].filterunit[0].cutoff.id;
+    auto volume = patch.volume.id;
+
+    // start from a clean slate regardless of what the default patch routes
+    surge->storage.modRoutingMutex.lock();
+    patch.modulation_global.clear();
+    for (int s = 0; s < n_scenes; ++s)
+    {
+        patch.scene[s].modulation_scene.clear();
+        patch.scene[s].modulation_voice.clear();
+    }
+    surge->storage.publishModRouting();
+    surge->storage.modRoutingMutex.unlock();
+
+    auto sameAsPatch = [&](const SurgeStorage::ModRoutingSnapshot *r) {
+        auto eq = [](const std::vector<ModulationRouting> &a,
+                     const std::vector<ModulationRouting> &b) {
+            if (a.size() != b.size())
+                return false;
+            for (auto i = 0U; i < a.size(); ++i)
+            {
+                if (a[i].source_id != b[i].source_id ||
+                    a[i].destination_id != b[i].destination_id || a[i].depth != b[i].depth ||
+                    a[i].muted != b[i].muted || a[i].source_index != b[i].source_index ||
+                    a[i].source_scene != b[i].source_scene)
+                    return false;
+            }
+            return true;
+        };
+        bool res = eq(r->global, patch.modulation_global);
+        for (int s = 0; s < n_scenes; ++s)
+        {
+            res = res && eq(r->scene[s], patch.scene[s].modulation_scene);
+            res = res && eq(r->voice[s], patch.scene[s].modulation_voice);
+        }
+        return res;
+    };
+
+    SECTION("Edits Are Published")
+    {
+        surge->setModDepth01(pitch, ms_lfo1, 0, 0, 0.3);
+        surge->setModDepth01(cutoff, ms_slfo1, 0, 0, 0.4);
+        surge->setModDepth01(volume, ms_ctrl1, 0, 0, 0.5);
+        REQUIRE(sameAsPatch(surge->storage.acquireModRouting()));
+        REQUIRE(surge->storage.currentModRouting()->voice[0].size() == 1);
+        REQUIRE(surge->storage.currentModRouting()->scene[0].size() == 1);
+        REQUIRE(surge->storage.currentModRouting()->global.size() == 1);
+
+        surge->muteModulation(cutoff, ms_slfo1, 0, 0, true);
+        REQUIRE(sameAsPatch(surge->storage.acquireModRouting()));
+        REQUIRE(surge->storage.currentModRouting()->scene[0][0].muted);
+
+        surge->clearModulation(pitch, ms_lfo1, 0, 0);
+        REQUIRE(sameAsPatch(surge->storage.acquireModRouting()));
+        REQUIRE(surge->storage.currentModRouting()->voice[0].empty());
+    }
+
+    SECTION("Pinned Snapshot Survives Publishes")
+    {
+        surge->setModDepth01(pitch, ms_lfo1, 0, 0, 0.3);
+        auto *pinned = surge->storage.acquireModRouting();
+        REQUIRE(pinned->voice[0].size() == 1);
+
+        for (int i = 0; i < 20; ++i)
+        {
+            surge->setModDepth01(cutoff, ms_lfo2, 0, 0, 0.01 * (i + 1));
+        }
+
+        // still the old contents; the audio thread hasn't moved on yet
+        REQUIRE(surge->storage.currentModRouting() == pinned);
+        REQUIRE(pinned->voice[0].size() == 1);
+        REQUIRE(pinned->voice[0][0].source_id == ms_lfo1);
+
+        auto *next = surge->storage.acquireModRouting();
+        REQUIRE(next != pinned);
+        REQUIRE(sameAsPatch(next));
+        REQUIRE(next->voice[0].size() == 2);
+    }
+
+    SECTION("Audio Thread Picks Up Edits")
+    {
+        surge->setModDepth01(volume, ms_ctrl1, 0, 0, 0.5);
+        for (int i = 0; i < 4; ++i)
+            surge->process();
+        REQUIRE(sameAsPatch(surge->storage.currentModRouting()));
+
+        surge->clearModulation(volume, ms_ctrl1, 0, 0);
+        surge->process();
+        REQUIRE(sameAsPatch(surge->storage.currentModRouting()));
+        REQUIRE(surge->storage.currentModRouting()->global.empty());
+    }
+
+    SECTION("Changing An FX Clears Its Routings In One Publish")
+    {
+        auto &fxs = patch.fx[fxslot_send1];
+        auto setType = [&](int type) {
+            auto awv = 1.f * type / (fxs.type.val_max.i - fxs.type.val_min.i);
+            surge->setParameter01(surge->idForParameter(&fxs.type), awv, false);
+            for (int i = 0; i < 4; ++i)
+                surge->process();
+        };
+
+        setType(fxt_delay);
+        surge->setModDepth01(fxs.p[0].id, ms_slfo1, 0, 0, 0.2);
+        surge->setModDepth01(fxs.p[1].id, ms_slfo2, 1, 0, 0.3);
+        surge->setModDepth01(fxs.p[2].id, ms_ctrl1, 0, 0, 0.4);
+        surge->setModDepth01(volume, ms_ctrl2, 0, 0, 0.5);
+        surge->process();
+        surge->runHousekeeping();
+        REQUIRE(surge->storage.retiredModRoutingCount() == 0);
+
+        // the load runs on this thread, the one pinning snapshots, so it only retires them
+        setType(fxt_reverb);
+        REQUIRE(patch.modulation_global.size() == 1);
+        REQUIRE(patch.modulation_global[0].destination_id == volume);
+        REQUIRE(sameAsPatch(surge->storage.currentModRouting()));
+        REQUIRE(surge->storage.retiredModRoutingCount() == 1);
+
+        surge->runHousekeeping();
+        REQUIRE(surge->storage.retiredModRoutingCount() == 0);
+    }
+}
@@ -23,6 +23,7 @@
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
+#include <random>
 
 #include "HeadlessUtils.h"
 #include "catch2/catch2.hpp"
@@ -540,6 +541,105 @@ TEST_CASE("Zero size loops", "[mseg]")
     }
 }
 
+TEST_CASE("Cached Segment Lookup Matches Scan", "[mseg]")
+{
+    /*
+     * rebuildCache builds a time to segment table and solves the per-segment shape values
+     * up front. Setting cachedSegments to -1 makes the evaluator ignore those tables, so we
+     * can check the accelerated path against the original scan across a bunch of random
+     * shapes, with several evaluators (as voices would) sharing the same storage.
+     */
+    std::mt19937 rng(2112);
+    std::uniform_real_distribution<float> bip(-1, 1), uni(0, 1);
+    MSEGStorage::segment::Type types[] = {
+        MSEGStorage::segment::LINEAR,   MSEGStorage::segment::QUAD_BEZIER,
+        MSEGStorage::segment::SCURVE,   MSEGStorage::segment::SINE,
+        MSEGStorage::segment::STAIRS,   MSEGStorage::segment::BROWNIAN,
+        MSEGStorage::segment::SQUARE,   MSEGStorage::segment::TRIANGLE,
+        MSEGStorage::segment::HOLD,     MSEGStorage::segment::SAWTOOTH,
+        MSEGStorage::segment::BUMP,     MSEGStorage::segment::SMOOTH_STAIRS};
+    constexpr int nTypes = sizeof(types) / sizeof(types[0]);
+    constexpr int nVoices = 8;
+
+    for (int trial = 0; trial < 60; ++trial)
+    {
+        INFO("Trial " << trial);
+
+        MSEGStorage ms;
+        ms.n_activeSegments = 1 + rng() % 48;
+        ms.loopMode = (MSEGStorage::LoopMode)(1 + trial % 3);
+
+        for (int i = 0; i < ms.n_activeSegments; ++i)
+        {
+            auto &seg = ms.segments[i];
+            seg.type = types[rng() % nTypes];
+            seg.duration = (rng() % 6 == 0) ? 0.f : uni(rng);
+            seg.v0 = bip(rng);
+            seg.cpv = bip(rng);
+            seg.cpduration = uni(rng);
+        }
+
+        if (trial % 4 == 1)
+        {
+            ms.loop_start = rng() % ms.n_activeSegments;
+            ms.loop_end = rng() % ms.n_activeSegments;
+        }
+
+        Surge::MSEG::rebuildCache(&ms);
+        REQUIRE(ms.cachedSegments == ms.n_activeSegments);
+
+        auto scan = ms;
+        scan.cachedSegments = -1;
+
+        Surge::MSEG::EvaluatorState esCached[nVoices], esScan[nVoices];
+        float df[nVoices];
+        double phase[nVoices], dPhase[nVoices];
+
+        for (int v = 0; v < nVoices; ++v)
+        {
+            esCached[v].seed(trial * nVoices + v);
+            esScan[v].seed(trial * nVoices + v);
+            df[v] = bip(rng);
+            phase[v] = uni(rng);
+            dPhase[v] = 0.002 + uni(rng) * 0.03;
+        }
+
+        for (int step = 0; step < 2000; ++step)
+        {
+            for (int v = 0; v < nVoices; ++v)
+            {
+                if (step == 1500)
+                {
+                    esCached[v].released = true;
+                    esScan[v].released = true;
+                }
+
+                int ip = (int)phase[v];
+                float fp = phase[v] - ip;
+
+                auto a = Surge::MSEG::valueAt(ip, fp, df[v], &ms, &esCached[v]);
+                auto b = Surge::MSEG::valueAt(ip, fp, df[v], &scan, &esScan[v]);
+                REQUIRE(a == b);
+
+                for (auto ignoreLoops : {true, false})
+                {
+                    float ta = 0, tb = 0;
+                    auto sa = Surge::MSEG::timeToSegment(&ms, phase[v], ignoreLoops, ta);
+                    auto sb = Surge::MSEG::timeToSegment(&scan, phase[v], ignoreLoops, tb);
+                    REQUIRE(sa == sb);
+
+                    if (sa >= 0)
+                    {
+                        REQUIRE(ta == tb);
+                    }
+                }
+
+                phase[v] += dPhase[v];
+            }
+        }
+    }
+}
+
 /*
  * Tests to add
  * - loop point 0 (start = end + 1)
@@ -68,9 +68,13 @@ int main(int argc, char **argv)
             Surge::Headless::NonTest::filterAnalyzer(std::atoi(argv[3]), std::atoi(argv[4]),
                                                      std::cout);
         }
-        if (strcmp(argv[2], "--performance") == 0)
+        if (strcmp(argv[2], "--process-block-copy-benchmark") == 0)
         {
-            Surge::Headless::NonTest::performancePlay(argv[3], std::atoi(argv[4]));
+            Surge::Headless::NonTest::processBlockCopyBenchmark();
+        }
+        if (strcmp(argv[2], "--startup-benchmark") == 0)
+        {
+            Surge::Headless::NonTest::startupBenchmark();
         }
         return 0;
     }
@@ -86,6 +90,8 @@ int main(int argc, char **argv)
                 << "   --non-test --stats-from-every-patch    # play every patch and show RMS\n"
                 << "   --non-test --filter-analyzer ft fst    # analyze filter type/subtype for "
                    "response\n"
+                << "   --non-test --process-block-copy-benchmark # time host copy strategies\n"
+                << "   --non-test --startup-benchmark         # time to first block per instance\n"
                 << "\n"
                 << "If you exclude the `--non-test` argument, standard catch2 arguments, below, "
                    "apply\n\n";
@@ -233,7 +233,7 @@ SurgeSynthEditor::SurgeSynthEditor(SurgeSynthProcessor &p)
     sge->open(nullptr);
 
     idleTimer = std::make_unique<IdleTimer>(this);
-    idleTimer->startTimer(1000 / 60);
+    idleTimer->startTimer(1000 / idleHzActive);
 }
 
 SurgeSynthEditor::~SurgeSynthEditor()
@@ -256,7 +256,28 @@ void SurgeSynthEditor::paint(juce::Graphics &g)
     g.fillAll(findColour(SurgeJUCELookAndFeel::SurgeColourIds::tempoBackgroundId));
 }
 
-void SurgeSynthEditor::idle() { sge->idle(); }
+void SurgeSynthEditor::idle()
+{
+    sge->idle();
+
+    // tick less often while hidden, or while nothing is moving and the user isn't in here,
+    // so idle instances stay cheap
+    auto hz = idleHzActive;
+
+    if (!isShowing())
+    {
+        hz = idleHzHidden;
+    }
+    else if (sge->isIdleQuiet() && !isMouseOverOrDragging(true))
+    {
+        hz = idleHzQuiet;
+    }
+
+    if (idleTimer->getTimerInterval() != 1000 / hz)
+    {
+        idleTimer->startTimer(1000 / hz);
+    }
+}
 
 void SurgeSynthEditor::reapplySurgeComponentColours()
 {
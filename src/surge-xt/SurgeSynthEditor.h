@@ -88,6 +88,7 @@ class SurgeSynthEditor : public juce::AudioProcessorEditor,
     };
     void idle();
     std::unique_ptr<IdleTimer> idleTimer;
+    static constexpr int idleHzActive{60}, idleHzQuiet{20}, idleHzHidden{5};
 
     bool drawExtendedControls{false};
     int midiKeyboardOctave{5};
@@ -153,16 +153,25 @@ SurgeSynthProcessor::SurgeSynthProcessor()
         }
     }
 #endif
+
+    surge->setProcessFXInParallel(Surge::Storage::getUserDefaultValue(
+        &(surge->storage), Surge::Storage::ParallelFXChains, false));
+
+    startTimer(housekeepingIntervalMs);
 }
 
 SurgeSynthProcessor::~SurgeSynthProcessor()
 {
+    stopTimer();
+
 #if SURGE_HAS_OSC
     if (oscListener.listening)
         oscListener.stopListening();
 #endif
 }
 
+void SurgeSynthProcessor::timerCallback() { surge->runHousekeeping(); }
+
 //==============================================================================
 const juce::String SurgeSynthProcessor::getName() const { return JucePlugin_Name; }
 
@@ -345,10 +354,11 @@ void SurgeSynthProcessor::processBlock(juce::AudioBuffer<float> &buffer,
     }
 
     surge->audio_processing_active = true;
+    surge->workerPriority = isNonRealtime() ? RealtimeWorkerPool::priority_background
+                                            : RealtimeWorkerPool::priority_normal;
 
     processBlockPlayhead();
     processBlockMidiFromGUI();
-    processBlockOSC();
     auto mainOutput = getBusBuffer(buffer, false, 0);
     auto mainInput = getBusBuffer(buffer, true, 0);
     auto sceneAOutput = getBusBuffer(buffer, false, 1);
@@ -387,93 +397,112 @@ void SurgeSynthProcessor::processBlock(juce::AudioBuffer<float> &buffer,
         inputIsLatent = true;
     }
 
-    for (int i = 0; i < buffer.getNumSamples(); i++)
+    auto outL = mainOutput.getWritePointer(0);
+    auto outR = mainOutput.getWritePointer(1);
+
+    float *sAL{nullptr}, *sAR{nullptr}, *sBL{nullptr}, *sBR{nullptr};
+
+    if (surge->activateExtraOutputs)
     {
-        while (i == nextMidi)
+        if (sceneAOutput.getNumChannels() == 2)
         {
-            applyMidi(*midiIt);
-            midiIt++;
+            sAL = sceneAOutput.getWritePointer(0);
+            sAR = sceneAOutput.getWritePointer(1);
+        }
 
-            if (midiIt == midiMessages.cend())
-            {
-                nextMidi = -1;
-            }
-            else
-            {
-                nextMidi = (*midiIt).samplePosition;
-            }
+        if (sceneBOutput.getNumChannels() == 2)
+        {
+            sBL = sceneBOutput.getWritePointer(0);
+            sBR = sceneBOutput.getWritePointer(1);
         }
+    }
 
-        auto outL = mainOutput.getWritePointer(0, i);
-        auto outR = mainOutput.getWritePointer(1, i);
+    // Work in runs which end at either an engine block boundary or the end of the host buffer
+    int i = 0;
 
-        if (blockPos == 0 && incL && incR)
+    while (i < sc)
+    {
+        if (blockPos == 0)
         {
-            surge->process_input = true;
+            /*
+             * Note ons landing in the block we are about to render start in it, at their
+             * offset. Anything else can only act on a whole block, so it (and everything
+             * after it, to keep the order) waits for the next block rather than land early.
+             */
+            while (nextMidi >= 0 && nextMidi < i + BLOCK_SIZE)
+            {
+                auto offset = std::max(nextMidi - i, 0);
+                if (offset > 0 && !(*midiIt).getMessage().isNoteOn())
+                    break;
+
+                surge->setEventSampleOffset(offset);
+                applyMidi(*midiIt);
+                midiIt++;
+
+                if (midiIt == midiMessages.cend())
+                {
+                    nextMidi = -1;
+                }
+                else
+                {
+                    nextMidi = (*midiIt).samplePosition;
+                }
+            }
+            surge->setEventSampleOffset(0);
 
-            if (inputIsLatent)
+            if (incL && incR)
             {
-                memcpy(&(surge->input[0][0]), inputLatentBuffer[0], BLOCK_SIZE * sizeof(float));
-                memcpy(&(surge->input[1][0]), inputLatentBuffer[1], BLOCK_SIZE * sizeof(float));
+                surge->process_input = true;
+
+                if (inputIsLatent)
+                {
+                    memcpy(&(surge->input[0][0]), inputLatentBuffer[0],
+                           BLOCK_SIZE * sizeof(float));
+                    memcpy(&(surge->input[1][0]), inputLatentBuffer[1],
+                           BLOCK_SIZE * sizeof(float));
+                }
+                else
+                {
+                    memcpy(&(surge->input[0][0]), incL + i, BLOCK_SIZE * sizeof(float));
+                    memcpy(&(surge->input[1][0]), incR + i, BLOCK_SIZE * sizeof(float));
+                }
             }
             else
             {
-                auto inL = incL + i;
-                auto inR = incR + i;
-
-                memcpy(&(surge->input[0][0]), inL, BLOCK_SIZE * sizeof(float));
-                memcpy(&(surge->input[1][0]), inR, BLOCK_SIZE * sizeof(float));
+                surge->process_input = false;
             }
-        }
-        else
-        {
-            surge->process_input = false;
-        }
 
-        if (blockPos == 0)
-        {
             surge->process();
             surge->time_data.ppqPos +=
                 (double)BLOCK_SIZE * surge->time_data.tempo / (60. * surge->storage.samplerate);
         }
 
+        auto n = std::min(BLOCK_SIZE - blockPos, sc - i);
+        auto nb = n * sizeof(float);
+
         if (inputIsLatent && incL && incR)
         {
-            inputLatentBuffer[0][blockPos] = incL[i];
-            inputLatentBuffer[1][blockPos] = incR[i];
+            memcpy(&inputLatentBuffer[0][blockPos], incL + i, nb);
+            memcpy(&inputLatentBuffer[1][blockPos], incR + i, nb);
         }
 
-        *outL = surge->output[0][blockPos];
-        *outR = surge->output[1][blockPos];
+        memcpy(outL + i, &surge->output[0][blockPos], nb);
+        memcpy(outR + i, &surge->output[1][blockPos], nb);
 
-        if (surge->activateExtraOutputs)
+        if (sAL && sAR)
         {
-            if (sceneAOutput.getNumChannels() == 2)
-            {
-                auto sAL = sceneAOutput.getWritePointer(0, i);
-                auto sAR = sceneAOutput.getWritePointer(1, i);
-
-                if (sAL && sAR)
-                {
-                    *sAL = surge->sceneout[0][0][blockPos];
-                    *sAR = surge->sceneout[0][1][blockPos];
-                }
-            }
-
-            if (sceneBOutput.getNumChannels() == 2)
-            {
-                auto sBL = sceneBOutput.getWritePointer(0, i);
-                auto sBR = sceneBOutput.getWritePointer(1, i);
+            memcpy(sAL + i, &surge->sceneout[0][0][blockPos], nb);
+            memcpy(sAR + i, &surge->sceneout[0][1][blockPos], nb);
+        }
 
-                if (sBL && sBR)
-                {
-                    *sBL = surge->sceneout[1][0][blockPos];
-                    *sBR = surge->sceneout[1][1][blockPos];
-                }
-            }
+        if (sBL && sBR)
+        {
+            memcpy(sBL + i, &surge->sceneout[1][0][blockPos], nb);
+            memcpy(sBR + i, &surge->sceneout[1][1][blockPos], nb);
         }
 
-        blockPos = (blockPos + 1) & (BLOCK_SIZE - 1);
+        i += n;
+        blockPos = (blockPos + n) & (BLOCK_SIZE - 1);
     }
 
     // This should, in theory, never happen, but better safe than sorry
@@ -543,22 +572,6 @@ void SurgeSynthProcessor::processBlockMidiFromGUI()
     }
 }
 
-void SurgeSynthProcessor::processBlockOSC()
-{
-    auto messages = oscRingBuf.popall();
-    for (const auto &om : messages)
-    {
-        float pval = om.val;
-        if (om.type == oscMsg::PARAMETER)
-        {
-            if (om.param->valtype == vt_int)
-                pval = Parameter::intScaledToFloat(pval, om.param->val_max.i, om.param->val_min.i);
-            surge->setParameter01(surge->idForParameter(om.param), pval, true);
-            surge->storage.getPatch().isDirty = true;
-        }
-    }
-}
-
 void SurgeSynthProcessor::processBlockPostFunction()
 {
     if (checkNamesEvery++ > 10)
@@ -580,6 +593,23 @@ void SurgeSynthProcessor::processBlockPostFunction()
 }
 
 #if HAS_CLAP_JUCE_EXTENSIONS
+static bool clapEventStartsANote(const clap_event_header_t *evt)
+{
+    if (evt->space_id != CLAP_CORE_EVENT_SPACE_ID)
+        return false;
+
+    if (evt->type == CLAP_EVENT_NOTE_ON)
+        return true;
+
+    if (evt->type == CLAP_EVENT_MIDI)
+    {
+        auto mevt = reinterpret_cast<const clap_event_midi *>(evt);
+        return (mevt->data[0] & 0xF0) == 0x90 && mevt->data[2] > 0;
+    }
+
+    return false;
+}
+
 clap_process_status SurgeSynthProcessor::clap_direct_process(const clap_process *process) noexcept
 {
     auto fpuguard = sst::plugininfra::cpufeatures::FPUStateGuard();
@@ -596,6 +626,8 @@ clap_process_status SurgeSynthProcessor::clap_direct_process(const clap_process
         surge->allNotesOff();
     }
     surge->audio_processing_active = true;
+    surge->workerPriority = isNonRealtime() ? RealtimeWorkerPool::priority_background
+                                            : RealtimeWorkerPool::priority_normal;
 
     processBlockPlayhead();
     processBlockMidiFromGUI();
@@ -647,10 +679,15 @@ clap_process_status SurgeSynthProcessor::clap_direct_process(const clap_process
     {
         if (blockPos == 0)
         {
+            // as in processBlock, only note ons start part way into the block
             while (nextevtime >= 0 && nextevtime < s + BLOCK_SIZE && currev < evtsz)
             {
                 auto evt = ev->get(ev, currev);
+                auto offset = std::max(nextevtime - s, 0);
+                if (offset > 0 && !clapEventStartsANote(evt))
+                    break;
 
+                surge->setEventSampleOffset(offset);
                 process_clap_event(evt);
 
                 currev++;
@@ -663,6 +700,7 @@ clap_process_status SurgeSynthProcessor::clap_direct_process(const clap_process
                     nextevtime = -1;
                 }
             }
+            surge->setEventSampleOffset(0);
         }
 
         if (blockPos == 0)
@@ -964,8 +1002,11 @@ void SurgeSynthProcessor::getStateInformation(juce::MemoryBlock &destData)
         sse->populateForStreaming(surge.get());
     }
 
+    auto binaryState = Surge::Storage::getUserDefaultValue(
+        &(surge->storage), Surge::Storage::BinaryDAWState, false);
+
     void *data = nullptr; // surgeInstance owns this on return
-    unsigned int stateSize = surge->saveRaw(&data);
+    unsigned int stateSize = surge->saveRaw(&data, binaryState);
     destData.setSize(stateSize);
     destData.copyFrom(data, 0, stateSize);
 }
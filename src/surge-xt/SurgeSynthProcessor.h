@@ -277,7 +277,8 @@ class SurgeSynthProcessor : public juce::AudioProcessor,
 #endif
 
                             public SurgeSynthesizer::PluginLayer,
-                            public juce::MidiKeyboardState::Listener
+                            public juce::MidiKeyboardState::Listener,
+                            public juce::Timer
 
 {
   public:
@@ -298,7 +299,6 @@ class SurgeSynthProcessor : public juce::AudioProcessor,
 
     void processBlockPlayhead();
     void processBlockMidiFromGUI();
-    void processBlockOSC();
     void processBlockPostFunction();
 
     void applyMidi(const juce::MidiMessageMetadata &);
@@ -333,24 +333,8 @@ class SurgeSynthProcessor : public juce::AudioProcessor,
                        float velocity) override;
 
     //==============================================================================
-    // Open Sound Control
-    struct oscMsg
-    {
-        enum Type
-        {
-            PARAMETER,
-            SET_TUNING
-        } type{PARAMETER};
-        Parameter *param;
-        float val{0.0};
-        std::string str;
-
-        oscMsg() {}
-        oscMsg(Parameter *p, float v) : type(PARAMETER), param(p), val(v) {}
-    };
-
-    sst::cpputils::SimpleRingBuffer<oscMsg, 4096> oscRingBuf;
-
+    // Open Sound Control; parameter changes reach the audio thread through
+    // SurgeSynthesizer::enqueueParameterChange
     Surge::OSC::OSCListener oscListener;
 
     //==============================================================================
@@ -386,6 +370,10 @@ class SurgeSynthProcessor : public juce::AudioProcessor,
     juce::MidiKeyboardState midiKeyboardState;
     void reset() override;
 
+    // runs SurgeSynthesizer::runHousekeeping on the message thread, editor open or not
+    static constexpr int housekeepingIntervalMs{100};
+    void timerCallback() override;
+
     bool getPluginHasMainInput() const override { return false; }
 
     bool initOSC(int port);
@@ -324,7 +324,7 @@ SurgeGUIEditor::SurgeGUIEditor(SurgeSynthEditor *jEd, SurgeSynthesizer *synth)
     blinktimer = 0.f;
     blinkstate = false;
     midiLearnOverlay = nullptr;
-    patchCountdown = -1;
+    awaitingPatchLoad = false;
 
     mod_editor = false;
     editor_open = false;
@@ -581,6 +581,18 @@ void SurgeGUIEditor::idle()
 
     if (editor_open && frame && !synth->halt_engine)
     {
+        // everything the engine flagged since the last tick; sections below skip when clear
+        auto dirty = synth->takeGUIDirty();
+
+        if (dirty)
+        {
+            idleQuietTicks = 0;
+        }
+        else if (idleQuietTicks < idleQuietAfterTicks)
+        {
+            idleQuietTicks++;
+        }
+
         if (lastObservedMidiNoteEventCount != synth->midiNoteEvents)
         {
             lastObservedMidiNoteEventCount = synth->midiNoteEvents;
@@ -637,14 +649,13 @@ void SurgeGUIEditor::idle()
             hideMidiLearnOverlay();
         }
 
-        if (lfoDisplayRepaintCountdown > 0)
-        {
-            lfoDisplayRepaintCountdown--;
+        // the millisecond counter wraps, so compare the difference rather than the times
+        auto now = juce::Time::getMillisecondCounter();
 
-            if (lfoDisplayRepaintCountdown == 0)
-            {
-                forceLFODisplayRebuild();
-            }
+        if (lfoDisplayRepaintPending && (int32_t)(now - lfoDisplayRepaintAt) >= 0)
+        {
+            lfoDisplayRepaintPending = false;
+            forceLFODisplayRebuild();
         }
 
         if (undoButton && redoButton)
@@ -679,16 +690,21 @@ void SurgeGUIEditor::idle()
             }
         }
 
-        if (patchCountdown >= 0 && !pause_idle_updates)
+        if (awaitingPatchLoad && pause_idle_updates)
         {
-            patchCountdown--;
+            // the wait doesn't run while idle updates are paused
+            patchLoadDeadline = now + patchLoadTimeoutMs;
+        }
+        else if (awaitingPatchLoad && (int32_t)(now - patchLoadDeadline) >= 0)
+        {
+            awaitingPatchLoad = false;
 
-            if (patchCountdown < 0 && synth->patchid_queue >= 0)
+            if (synth->patchid_queue >= 0)
             {
                 std::ostringstream oss;
 
-                oss << "Loading patch " << synth->patchid_queue
-                    << " has not occurred after 200 idle cycles. This means that the audio system"
+                oss << "Loading patch " << synth->patchid_queue << " has not occurred after "
+                    << patchLoadTimeoutMs / 1000 << " seconds. This means that the audio system"
                     << " is delayed while loading many patches in a row. The audio system has to be"
                     << " running in order to load Surge XT patches. If the audio system is working,"
                        " you can probably ignore this message and continue once Surge XT catches "
@@ -752,7 +768,7 @@ void SurgeGUIEditor::idle()
             }
         }
 
-        if (polydisp)
+        if (polydisp && (dirty & SurgeSynthesizer::gui_dirty_voices))
         {
             int prior = polydisp->getPlayingVoiceCount();
 
@@ -831,6 +847,7 @@ void SurgeGUIEditor::idle()
 
         if (queue_refresh || synth->refresh_editor || patchChanged)
         {
+            idleQuietTicks = 0;
             queue_refresh = false;
             synth->refresh_editor = false;
 
@@ -869,8 +886,9 @@ void SurgeGUIEditor::idle()
         }
 
         bool vuInvalid = false;
+        bool metersDirty = dirty & SurgeSynthesizer::gui_dirty_meters;
 
-        if (vu[0])
+        if (vu[0] && metersDirty)
         {
             if (synth->vu_peak[0] != vu[0]->getValue())
             {
@@ -884,8 +902,6 @@ void SurgeGUIEditor::idle()
                 vuInvalid = true;
             }
 
-            vu[0]->setIsAudioActive(synth->audio_processing_active);
-
             if (synth->cpu_level != vu[0]->getCpuLevel())
             {
                 vu[0]->setCpuLevel(synth->cpu_level);
@@ -898,19 +914,30 @@ void SurgeGUIEditor::idle()
             }
         }
 
-        for (int i = 0; i < n_fx_slots; i++)
+        if (vu[0])
+        {
+            vu[0]->setIsAudioActive(synth->audio_processing_active);
+        }
+
+        for (int i = 0; i < n_fx_slots && metersDirty; i++)
         {
             assert(i + 1 < Effect::KNumVuSlots);
 
             if (vu[i + 1] && synth->fx[current_fx])
             {
-                vu[i + 1]->setValue(synth->fx[current_fx]->vu[(i << 1)]);
-                vu[i + 1]->setValueR(synth->fx[current_fx]->vu[(i << 1) + 1]);
-                vu[i + 1]->repaint();
+                auto vl = synth->fx[current_fx]->vu[(i << 1)];
+                auto vr = synth->fx[current_fx]->vu[(i << 1) + 1];
+
+                if (vl != vu[i + 1]->getValue() || vr != vu[i + 1]->getValueR())
+                {
+                    vu[i + 1]->setValue(vl);
+                    vu[i + 1]->setValueR(vr);
+                    vu[i + 1]->repaint();
+                }
             }
         }
 
-        for (int i = 0; i < 8; i++)
+        for (int i = 0; i < 8 && (dirty & SurgeSynthesizer::gui_dirty_params); i++)
         {
             if (synth->refresh_ctrl_queue[i] >= 0)
             {
@@ -981,28 +1008,31 @@ void SurgeGUIEditor::idle()
 
         std::vector<int> refreshIndices;
 
-        if (synth->refresh_overflow)
-        {
-            refreshIndices.resize(n_total_params);
-            std::iota(std::begin(refreshIndices), std::end(refreshIndices), 0);
-            frame->repaint();
-        }
-        else
+        if (dirty & SurgeSynthesizer::gui_dirty_params)
         {
-            for (int i = 0; i < 8; ++i)
+            if (synth->refresh_overflow)
+            {
+                refreshIndices.resize(n_total_params);
+                std::iota(std::begin(refreshIndices), std::end(refreshIndices), 0);
+                frame->repaint();
+            }
+            else
             {
-                if (synth->refresh_parameter_queue[i] >= 0)
+                for (int i = 0; i < 8; ++i)
                 {
-                    refreshIndices.push_back(synth->refresh_parameter_queue[i]);
+                    if (synth->refresh_parameter_queue[i] >= 0)
+                    {
+                        refreshIndices.push_back(synth->refresh_parameter_queue[i]);
+                    }
                 }
             }
-        }
 
-        synth->refresh_overflow = false;
+            synth->refresh_overflow = false;
 
-        for (int i = 0; i < 8; ++i)
-        {
-            synth->refresh_parameter_queue[i] = -1;
+            for (int i = 0; i < 8; ++i)
+            {
+                synth->refresh_parameter_queue[i] = -1;
+            }
         }
 
         for (auto j : refreshIndices)
@@ -1194,6 +1224,7 @@ void SurgeGUIEditor::idle()
 
     if (scope)
     {
+        idleQuietTicks = 0;
         scope->updateDrawing();
     }
 
@@ -4215,6 +4246,20 @@ juce::PopupMenu SurgeGUIEditor::makeWorkflowMenu(const juce::Point<int> &where)
 
     makeScopeEntry(wfMenu);
 
+    wfMenu.addSeparator();
+
+    bool parallelFX = Surge::Storage::getUserDefaultValue(&(this->synth->storage),
+                                                          Surge::Storage::ParallelFXChains, false);
+
+    // this starts threads the first time round, so it stays opt in
+    wfMenu.addItem(Surge::GUI::toOSCase("Process FX Chains on Multiple Cores"), true, parallelFX,
+                   [this, parallelFX]() {
+                       Surge::Storage::updateUserDefaultValue(&(this->synth->storage),
+                                                              Surge::Storage::ParallelFXChains,
+                                                              !parallelFX);
+                       synth->setProcessFXInParallel(!parallelFX);
+                   });
+
     return wfMenu;
 }
 
@@ -4609,6 +4654,19 @@ juce::PopupMenu SurgeGUIEditor::makeDataMenu(const juce::Point<int> &where)
         this->synth->refresh_editor = true;
     });
 
+    dataSubMenu.addSeparator();
+
+    bool binaryState = Surge::Storage::getUserDefaultValue(&(this->synth->storage),
+                                                           Surge::Storage::BinaryDAWState, false);
+
+    // older versions of Surge can't read these, so it stays opt in
+    dataSubMenu.addItem(Surge::GUI::toOSCase("Save DAW State in Compact Binary Form"), true,
+                        binaryState, [this, binaryState]() {
+                            Surge::Storage::updateUserDefaultValue(&(this->synth->storage),
+                                                                   Surge::Storage::BinaryDAWState,
+                                                                   !binaryState);
+                        });
+
     return dataSubMenu;
 }
 
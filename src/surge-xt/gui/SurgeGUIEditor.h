@@ -136,6 +136,12 @@ class SurgeGUIEditor : public Surge::GUI::IComponentTagValue::Listener,
 
     void idle();
     int slowIdleCounter{0};
+
+    // idle ticks in a row where the engine flagged nothing; the host timer slows down once
+    // this saturates and snaps back as soon as anything changes
+    static constexpr int idleQuietAfterTicks{30};
+    int idleQuietTicks{0};
+    bool isIdleQuiet() const { return idleQuietTicks >= idleQuietAfterTicks; }
     bool queue_refresh;
     virtual void toggle_mod_editing();
 
@@ -158,7 +164,8 @@ class SurgeGUIEditor : public Surge::GUI::IComponentTagValue::Listener,
             synth->patchid_queue = t;
             // Looks scary but remember this only runs if audio thread is off
             synth->processAudioThreadOpsWhenAudioEngineUnavailable();
-            patchCountdown = 200;
+            awaitingPatchLoad = true;
+            patchLoadDeadline = juce::Time::getMillisecondCounter() + patchLoadTimeoutMs;
         }
     }
 
@@ -290,7 +297,10 @@ class SurgeGUIEditor : public Surge::GUI::IComponentTagValue::Listener,
     float zoomFactor = 100;
     float initialZoomFactor = 100;
 
-    int patchCountdown = -1;
+    // Deadlines rather than idle tick counts, since the idle timer slows down when quiet
+    static constexpr uint32_t patchLoadTimeoutMs{4000};
+    bool awaitingPatchLoad{false};
+    uint32_t patchLoadDeadline{0};
 
   public:
     void populateDawExtraState(SurgeSynthesizer *synth);
@@ -772,7 +782,9 @@ class SurgeGUIEditor : public Surge::GUI::IComponentTagValue::Listener,
     Surge::GUI::IComponentTagValue *nonmod_param[n_paramslots] = {};
     std::array<std::unique_ptr<Surge::Widgets::ModulationSourceButton>, n_modsources> gui_modsrc;
     std::unique_ptr<Surge::Widgets::LFOAndStepDisplay> lfoDisplay;
-    int lfoDisplayRepaintCountdown{0};
+    static constexpr uint32_t lfoDisplayRepaintDelayMs{30};
+    bool lfoDisplayRepaintPending{false};
+    uint32_t lfoDisplayRepaintAt{0};
 
     Surge::Widgets::Switch *filtersubtype[2] = {};
 
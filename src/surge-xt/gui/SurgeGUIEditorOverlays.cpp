@@ -205,9 +205,11 @@ std::unique_ptr<Surge::Overlays::OverlayComponent> SurgeGUIEditor::createOverlay
             bitmapStore, this);
 
         mse->onModelChanged = [this]() {
-            if (lfoDisplayRepaintCountdown == 0)
+            if (!lfoDisplayRepaintPending)
             {
-                lfoDisplayRepaintCountdown = 2;
+                lfoDisplayRepaintPending = true;
+                lfoDisplayRepaintAt =
+                    juce::Time::getMillisecondCounter() + lfoDisplayRepaintDelayMs;
             }
         };
 
@@ -23,9 +23,11 @@
 #include "UndoManager.h"
 #include "SurgeGUIEditor.h"
 #include "SurgeSynthesizer.h"
+#include "BinaryDelta.h"
 #include <stack>
 #include <chrono>
 #include <variant>
+#include <unordered_map>
 #include <fmt/core.h>
 #include "widgets/MainFrame.h" // so i can repaint without rebuild
 
@@ -40,17 +42,6 @@ struct UndoManagerImpl
     SurgeGUIEditor *editor;
     SurgeSynthesizer *synth;
     UndoManagerImpl(SurgeGUIEditor *ed, SurgeSynthesizer *s) : editor(ed), synth(s) {}
-    ~UndoManagerImpl()
-    {
-        for (auto &r : undoStack)
-        {
-            freeAction(r.action);
-        }
-        for (auto &r : redoStack)
-        {
-            freeAction(r.action);
-        }
-    }
     bool doPush{true};
     struct SelfPushGuard
     {
@@ -110,7 +101,7 @@ struct UndoManagerImpl
         int scene;
 
         int current_id;
-        // Why shared? Well this is only used in one edge case and it makes it easier
+        // Shared with every other record holding the same wavetable, see sharedWavetable
         std::shared_ptr<Wavetable> wt;
 
         std::string displayName;
@@ -171,8 +162,13 @@ struct UndoManagerImpl
     };
     struct UndoPatch
     {
-        void *data{nullptr};
-        size_t dataSz{0};
+        /*
+         * The patch chunk is base with delta applied, or base itself if delta is empty.
+         * Records share a base until the patch has drifted far enough from it that a fresh one
+         * is cheaper, so each patch record mostly only costs the size of what changed.
+         */
+        std::shared_ptr<const std::vector<char>> base;
+        std::vector<char> delta;
         fs::path path{};
     };
 
@@ -194,6 +190,15 @@ struct UndoManagerImpl
     std::deque<UndoRecord> undoStack, redoStack;
     size_t undoStackMem{0}, redoStackMem{0};
 
+    /*
+     * Patch bases and pooled wavetables are shared between records, so they are counted
+     * against a stack once, for as long as any record on it holds them, whichever record made
+     * them. Each maps to its size and how many records on the stack hold it.
+     */
+    typedef std::unordered_map<const void *, std::pair<size_t, int>> SharedUse;
+    SharedUse undoShared, redoShared;
+
+    // The memory a record holds on its own, without what it shares
     size_t actionSize(const UndoAction &a)
     {
         auto res = sizeof(a);
@@ -204,20 +209,57 @@ struct UndoManagerImpl
         }
         if (auto pt = std::get_if<UndoPatch>(&a))
         {
-            res += pt->dataSz;
+            res += pt->delta.size();
         }
         return res;
     }
 
-    void freeAction(UndoAction &a)
+    template <typename F> void forEachShared(const UndoAction &a, F f)
     {
         if (auto pt = std::get_if<UndoPatch>(&a))
         {
-            free(pt->data);
-            pt->dataSz = 0;
+            if (pt->base)
+                f(pt->base.get(), pt->base->size());
+        }
+        if (auto pt = std::get_if<UndoWavetable>(&a))
+        {
+            if (pt->wt)
+                f(pt->wt.get(), pt->wt->dataSizes * (sizeof(float) + sizeof(short)));
         }
     }
 
+    // What putting a record on a stack adds to its memory
+    size_t memoryAdded(const UndoAction &a, SharedUse &shared)
+    {
+        auto res = actionSize(a);
+
+        forEachShared(a, [&](const void *p, size_t sz) {
+            auto &use = shared[p];
+            if (use.second++ == 0)
+            {
+                use.first = sz;
+                res += sz;
+            }
+        });
+        return res;
+    }
+
+    // And what taking it off frees
+    size_t memoryRemoved(const UndoAction &a, SharedUse &shared)
+    {
+        auto res = actionSize(a);
+
+        forEachShared(a, [&](const void *p, size_t) {
+            auto it = shared.find(p);
+            if (it != shared.end() && --it->second.second == 0)
+            {
+                res += it->second.first;
+                shared.erase(it);
+            }
+        });
+        return res;
+    }
+
     /* Not same value, but same pair. Used for wheel event compressing for instance */
     bool aboutTheSameThing(const UndoAction &a, const UndoAction &b)
     {
@@ -352,7 +394,7 @@ struct UndoManagerImpl
         if (undoStack.empty())
         {
             undoStack.emplace_back(r);
-            undoStackMem += actionSize(r);
+            undoStackMem += memoryAdded(r, undoShared);
             if (clearRedoOnUndo)
             {
                 clearRedo();
@@ -364,7 +406,7 @@ struct UndoManagerImpl
         if (r.index() != t.action.index())
         {
             undoStack.emplace_back(r);
-            undoStackMem += actionSize(r);
+            undoStackMem += memoryAdded(r, undoShared);
             if (clearRedoOnUndo)
             {
                 clearRedo();
@@ -382,7 +424,7 @@ struct UndoManagerImpl
             else
             {
                 undoStack.emplace_back(r);
-                undoStackMem += actionSize(r);
+                undoStackMem += memoryAdded(r, undoShared);
                 if (clearRedoOnUndo)
                 {
                     clearRedo();
@@ -393,12 +435,9 @@ struct UndoManagerImpl
 
     void clearRedo()
     {
-        for (auto &r : redoStack)
-        {
-            freeAction(r.action);
-        }
         redoStack.clear();
         redoStackMem = 0;
+        redoShared.clear();
     }
 
     void pushRedo(const UndoAction &r)
@@ -407,7 +446,7 @@ struct UndoManagerImpl
             return;
         auto g = CleanupGuard(this);
         redoStack.emplace_back(r);
-        redoStackMem += actionSize(r);
+        redoStackMem += memoryAdded(r, redoShared);
     }
 
     void doCleanup()
@@ -415,17 +454,21 @@ struct UndoManagerImpl
         while (undoStackMem > maxUndoStackMem)
         {
             auto r = undoStack.front();
-            freeAction(r.action);
-            undoStackMem -= actionSize(r.action);
+            undoStackMem -= memoryRemoved(r.action, undoShared);
             undoStack.pop_front();
         }
         while (redoStackMem > maxRedoStackMem)
         {
             auto r = redoStack.front();
-            freeAction(r.action);
-            redoStackMem -= actionSize(r.action);
+            redoStackMem -= memoryRemoved(r.action, redoShared);
             redoStack.pop_front();
         }
+
+        // don't hold on to a patch base no record needs anymore
+        if (patchBase && patchBase.use_count() == 1)
+        {
+            patchBase.reset();
+        }
     }
 
     void populateUndoParamFromP(const Parameter *p, pdata val, UndoParam &r)
@@ -576,8 +619,7 @@ struct UndoManagerImpl
         r.wt = nullptr;
         if (r.current_id < 0)
         {
-            r.wt = std::make_shared<Wavetable>();
-            r.wt->Copy(&(os->wt));
+            r.wt = sharedWavetable(&(os->wt));
         }
 
         r.scene = scene;
@@ -744,11 +786,63 @@ struct UndoManagerImpl
             pushRedo(r);
     }
 
+    // Wavetables held by undo records, so that pushing the same one again shares the copy
+    std::vector<std::weak_ptr<Wavetable>> wavetablePool;
+
+    static bool sameWavetable(const Wavetable *a, const Wavetable *b)
+    {
+        return a->size == b->size && a->n_tables == b->n_tables && a->flags == b->flags &&
+               a->dataSizes == b->dataSizes &&
+               memcmp(a->TableI16Data, b->TableI16Data, a->dataSizes * sizeof(short)) == 0 &&
+               memcmp(a->TableF32Data, b->TableF32Data, a->dataSizes * sizeof(float)) == 0;
+    }
+
+    std::shared_ptr<Wavetable> sharedWavetable(Wavetable *wt)
+    {
+        wavetablePool.erase(std::remove_if(wavetablePool.begin(), wavetablePool.end(),
+                                           [](const auto &w) { return w.expired(); }),
+                            wavetablePool.end());
+
+        for (const auto &w : wavetablePool)
+        {
+            auto s = w.lock();
+            if (s && sameWavetable(s.get(), wt))
+            {
+                return s;
+            }
+        }
+
+        auto res = std::make_shared<Wavetable>();
+        res->Copy(wt);
+        wavetablePool.push_back(res);
+        return res;
+    }
+
+    // The most recent full patch chunk, which new patch records store their delta against
+    std::shared_ptr<const std::vector<char>> patchBase;
+
+    void storePatchChunk(UndoPatch &r, const char *data, size_t size)
+    {
+        if (patchBase)
+        {
+            auto d = Surge::Storage::BinaryDelta::diff(patchBase->data(), patchBase->size(),
+                                                       data, size);
+
+            if (d.size() < size / 4)
+            {
+                r.base = patchBase;
+                r.delta = std::move(d);
+                return;
+            }
+        }
+
+        patchBase = std::make_shared<const std::vector<char>>(data, data + size);
+        r.base = patchBase;
+    }
+
     void pushPatch(UndoManager::Target to = UndoManager::UNDO)
     {
         auto r = UndoPatch();
-        r.data = nullptr;
-        r.dataSz = 0;
         r.path = fs::path{};
         static int qq = 0;
         bool doStream = editor->getPatch().isDirty;
@@ -767,12 +861,11 @@ struct UndoManagerImpl
         if (doStream)
         {
             void *data{nullptr};
-            auto dsz = editor->getPatch().save_patch(&data);
-            // Now the pointer which is returned will be the patches 'patchptr'
-            // which on the lext load will get clobbered so we need to make a copy.
-            r.dataSz = dsz;
-            r.data = malloc(r.dataSz);
-            memcpy(r.data, data, r.dataSz);
+            // The binary chunk, since it is smaller and lines up better from one save to the
+            // next. The pointer returned is the patch's 'patchptr', which the next load will
+            // clobber, but storePatchChunk copies what it keeps.
+            auto dsz = editor->getPatch().save_patch(&data, true);
+            storePatchChunk(r, (const char *)data, dsz);
         }
 
         if (to == UndoManager::UNDO)
@@ -786,11 +879,13 @@ struct UndoManagerImpl
         auto dcroug = DontClearRedoOnUndoGuard(this);
         auto *currStack = &undoStack;
         auto *currStackMem = &undoStackMem;
+        auto *currShared = &undoShared;
 
         if (which == UndoManager::REDO)
         {
             currStack = &redoStack;
             currStackMem = &redoStackMem;
+            currShared = &redoShared;
         }
 
         if (currStack->empty())
@@ -798,7 +893,7 @@ struct UndoManagerImpl
 
         auto qt = currStack->back();
         auto q = qt.action;
-        *currStackMem -= actionSize(q);
+        *currStackMem -= memoryRemoved(q, *currShared);
         currStack->pop_back();
 
         auto opposite = (which == UndoManager::UNDO ? UndoManager::REDO : UndoManager::UNDO);
@@ -1054,13 +1149,22 @@ struct UndoManagerImpl
         {
             pushPatch(opposite);
             auto g = SelfPushGuard(this);
-            if (p->dataSz == 0)
+            if (!p->base)
             {
                 editor->queuePatchFileLoad(p->path.u8string());
             }
+            else if (p->delta.empty())
+            {
+                editor->setPatchFromUndo((void *)p->base->data(), p->base->size());
+            }
             else
             {
-                editor->setPatchFromUndo(p->data, p->dataSz);
+                std::vector<char> chunk;
+                if (Surge::Storage::BinaryDelta::apply(p->base->data(), p->base->size(), p->delta,
+                                                       chunk))
+                {
+                    editor->setPatchFromUndo(chunk.data(), chunk.size());
+                }
             }
 
             auto ann = fmt::format("{} Patch Change", verb);
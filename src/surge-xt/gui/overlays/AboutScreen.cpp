@@ -23,6 +23,7 @@
 #include "AboutScreen.h"
 #include "SurgeGUIEditor.h"
 #include "SurgeStorage.h"
+#include "SurgeMemoryPools.h"
 #include "version.h"
 #include "RuntimeFont.h"
 #include "SurgeImage.h"
@@ -199,6 +200,13 @@ void AboutScreen::populateData()
         lowerLeft.emplace_back("Sample Rate:", srString, "");
     }
 
+    if (storage->memoryPools)
+    {
+        auto poolString =
+            fmt::format("{:.1f} MB", storage->memoryPools->residentBytes() / (1024.0 * 1024.0));
+        lowerLeft.emplace_back("Voice Pools:", poolString, "");
+    }
+
     lowerLeft.emplace_back("", "", "");
 
     auto apppath = sst::plugininfra::paths::sharedLibraryBinaryPath();
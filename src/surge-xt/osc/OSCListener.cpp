@@ -129,7 +129,10 @@ void OSCListener::oscMessageReceived(const juce::OSCMessage &message)
             return;
         }
 
-        sspPtr->oscRingBuf.push(SurgeSynthProcessor::oscMsg(p, message[0].getFloat32()));
+        float pval = message[0].getFloat32();
+        if (p->valtype == vt_int)
+            pval = Parameter::intScaledToFloat(pval, p->val_max.i, p->val_min.i);
+        synth->enqueueParameterChange(synth->idForParameter(p), pval);
 
 #ifdef DEBUG_VERBOSE
         std::cout << "Parameter OSC name:" << p->get_osc_name() << "  ";